@@ -47,7 +47,9 @@ public class AnimBPTool : ModuleRules
 				"BlueprintGraph",
 				"GraphEditor",
 				"Kismet",
-				"EditorStyle"
+				"EditorStyle",
+				"AssetRegistry",
+				"MessageLog"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -0,0 +1,268 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "AnimBPCompileProfileView.h"
+
+#include "Misc/MessageDialog.h"
+#include "Misc/Paths.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Input/SCheckBox.h"
+#include "Widgets/Input/SSearchBox.h"
+#include "Widgets/Text/STextBlock.h"
+#include "Widgets/Views/STableRow.h"
+
+#define LOCTEXT_NAMESPACE "SAnimBPCompileProfileView"
+
+const FName SAnimBPCompileProfileView::NameColumn(TEXT("Name"));
+const FName SAnimBPCompileProfileView::GraphColumn(TEXT("Graph"));
+const FName SAnimBPCompileProfileView::KindColumn(TEXT("Kind"));
+const FName SAnimBPCompileProfileView::SourceNodesColumn(TEXT("SourceNodes"));
+const FName SAnimBPCompileProfileView::IntermediateNodesColumn(TEXT("IntermediateNodes"));
+const FName SAnimBPCompileProfileView::IntermediatePinsColumn(TEXT("IntermediatePins"));
+
+namespace
+{
+    class SAnimBPCompileProfileRow : public SMultiColumnTableRow<TSharedPtr<FAnimBPCompileProfileRow>>
+    {
+    public:
+        SLATE_BEGIN_ARGS(SAnimBPCompileProfileRow)
+            {
+            }
+
+            SLATE_ARGUMENT(TSharedPtr<FAnimBPCompileProfileRow>, Item)
+        SLATE_END_ARGS()
+
+        void Construct(const FArguments& Args, const TSharedRef<STableViewBase>& OwnerTable)
+        {
+            Item = Args._Item;
+            SMultiColumnTableRow<TSharedPtr<FAnimBPCompileProfileRow>>::Construct(
+                FSuperRowType::FArguments(), OwnerTable);
+        }
+
+        virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+        {
+            FText Text;
+            if (ColumnName == SAnimBPCompileProfileView::NameColumn)
+            {
+                Text = FText::FromString(Item->Name);
+            }
+            else if (ColumnName == SAnimBPCompileProfileView::GraphColumn)
+            {
+                Text = FText::FromString(Item->Graph);
+            }
+            else if (ColumnName == SAnimBPCompileProfileView::KindColumn)
+            {
+                Text = Item->bGraph ? LOCTEXT("Kind_Graph", "Graph") : LOCTEXT("Kind_Node", "Node");
+            }
+            else if (ColumnName == SAnimBPCompileProfileView::SourceNodesColumn)
+            {
+                Text = FText::AsNumber(Item->SourceNodes);
+            }
+            else if (ColumnName == SAnimBPCompileProfileView::IntermediateNodesColumn)
+            {
+                Text = FText::AsNumber(Item->IntermediateNodes);
+            }
+            else
+            {
+                Text = FText::AsNumber(Item->IntermediatePins);
+            }
+            return SNew(STextBlock)
+                .Text(Text)
+                .ColorAndOpacity(Item->bGraph ? FLinearColor(1.0f, 0.85f, 0.4f) : FLinearColor::White);
+        }
+
+    private:
+        TSharedPtr<FAnimBPCompileProfileRow> Item;
+    };
+}
+
+void SAnimBPCompileProfileView::Construct(const FArguments& Args)
+{
+    Profile = Args._Profile;
+    check(Profile.IsValid());
+
+    auto MakeColumn = [this](FName Column, FText Label, float FillWidth)
+    {
+        return SHeaderRow::Column(Column)
+               .DefaultLabel(Label)
+               .FillWidth(FillWidth)
+               .SortMode(this, &SAnimBPCompileProfileView::GetSortMode, Column)
+               .OnSort(this, &SAnimBPCompileProfileView::OnSortModeChanged);
+    };
+
+    ChildSlot
+    [
+        SNew(SVerticalBox)
+
+        + SVerticalBox::Slot()
+          .AutoHeight()
+          .Padding(0, 0, 0, 2)
+        [
+            SNew(STextBlock)
+             .Text(this, &SAnimBPCompileProfileView::GetSummaryText)
+        ]
+
+        + SVerticalBox::Slot()
+          .AutoHeight()
+          .Padding(0, 0, 0, 2)
+        [
+            SNew(SHorizontalBox)
+
+            + SHorizontalBox::Slot()
+              .FillWidth(1.0f)
+              .VAlign(VAlign_Center)
+            [
+                SNew(SSearchBox)
+                 .HintText(LOCTEXT("Filter_Hint", "Filter graphs and nodes"))
+                 .OnTextChanged(this, &SAnimBPCompileProfileView::OnFilterTextChanged)
+            ]
+
+            + SHorizontalBox::Slot()
+              .AutoWidth()
+              .VAlign(VAlign_Center)
+              .Padding(4, 0, 0, 0)
+            [
+                SNew(SCheckBox)
+                 .OnCheckStateChanged(this, &SAnimBPCompileProfileView::OnGraphsOnlyChanged)
+                [
+                    SNew(STextBlock).Text(LOCTEXT("Graphs_Only", "Graphs only"))
+                ]
+            ]
+
+            + SHorizontalBox::Slot()
+              .AutoWidth()
+              .VAlign(VAlign_Center)
+              .Padding(4, 0, 0, 0)
+            [
+                SNew(SButton)
+                 .Text(LOCTEXT("Export_Csv", "Export CSV"))
+                 .ToolTipText(LOCTEXT("Export_Csv_Tip", "Write the profile to Saved/AnimBPTool/Reports"))
+                 .OnClicked(this, &SAnimBPCompileProfileView::OnExportCsv)
+            ]
+        ]
+
+        + SVerticalBox::Slot()
+          .FillHeight(1.0f)
+        [
+            SAssignNew(ListView, SListView<TSharedPtr<FAnimBPCompileProfileRow>>)
+             .ListItemsSource(&FilteredRows)
+             .SelectionMode(ESelectionMode::Multi)
+             .OnGenerateRow(this, &SAnimBPCompileProfileView::OnGenerateRow)
+             .HeaderRow
+             (
+                 SNew(SHeaderRow)
+                 + MakeColumn(NameColumn, LOCTEXT("Name_Column", "Name"), 0.3f)
+                 + MakeColumn(GraphColumn, LOCTEXT("Graph_Column", "Graph"), 0.22f)
+                 + MakeColumn(KindColumn, LOCTEXT("Kind_Column", "Kind"), 0.08f)
+                 + MakeColumn(SourceNodesColumn, LOCTEXT("SourceNodes_Column", "Source Nodes"), 0.12f)
+                 + MakeColumn(IntermediateNodesColumn, LOCTEXT("IntermediateNodes_Column", "Expanded Nodes"), 0.14f)
+                 + MakeColumn(IntermediatePinsColumn, LOCTEXT("IntermediatePins_Column", "Expanded Pins"), 0.14f)
+             )
+        ]
+    ];
+
+    ApplyFilterAndSort();
+}
+
+void SAnimBPCompileProfileView::ApplyFilterAndSort()
+{
+    FilteredRows.Reset();
+    for (auto const& Row : Profile->Rows)
+    {
+        if ((!bGraphsOnly || Row->bGraph) &&
+            (FilterText.IsEmpty() || Row->Name.Contains(FilterText) || Row->Graph.Contains(FilterText)))
+        {
+            FilteredRows.Add(Row);
+        }
+    }
+
+    const bool bAscending = SortMode != EColumnSortMode::Descending;
+    const FName Column = SortColumn;
+    FilteredRows.Sort([bAscending, Column](TSharedPtr<FAnimBPCompileProfileRow> const& A,
+                                           TSharedPtr<FAnimBPCompileProfileRow> const& B)
+    {
+        int32 Compare;
+        if (Column == GraphColumn)
+        {
+            Compare = A->Graph.Compare(B->Graph, ESearchCase::IgnoreCase);
+        }
+        else if (Column == KindColumn)
+        {
+            Compare = static_cast<int32>(A->bGraph) - static_cast<int32>(B->bGraph);
+        }
+        else if (Column == SourceNodesColumn)
+        {
+            Compare = A->SourceNodes - B->SourceNodes;
+        }
+        else if (Column == IntermediateNodesColumn)
+        {
+            Compare = A->IntermediateNodes - B->IntermediateNodes;
+        }
+        else if (Column == IntermediatePinsColumn)
+        {
+            Compare = A->IntermediatePins - B->IntermediatePins;
+        }
+        else
+        {
+            Compare = 0;
+        }
+        if (Compare == 0)
+        {
+            Compare = A->Name.Compare(B->Name, ESearchCase::IgnoreCase);
+        }
+        return bAscending ? Compare < 0 : Compare > 0;
+    });
+    ListView->RequestListRefresh();
+}
+
+void SAnimBPCompileProfileView::OnFilterTextChanged(const FText& InFilterText)
+{
+    FilterText = InFilterText.ToString();
+    ApplyFilterAndSort();
+}
+
+void SAnimBPCompileProfileView::OnGraphsOnlyChanged(ECheckBoxState NewState)
+{
+    bGraphsOnly = NewState == ECheckBoxState::Checked;
+    ApplyFilterAndSort();
+}
+
+EColumnSortMode::Type SAnimBPCompileProfileView::GetSortMode(FName Column) const
+{
+    return Column == SortColumn ? SortMode : EColumnSortMode::None;
+}
+
+void SAnimBPCompileProfileView::OnSortModeChanged(EColumnSortPriority::Type Priority, const FName& Column,
+                                                  EColumnSortMode::Type NewMode)
+{
+    SortColumn = Column;
+    SortMode = NewMode;
+    ApplyFilterAndSort();
+}
+
+TSharedRef<ITableRow> SAnimBPCompileProfileView::OnGenerateRow(TSharedPtr<FAnimBPCompileProfileRow> Item,
+                                                               const TSharedRef<STableViewBase>& OwnerTable)
+{
+    return SNew(SAnimBPCompileProfileRow, OwnerTable).Item(Item);
+}
+
+FReply SAnimBPCompileProfileView::OnExportCsv()
+{
+    if (!FAnimBPCompileProfiler::WriteReport(FAnimBPCompileProfiler::GetDefaultReportDirectory(), *Profile))
+    {
+        FMessageDialog::Open(EAppMsgType::Ok, LOCTEXT("Export_Csv_Error", "Fail to write the compile profile"));
+    }
+    return FReply::Handled();
+}
+
+FText SAnimBPCompileProfileView::GetSummaryText() const
+{
+    return FText::Format(
+        LOCTEXT("Profile_Summary", "{0}: compiled in {1} ms{2}, {3} source nodes expanded to {4} nodes and {5} pins"),
+        FText::FromString(FPaths::GetBaseFilename(Profile->BlueprintPath)),
+        FText::AsNumber(FMath::RoundToInt(Profile->CompileSeconds * 1000.0)),
+        Profile->bCompileFailed ? LOCTEXT("Profile_Failed", " with errors") : FText::GetEmpty(),
+        FText::AsNumber(Profile->SourceNodes), FText::AsNumber(Profile->IntermediateNodes),
+        FText::AsNumber(Profile->IntermediatePins));
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,61 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimBPCompileProfiler.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SHeaderRow.h"
+#include "Widgets/Views/SListView.h"
+
+/*
+ * Sortable breakdown of one compile profile, graph rows and node rows side by side, heaviest expansion first.
+ */
+class SAnimBPCompileProfileView : public SCompoundWidget
+{
+public:
+    SLATE_BEGIN_ARGS(SAnimBPCompileProfileView)
+        {
+        }
+
+        SLATE_ARGUMENT(TSharedPtr<FAnimBPCompileProfile>, Profile)
+    SLATE_END_ARGS()
+
+    void Construct(const FArguments& Args);
+
+    static const FName NameColumn;
+    static const FName GraphColumn;
+    static const FName KindColumn;
+    static const FName SourceNodesColumn;
+    static const FName IntermediateNodesColumn;
+    static const FName IntermediatePinsColumn;
+
+private:
+    void ApplyFilterAndSort();
+
+    void OnFilterTextChanged(const FText& InFilterText);
+
+    void OnGraphsOnlyChanged(ECheckBoxState NewState);
+
+    EColumnSortMode::Type GetSortMode(FName Column) const;
+
+    void OnSortModeChanged(EColumnSortPriority::Type Priority, const FName& Column, EColumnSortMode::Type NewMode);
+
+    TSharedRef<ITableRow> OnGenerateRow(TSharedPtr<FAnimBPCompileProfileRow> Item,
+                                        const TSharedRef<STableViewBase>& OwnerTable);
+
+    FReply OnExportCsv();
+
+    FText GetSummaryText() const;
+
+private:
+    TSharedPtr<FAnimBPCompileProfile> Profile;
+
+    TArray<TSharedPtr<FAnimBPCompileProfileRow>> FilteredRows;
+    TSharedPtr<SListView<TSharedPtr<FAnimBPCompileProfileRow>>> ListView;
+
+    FString FilterText;
+    bool bGraphsOnly = false;
+    FName SortColumn = IntermediateNodesColumn;
+    EColumnSortMode::Type SortMode = EColumnSortMode::Descending;
+};
@@ -0,0 +1,150 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "AnimBPCompileProfiler.h"
+
+#include "EdGraph/EdGraph.h"
+#include "Engine/Blueprint.h"
+#include "Kismet2/CompilerResultsLog.h"
+#include "Kismet2/KismetEditorUtilities.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimBPCompileProfiler, Log, All);
+
+void FAnimBPCompileProfiler::Profile(UBlueprint* Blueprint, FAnimBPCompileProfile& OutProfile)
+{
+    OutProfile = FAnimBPCompileProfile();
+    if (!Blueprint)
+    {
+        return;
+    }
+    OutProfile.BlueprintPath = Blueprint->GetPathName();
+
+    FCompilerResultsLog Results;
+    Results.SetSourcePath(Blueprint->GetPathName());
+    Results.bLogDetailedResults = true;
+    Results.EventDisplayThresholdMs = 0;
+    Results.BeginEvent(TEXT("Compile"));
+    const double StartTime = FPlatformTime::Seconds();
+    FKismetEditorUtilities::CompileBlueprint(Blueprint, EBlueprintCompileOptions::SaveIntermediateProducts
+                                             | EBlueprintCompileOptions::SkipGarbageCollection, &Results);
+    OutProfile.CompileSeconds = FPlatformTime::Seconds() - StartTime;
+    Results.EndEvent();
+    OutProfile.bCompileFailed = Blueprint->Status == BS_Error;
+
+    // The event summary is logged as notes when the outermost event ends
+    for (auto const& Message : Results.Messages)
+    {
+        if (Message->GetSeverity() == EMessageSeverity::Info)
+        {
+            OutProfile.CompilerEvents.Add(Message->ToText().ToString());
+        }
+    }
+
+    TArray<UEdGraph*> Graphs;
+    Blueprint->GetAllGraphs(Graphs);
+    TMap<UEdGraph*, TSharedPtr<FAnimBPCompileProfileRow>> GraphRows;
+    for (auto Graph : Graphs)
+    {
+        auto Row = MakeShared<FAnimBPCompileProfileRow>();
+        Row->Name = Graph->GetName();
+        Row->Graph = Row->Name;
+        Row->bGraph = true;
+        Row->SourceNodes = Graph->Nodes.Num();
+        OutProfile.SourceNodes += Row->SourceNodes;
+        GraphRows.Add(Graph, Row);
+        OutProfile.Rows.Add(Row);
+    }
+
+    // Nodes the compiler made up itself, with no source node to blame
+    auto GeneratedRow = MakeShared<FAnimBPCompileProfileRow>();
+    GeneratedRow->Name = TEXT("(Generated)");
+    GeneratedRow->bGraph = true;
+
+    TMap<UEdGraphNode*, TSharedPtr<FAnimBPCompileProfileRow>> NodeRows;
+    for (auto IntermediateGraph : Blueprint->IntermediateGeneratedGraphs)
+    {
+        for (auto Node : IntermediateGraph->Nodes)
+        {
+            if (!Node)
+            {
+                continue;
+            }
+            ++OutProfile.IntermediateNodes;
+            OutProfile.IntermediatePins += Node->Pins.Num();
+
+            auto SourceNode = Cast<UEdGraphNode>(Results.FindSourceObject(Node));
+            auto GraphRow = SourceNode ? GraphRows.FindRef(SourceNode->GetGraph()) : nullptr;
+            if (!GraphRow)
+            {
+                ++GeneratedRow->IntermediateNodes;
+                GeneratedRow->IntermediatePins += Node->Pins.Num();
+                continue;
+            }
+            ++GraphRow->IntermediateNodes;
+            GraphRow->IntermediatePins += Node->Pins.Num();
+
+            auto& NodeRow = NodeRows.FindOrAdd(SourceNode);
+            if (!NodeRow)
+            {
+                NodeRow = MakeShared<FAnimBPCompileProfileRow>();
+                NodeRow->Name = SourceNode->GetNodeTitle(ENodeTitleType::ListView).ToString();
+                NodeRow->Graph = GraphRow->Name;
+                NodeRow->SourceNodes = 1;
+                OutProfile.Rows.Add(NodeRow);
+            }
+            ++NodeRow->IntermediateNodes;
+            NodeRow->IntermediatePins += Node->Pins.Num();
+        }
+    }
+    if (GeneratedRow->IntermediateNodes > 0)
+    {
+        OutProfile.Rows.Add(GeneratedRow);
+    }
+
+    // Only needed for the attribution above, don't leave them listed in the editor
+    Blueprint->IntermediateGeneratedGraphs.Empty();
+
+    UE_LOG(LogAnimBPCompileProfiler, Log,
+           TEXT("[%s] compiled in %.1f ms, %d source nodes -> %d intermediate nodes, %d pins"), *Blueprint->GetName(), OutProfile.CompileSeconds * 1000.0, OutProfile.SourceNodes,
+           OutProfile.IntermediateNodes, OutProfile.IntermediatePins);
+}
+
+bool FAnimBPCompileProfiler::WriteReport(const FString& Directory, FAnimBPCompileProfile const& Profile)
+{
+    const auto CsvPath = FPaths::ConvertRelativePathToFull(
+        Directory / FString::Printf(TEXT("CompileProfile_%s_%s.csv"), *FPaths::GetBaseFilename(Profile.BlueprintPath),
+                                    *FDateTime::Now().ToString()));
+
+    auto Sorted = Profile.Rows;
+    Sorted.Sort([](TSharedPtr<FAnimBPCompileProfileRow> const& A, TSharedPtr<FAnimBPCompileProfileRow> const& B)
+    {
+        return A->IntermediateNodes > B->IntermediateNodes;
+    });
+
+    FString CsvString = TEXT("Blueprint,Kind,Name,Graph,SourceNodes,IntermediateNodes,IntermediatePins,CompileMs")
+        LINE_TERMINATOR;
+    CsvString += FString::Printf(TEXT("\"%s\",Blueprint,,,%d,%d,%d,%.1f") LINE_TERMINATOR, *Profile.BlueprintPath,
+                                 Profile.SourceNodes, Profile.IntermediateNodes, Profile.IntermediatePins,
+                                 Profile.CompileSeconds * 1000.0);
+    for (auto const& Row : Sorted)
+    {
+        // Node titles may span lines or quote things
+        const FString Name = Row->Name.Replace(TEXT("\""), TEXT("'")).Replace(TEXT("\n"), TEXT(" "));
+        CsvString += FString::Printf(TEXT("\"%s\",%s,\"%s\",\"%s\",%d,%d,%d,") LINE_TERMINATOR,
+                                     *Profile.BlueprintPath, Row->bGraph ? TEXT("Graph") : TEXT("Node"), *Name,
+                                     *Row->Graph, Row->SourceNodes, Row->IntermediateNodes, Row->IntermediatePins);
+    }
+    if (!FFileHelper::SaveStringToFile(CsvString, *CsvPath))
+    {
+        UE_LOG(LogAnimBPCompileProfiler, Error, TEXT("Fail to write compile profile %s"), *CsvPath);
+        return false;
+    }
+    UE_LOG(LogAnimBPCompileProfiler, Log, TEXT("Compile profile written to %s"), *CsvPath);
+    return true;
+}
+
+FString FAnimBPCompileProfiler::GetDefaultReportDirectory()
+{
+    return FPaths::ProjectSavedDir() / TEXT("AnimBPTool") / TEXT("Reports");
+}
@@ -0,0 +1,47 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UBlueprint;
+
+struct FAnimBPCompileProfileRow
+{
+    // Graph name, or node title for node rows
+    FString Name;
+    FString Graph;
+    bool bGraph = false;
+    int32 SourceNodes = 0;
+    // What the compiler expanded the graph or node into
+    int32 IntermediateNodes = 0;
+    int32 IntermediatePins = 0;
+};
+
+struct FAnimBPCompileProfile
+{
+    FString BlueprintPath;
+    double CompileSeconds = 0.0;
+    bool bCompileFailed = false;
+    int32 SourceNodes = 0;
+    int32 IntermediateNodes = 0;
+    int32 IntermediatePins = 0;
+    TArray<TSharedPtr<FAnimBPCompileProfileRow>> Rows;
+    // Timed compiler phases as reported by the compiler, outermost first
+    TArray<FString> CompilerEvents;
+};
+
+/*
+ * Compiles a blueprint once with detailed compiler events and intermediate products kept, and attributes every
+ * intermediate node back to the graph and node it was expanded from. Intermediate size is what drives the
+ * later compile phases, so the heaviest rows are where compile time goes.
+ */
+class FAnimBPCompileProfiler
+{
+public:
+    static void Profile(UBlueprint* Blueprint, FAnimBPCompileProfile& OutProfile);
+
+    static bool WriteReport(const FString& Directory, FAnimBPCompileProfile const& Profile);
+
+    static FString GetDefaultReportDirectory();
+};
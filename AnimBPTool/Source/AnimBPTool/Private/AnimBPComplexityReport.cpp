@@ -0,0 +1,287 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "AnimBPComplexityReport.h"
+
+#include "AssetRegistryModule.h"
+#include "Editor.h"
+#include "Animation/AnimBlueprint.h"
+#include "Subsystems/AssetEditorSubsystem.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Input/SSearchBox.h"
+#include "Widgets/Text/STextBlock.h"
+#include "Widgets/Views/STableRow.h"
+
+#define LOCTEXT_NAMESPACE "SAnimBPComplexityReport"
+
+const FName SAnimBPComplexityReport::NameColumn(TEXT("Name"));
+const FName SAnimBPComplexityReport::FolderColumn(TEXT("Folder"));
+
+namespace
+{
+    struct FMetricColumn
+    {
+        FName Column;
+        FText Label;
+        int32 FAnimBPComplexityMetrics::* Member;
+    };
+
+    TArray<FMetricColumn> const& GetMetricColumns()
+    {
+        static const TArray<FMetricColumn> Columns = {
+            {TEXT("SlowBindings"), LOCTEXT("SlowBindings_Column", "Slow Bindings"),
+             &FAnimBPComplexityMetrics::SlowBindings},
+            {TEXT("Bindings"), LOCTEXT("Bindings_Column", "Bindings"), &FAnimBPComplexityMetrics::Bindings},
+            {TEXT("Nodes"), LOCTEXT("Nodes_Column", "Nodes"), &FAnimBPComplexityMetrics::Nodes},
+            {TEXT("AnimNodes"), LOCTEXT("AnimNodes_Column", "Anim Nodes"), &FAnimBPComplexityMetrics::AnimNodes},
+            {TEXT("StateMachines"), LOCTEXT("StateMachines_Column", "State Machines"),
+             &FAnimBPComplexityMetrics::StateMachines},
+            {TEXT("States"), LOCTEXT("States_Column", "States"), &FAnimBPComplexityMetrics::States},
+            {TEXT("Transitions"), LOCTEXT("Transitions_Column", "Transitions"),
+             &FAnimBPComplexityMetrics::Transitions},
+            {TEXT("BreakNodes"), LOCTEXT("BreakNodes_Column", "Break Nodes"), &FAnimBPComplexityMetrics::BreakNodes},
+            {TEXT("Graphs"), LOCTEXT("Graphs_Column", "Graphs"), &FAnimBPComplexityMetrics::Graphs},
+            {TEXT("Pins"), LOCTEXT("Pins_Column", "Pins"), &FAnimBPComplexityMetrics::Pins},
+        };
+        return Columns;
+    }
+
+    FMetricColumn const* FindMetricColumn(FName Column)
+    {
+        return GetMetricColumns().FindByPredicate([Column](FMetricColumn const& Metric)
+        {
+            return Metric.Column == Column;
+        });
+    }
+
+    class SAnimBPComplexityReportRow : public SMultiColumnTableRow<TSharedPtr<FAnimBPComplexityReportItem>>
+    {
+    public:
+        SLATE_BEGIN_ARGS(SAnimBPComplexityReportRow)
+            {
+            }
+
+            SLATE_ARGUMENT(TSharedPtr<FAnimBPComplexityReportItem>, Item)
+        SLATE_END_ARGS()
+
+        void Construct(const FArguments& Args, const TSharedRef<STableViewBase>& OwnerTable)
+        {
+            Item = Args._Item;
+            SMultiColumnTableRow<TSharedPtr<FAnimBPComplexityReportItem>>::Construct(
+                FSuperRowType::FArguments(), OwnerTable);
+        }
+
+        virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+        {
+            FText Text;
+            if (ColumnName == SAnimBPComplexityReport::NameColumn)
+            {
+                Text = FText::FromString(Item->Name);
+            }
+            else if (ColumnName == SAnimBPComplexityReport::FolderColumn)
+            {
+                Text = FText::FromString(Item->Folder);
+            }
+            else if (auto Metric = FindMetricColumn(ColumnName))
+            {
+                Text = Item->bTagged ? FText::AsNumber(Item->Metrics.*(Metric->Member)) : FText::FromString(TEXT("-"));
+            }
+            return SNew(STextBlock)
+                .Text(Text)
+                .ColorAndOpacity(Item->bTagged ? FLinearColor::White : FLinearColor(0.5f, 0.5f, 0.5f));
+        }
+
+    private:
+        TSharedPtr<FAnimBPComplexityReportItem> Item;
+    };
+}
+
+void SAnimBPComplexityReport::Construct(const FArguments& Args)
+{
+    SortColumn = GetMetricColumns()[0].Column;
+
+    auto HeaderRow = SNew(SHeaderRow)
+        + SHeaderRow::Column(NameColumn)
+          .DefaultLabel(LOCTEXT("Name_Column", "Animation Blueprint"))
+          .FillWidth(0.2f)
+          .SortMode(this, &SAnimBPComplexityReport::GetSortMode, NameColumn)
+          .OnSort(this, &SAnimBPComplexityReport::OnSortModeChanged)
+        + SHeaderRow::Column(FolderColumn)
+          .DefaultLabel(LOCTEXT("Folder_Column", "Folder"))
+          .FillWidth(0.2f)
+          .SortMode(this, &SAnimBPComplexityReport::GetSortMode, FolderColumn)
+          .OnSort(this, &SAnimBPComplexityReport::OnSortModeChanged);
+    for (auto const& Metric : GetMetricColumns())
+    {
+        HeaderRow->AddColumn(SHeaderRow::Column(Metric.Column)
+                             .DefaultLabel(Metric.Label)
+                             .FillWidth(0.6f / GetMetricColumns().Num())
+                             .SortMode(this, &SAnimBPComplexityReport::GetSortMode, Metric.Column)
+                             .OnSort(this, &SAnimBPComplexityReport::OnSortModeChanged));
+    }
+
+    ChildSlot
+    [
+        SNew(SVerticalBox)
+
+        + SVerticalBox::Slot()
+          .AutoHeight()
+          .Padding(0, 0, 0, 2)
+        [
+            SNew(SHorizontalBox)
+
+            + SHorizontalBox::Slot()
+              .FillWidth(1.0f)
+              .VAlign(VAlign_Center)
+            [
+                SNew(SSearchBox)
+                 .HintText(LOCTEXT("Filter_Hint", "Filter blueprints"))
+                 .OnTextChanged(this, &SAnimBPComplexityReport::OnFilterTextChanged)
+            ]
+
+            + SHorizontalBox::Slot()
+              .AutoWidth()
+              .VAlign(VAlign_Center)
+              .Padding(4, 0, 0, 0)
+            [
+                SNew(SButton)
+                 .Text(LOCTEXT("Refresh", "Refresh"))
+                 .OnClicked(this, &SAnimBPComplexityReport::OnRefresh)
+            ]
+        ]
+
+        + SVerticalBox::Slot()
+          .FillHeight(1.0f)
+        [
+            SAssignNew(ListView, SListView<TSharedPtr<FAnimBPComplexityReportItem>>)
+             .ListItemsSource(&FilteredItems)
+             .OnGenerateRow(this, &SAnimBPComplexityReport::OnGenerateRow)
+             .OnMouseButtonDoubleClick(this, &SAnimBPComplexityReport::OnItemDoubleClicked)
+             .HeaderRow(HeaderRow)
+        ]
+
+        + SVerticalBox::Slot()
+          .AutoHeight()
+          .Padding(0, 2, 0, 0)
+        [
+            SNew(STextBlock)
+             .Text(this, &SAnimBPComplexityReport::GetCountText)
+        ]
+    ];
+
+    Refresh();
+}
+
+void SAnimBPComplexityReport::Refresh()
+{
+    FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(
+        "AssetRegistry");
+    TArray<FAssetData> AssetDatas;
+    AssetRegistryModule.Get().GetAssetsByClass(UAnimBlueprint::StaticClass()->GetFName(), AssetDatas, true);
+
+    AllItems.Reset(AssetDatas.Num());
+    for (auto const& AssetData : AssetDatas)
+    {
+        auto Item = MakeShared<FAnimBPComplexityReportItem>();
+        Item->Path = AssetData.ToSoftObjectPath();
+        Item->Name = AssetData.AssetName.ToString();
+        Item->Folder = AssetData.PackagePath.ToString();
+        Item->bTagged = FAnimBPComplexityTags::Read(AssetData, Item->Metrics);
+        AllItems.Add(MoveTemp(Item));
+    }
+    ApplyFilterAndSort();
+}
+
+void SAnimBPComplexityReport::ApplyFilterAndSort()
+{
+    FilteredItems.Reset();
+    for (auto const& Item : AllItems)
+    {
+        if (FilterText.IsEmpty() || Item->Name.Contains(FilterText) || Item->Folder.Contains(FilterText))
+        {
+            FilteredItems.Add(Item);
+        }
+    }
+
+    const bool bAscending = SortMode != EColumnSortMode::Descending;
+    const FName Column = SortColumn;
+    const auto Metric = FindMetricColumn(Column);
+    FilteredItems.Sort([bAscending, Column, Metric](TSharedPtr<FAnimBPComplexityReportItem> const& A,
+                                                    TSharedPtr<FAnimBPComplexityReportItem> const& B)
+    {
+        int32 Compare;
+        if (Metric)
+        {
+            // Untagged blueprints rank below every tagged one
+            const int32 ValueA = A->bTagged ? A->Metrics.*(Metric->Member) : -1;
+            const int32 ValueB = B->bTagged ? B->Metrics.*(Metric->Member) : -1;
+            Compare = ValueA - ValueB;
+        }
+        else if (Column == FolderColumn)
+        {
+            Compare = A->Folder.Compare(B->Folder, ESearchCase::IgnoreCase);
+        }
+        else
+        {
+            Compare = 0;
+        }
+        if (Compare == 0)
+        {
+            Compare = A->Name.Compare(B->Name, ESearchCase::IgnoreCase);
+        }
+        return bAscending ? Compare < 0 : Compare > 0;
+    });
+    ListView->RequestListRefresh();
+}
+
+void SAnimBPComplexityReport::OnFilterTextChanged(const FText& InFilterText)
+{
+    FilterText = InFilterText.ToString();
+    ApplyFilterAndSort();
+}
+
+EColumnSortMode::Type SAnimBPComplexityReport::GetSortMode(FName Column) const
+{
+    return Column == SortColumn ? SortMode : EColumnSortMode::None;
+}
+
+void SAnimBPComplexityReport::OnSortModeChanged(EColumnSortPriority::Type Priority, const FName& Column,
+                                                EColumnSortMode::Type NewMode)
+{
+    SortColumn = Column;
+    SortMode = NewMode;
+    ApplyFilterAndSort();
+}
+
+TSharedRef<ITableRow> SAnimBPComplexityReport::OnGenerateRow(TSharedPtr<FAnimBPComplexityReportItem> Item,
+                                                             const TSharedRef<STableViewBase>& OwnerTable)
+{
+    return SNew(SAnimBPComplexityReportRow, OwnerTable).Item(Item);
+}
+
+void SAnimBPComplexityReport::OnItemDoubleClicked(TSharedPtr<FAnimBPComplexityReportItem> Item)
+{
+    // The one place a row loads its blueprint
+    if (auto Blueprint = Cast<UAnimBlueprint>(Item->Path.TryLoad()))
+    {
+        GEditor->GetEditorSubsystem<UAssetEditorSubsystem>()->OpenEditorForAsset(Blueprint);
+    }
+}
+
+FReply SAnimBPComplexityReport::OnRefresh()
+{
+    Refresh();
+    return FReply::Handled();
+}
+
+FText SAnimBPComplexityReport::GetCountText() const
+{
+    const int32 NumUntagged = AllItems.FilterByPredicate([](TSharedPtr<FAnimBPComplexityReportItem> const& Item)
+    {
+        return !Item->bTagged;
+    }).Num();
+    return FText::Format(
+        LOCTEXT("Blueprint_Count", "{0} shown, {1} Animation Blueprints, {2} without metrics until resaved"),
+        FText::AsNumber(FilteredItems.Num()), FText::AsNumber(AllItems.Num()), FText::AsNumber(NumUntagged));
+}
+
+#undef LOCTEXT_NAMESPACE
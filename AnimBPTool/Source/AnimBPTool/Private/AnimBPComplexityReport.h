@@ -0,0 +1,67 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimBPComplexityTags.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SHeaderRow.h"
+#include "Widgets/Views/SListView.h"
+
+struct FAnimBPComplexityReportItem
+{
+    FSoftObjectPath Path;
+    FString Name;
+    FString Folder;
+    bool bTagged = false;
+    FAnimBPComplexityMetrics Metrics;
+};
+
+/*
+ * Every Animation Blueprint in the project ranked by its complexity tags. Rows come from the asset registry
+ * alone, a blueprint is only loaded when its row is opened.
+ */
+class SAnimBPComplexityReport : public SCompoundWidget
+{
+public:
+    SLATE_BEGIN_ARGS(SAnimBPComplexityReport)
+        {
+        }
+
+    SLATE_END_ARGS()
+
+    void Construct(const FArguments& Args);
+
+    // Re-reads the registry
+    void Refresh();
+
+    static const FName NameColumn;
+    static const FName FolderColumn;
+
+private:
+    void ApplyFilterAndSort();
+
+    void OnFilterTextChanged(const FText& InFilterText);
+
+    EColumnSortMode::Type GetSortMode(FName Column) const;
+
+    void OnSortModeChanged(EColumnSortPriority::Type Priority, const FName& Column, EColumnSortMode::Type NewMode);
+
+    TSharedRef<ITableRow> OnGenerateRow(TSharedPtr<FAnimBPComplexityReportItem> Item,
+                                        const TSharedRef<STableViewBase>& OwnerTable);
+
+    void OnItemDoubleClicked(TSharedPtr<FAnimBPComplexityReportItem> Item);
+
+    FReply OnRefresh();
+
+    FText GetCountText() const;
+
+private:
+    TArray<TSharedPtr<FAnimBPComplexityReportItem>> AllItems;
+    TArray<TSharedPtr<FAnimBPComplexityReportItem>> FilteredItems;
+    TSharedPtr<SListView<TSharedPtr<FAnimBPComplexityReportItem>>> ListView;
+
+    FString FilterText;
+    FName SortColumn;
+    EColumnSortMode::Type SortMode = EColumnSortMode::Descending;
+};
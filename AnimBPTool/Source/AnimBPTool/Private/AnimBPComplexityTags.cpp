@@ -0,0 +1,155 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "AnimBPComplexityTags.h"
+
+#include "AnimBPFastPathAuditor.h"
+#include "AnimBPPinPruner.h"
+#include "AnimGraphNode_Base.h"
+#include "AnimGraphNode_StateMachineBase.h"
+#include "AnimStateNode.h"
+#include "AnimStateTransitionNode.h"
+#include "AssetRegistryModule.h"
+#include "K2Node_BreakStruct.h"
+#include "K2Node_CallFunction.h"
+#include "K2Node_GetClassDefaults.h"
+#include "Animation/AnimBlueprint.h"
+#include "EdGraph/EdGraph.h"
+#include "UObject/UObjectHash.h"
+
+const FName FAnimBPComplexityTags::GraphsTag(TEXT("AnimBPTool_Graphs"));
+const FName FAnimBPComplexityTags::NodesTag(TEXT("AnimBPTool_Nodes"));
+const FName FAnimBPComplexityTags::PinsTag(TEXT("AnimBPTool_Pins"));
+const FName FAnimBPComplexityTags::AnimNodesTag(TEXT("AnimBPTool_AnimNodes"));
+const FName FAnimBPComplexityTags::StateMachinesTag(TEXT("AnimBPTool_StateMachines"));
+const FName FAnimBPComplexityTags::StatesTag(TEXT("AnimBPTool_States"));
+const FName FAnimBPComplexityTags::TransitionsTag(TEXT("AnimBPTool_Transitions"));
+const FName FAnimBPComplexityTags::BreakNodesTag(TEXT("AnimBPTool_BreakNodes"));
+const FName FAnimBPComplexityTags::BindingsTag(TEXT("AnimBPTool_Bindings"));
+const FName FAnimBPComplexityTags::SlowBindingsTag(TEXT("AnimBPTool_SlowBindings"));
+
+FDelegateHandle FAnimBPComplexityTags::ExtraTagsHandle;
+FDelegateHandle FAnimBPComplexityTags::PreSaveHandle;
+TMap<TWeakObjectPtr<const UBlueprint>, FAnimBPComplexityMetrics> FAnimBPComplexityTags::MetricsCache;
+
+namespace
+{
+    bool IsBreakNode(UEdGraphNode* Node)
+    {
+        if (Cast<UK2Node_BreakStruct>(Node) || Cast<UK2Node_GetClassDefaults>(Node))
+        {
+            return true;
+        }
+        auto CallFunction = Cast<UK2Node_CallFunction>(Node);
+        return CallFunction && FAnimBPFastPathAuditor::IsNativeBreakFunction(CallFunction->GetTargetFunction());
+    }
+}
+
+void FAnimBPComplexityTags::Register()
+{
+    ExtraTagsHandle = UObject::FAssetRegistryTag::OnGetExtraObjectTags.AddStatic(
+        &FAnimBPComplexityTags::OnGetExtraObjectTags);
+    PreSaveHandle = UPackage::PreSavePackageEvent.AddStatic(&FAnimBPComplexityTags::OnPreSavePackage);
+}
+
+void FAnimBPComplexityTags::Unregister()
+{
+    UObject::FAssetRegistryTag::OnGetExtraObjectTags.Remove(ExtraTagsHandle);
+    UPackage::PreSavePackageEvent.Remove(PreSaveHandle);
+    MetricsCache.Empty();
+}
+
+void FAnimBPComplexityTags::Compute(UBlueprint* Blueprint, FAnimBPComplexityMetrics& OutMetrics)
+{
+    OutMetrics = FAnimBPComplexityMetrics();
+    TArray<UEdGraph*> Graphs;
+    Blueprint->GetAllGraphs(Graphs);
+    OutMetrics.Graphs = Graphs.Num();
+    OutMetrics.Pins = FAnimBPPinPruner::CountPins(Graphs);
+    for (auto Graph : Graphs)
+    {
+        for (auto Node : Graph->Nodes)
+        {
+            if (!Node)
+            {
+                continue;
+            }
+            ++OutMetrics.Nodes;
+            OutMetrics.AnimNodes += Cast<UAnimGraphNode_Base>(Node) ? 1 : 0;
+            OutMetrics.StateMachines += Cast<UAnimGraphNode_StateMachineBase>(Node) ? 1 : 0;
+            OutMetrics.States += Cast<UAnimStateNode>(Node) ? 1 : 0;
+            OutMetrics.Transitions += Cast<UAnimStateTransitionNode>(Node) ? 1 : 0;
+            OutMetrics.BreakNodes += IsBreakNode(Node) ? 1 : 0;
+        }
+    }
+
+    FAnimBPFastPathReport FastPathReport;
+    FAnimBPFastPathAuditor::Audit(Blueprint, FastPathReport);
+    OutMetrics.Bindings = FastPathReport.NumBindings;
+    OutMetrics.SlowBindings = FastPathReport.NumSlow();
+}
+
+void FAnimBPComplexityTags::OnPreSavePackage(UPackage* Package)
+{
+    ForEachObjectWithPackage(Package, [](UObject* Object)
+    {
+        if (auto Blueprint = Cast<UAnimBlueprint>(Object))
+        {
+            Compute(Blueprint, MetricsCache.FindOrAdd(Blueprint));
+        }
+        return true;
+    }, false);
+}
+
+void FAnimBPComplexityTags::OnGetExtraObjectTags(const UObject* Object, TArray<UObject::FAssetRegistryTag>& OutTags)
+{
+    auto Blueprint = Cast<const UAnimBlueprint>(Object);
+    if (!Blueprint)
+    {
+        return;
+    }
+    // Only a save computes metrics. Tag queries in between repeat what the registry has from the last save,
+    // and blueprints never saved with metrics get none.
+    FAnimBPComplexityMetrics SavedMetrics;
+    auto Metrics = MetricsCache.Find(Blueprint);
+    if (!Metrics)
+    {
+        FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(
+            "AssetRegistry");
+        const FAssetData AssetData = AssetRegistryModule.Get().GetAssetByObjectPath(*Blueprint->GetPathName());
+        if (!Read(AssetData, SavedMetrics))
+        {
+            return;
+        }
+        Metrics = &SavedMetrics;
+    }
+
+    using FTag = UObject::FAssetRegistryTag;
+    OutTags.Emplace(GraphsTag, LexToString(Metrics->Graphs), FTag::TT_Numerical);
+    OutTags.Emplace(NodesTag, LexToString(Metrics->Nodes), FTag::TT_Numerical);
+    OutTags.Emplace(PinsTag, LexToString(Metrics->Pins), FTag::TT_Numerical);
+    OutTags.Emplace(AnimNodesTag, LexToString(Metrics->AnimNodes), FTag::TT_Numerical);
+    OutTags.Emplace(StateMachinesTag, LexToString(Metrics->StateMachines), FTag::TT_Numerical);
+    OutTags.Emplace(StatesTag, LexToString(Metrics->States), FTag::TT_Numerical);
+    OutTags.Emplace(TransitionsTag, LexToString(Metrics->Transitions), FTag::TT_Numerical);
+    OutTags.Emplace(BreakNodesTag, LexToString(Metrics->BreakNodes), FTag::TT_Numerical);
+    OutTags.Emplace(BindingsTag, LexToString(Metrics->Bindings), FTag::TT_Numerical);
+    OutTags.Emplace(SlowBindingsTag, LexToString(Metrics->SlowBindings), FTag::TT_Numerical);
+}
+
+bool FAnimBPComplexityTags::Read(const FAssetData& AssetData, FAnimBPComplexityMetrics& OutMetrics)
+{
+    if (!AssetData.GetTagValue(NodesTag, OutMetrics.Nodes))
+    {
+        return false;
+    }
+    AssetData.GetTagValue(GraphsTag, OutMetrics.Graphs);
+    AssetData.GetTagValue(PinsTag, OutMetrics.Pins);
+    AssetData.GetTagValue(AnimNodesTag, OutMetrics.AnimNodes);
+    AssetData.GetTagValue(StateMachinesTag, OutMetrics.StateMachines);
+    AssetData.GetTagValue(StatesTag, OutMetrics.States);
+    AssetData.GetTagValue(TransitionsTag, OutMetrics.Transitions);
+    AssetData.GetTagValue(BreakNodesTag, OutMetrics.BreakNodes);
+    AssetData.GetTagValue(BindingsTag, OutMetrics.Bindings);
+    AssetData.GetTagValue(SlowBindingsTag, OutMetrics.SlowBindings);
+    return true;
+}
@@ -0,0 +1,64 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetData.h"
+
+class UBlueprint;
+class UPackage;
+
+struct FAnimBPComplexityMetrics
+{
+    int32 Graphs = 0;
+    int32 Nodes = 0;
+    int32 Pins = 0;
+    int32 AnimNodes = 0;
+    int32 StateMachines = 0;
+    // Conduits are neither states nor transitions
+    int32 States = 0;
+    int32 Transitions = 0;
+    // Struct breaks, native break functions and class defaults
+    int32 BreakNodes = 0;
+    int32 Bindings = 0;
+    int32 SlowBindings = 0;
+};
+
+/*
+ * Publishes complexity metrics of Animation Blueprints as asset registry tags, computed when the blueprint is
+ * saved, so project-wide reports can rank blueprints without loading them. Blueprints saved before this have
+ * no tags until their next save.
+ */
+class FAnimBPComplexityTags
+{
+public:
+    static const FName GraphsTag;
+    static const FName NodesTag;
+    static const FName PinsTag;
+    static const FName AnimNodesTag;
+    static const FName StateMachinesTag;
+    static const FName StatesTag;
+    static const FName TransitionsTag;
+    static const FName BreakNodesTag;
+    static const FName BindingsTag;
+    static const FName SlowBindingsTag;
+
+    static void Register();
+    static void Unregister();
+
+    static void Compute(UBlueprint* Blueprint, FAnimBPComplexityMetrics& OutMetrics);
+
+    // False when the blueprint was not saved with metrics
+    static bool Read(const FAssetData& AssetData, FAnimBPComplexityMetrics& OutMetrics);
+
+private:
+    static void OnGetExtraObjectTags(const UObject* Object, TArray<UObject::FAssetRegistryTag>& OutTags);
+
+    static void OnPreSavePackage(UPackage* Package);
+
+    static FDelegateHandle ExtraTagsHandle;
+    static FDelegateHandle PreSaveHandle;
+
+    // Refreshed on save only, tags are gathered from it so they match what was saved
+    static TMap<TWeakObjectPtr<const UBlueprint>, FAnimBPComplexityMetrics> MetricsCache;
+};
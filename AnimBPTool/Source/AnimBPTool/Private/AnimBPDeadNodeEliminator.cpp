@@ -0,0 +1,236 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "AnimBPDeadNodeEliminator.h"
+
+#include "AnimBPTool.h"
+#include "AnimGraphNode_Base.h"
+#include "AnimationGraphSchema.h"
+#include "EdGraphSchema_K2.h"
+#include "K2Node.h"
+#include "K2Node_Tunnel.h"
+#include "ScopedTransaction.h"
+#include "EdGraph/EdGraph.h"
+#include "Engine/Blueprint.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+#include "Kismet2/KismetEditorUtilities.h"
+#include "Logging/MessageLog.h"
+#include "Misc/UObjectToken.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimBPDeadNodes, Log, All);
+
+#define LOCTEXT_NAMESPACE "FAnimBPToolModule"
+
+namespace
+{
+    bool IsExecPin(UEdGraphPin* Pin)
+    {
+        return Pin->PinType.PinCategory == UEdGraphSchema_K2::PC_Exec;
+    }
+
+    bool IsRootNode(UEdGraphNode* Node)
+    {
+        // Comments, state machine nodes, tunnels and whatever the user cannot delete are never dead
+        auto K2Node = Cast<UK2Node>(Node);
+        if (!K2Node || Cast<UK2Node_Tunnel>(K2Node) || !K2Node->CanUserDeleteNode())
+        {
+            return true;
+        }
+        // Pose chains end in an anim node without pose output: output pose, state and transition results, and
+        // saved cached poses, which are read by name rather than through a link
+        if (Cast<UAnimGraphNode_Base>(K2Node))
+        {
+            return !K2Node->Pins.ContainsByPredicate([](UEdGraphPin* Pin)
+            {
+                return Pin->Direction == EGPD_Output && UAnimationGraphSchema::IsPosePin(Pin->PinType);
+            });
+        }
+        // Events start exec chains, they run without an exec input
+        return !K2Node->IsNodePure() && !K2Node->Pins.ContainsByPredicate([](UEdGraphPin* Pin)
+        {
+            return Pin->Direction == EGPD_Input && IsExecPin(Pin);
+        });
+    }
+
+    bool IsDeadOrphanedPin(UEdGraphPin* Pin)
+    {
+        return Pin->bOrphanedPin && Pin->LinkedTo.Num() == 0;
+    }
+}
+
+void FAnimBPDeadNodeEliminator::FindDeadNodesInGraph(UEdGraph* Graph, FAnimBPDeadNodes& OutDeadNodes)
+{
+    // Exec wires are followed forwards from the roots, data and pose inputs backwards from whatever is reached
+    TSet<UEdGraphNode*> LiveNodes;
+    TArray<UEdGraphNode*> Stack;
+    for (auto Node : Graph->Nodes)
+    {
+        if (Node && IsRootNode(Node))
+        {
+            LiveNodes.Add(Node);
+            Stack.Add(Node);
+        }
+    }
+    while (Stack.Num())
+    {
+        auto Node = Stack.Pop(false);
+        for (auto Pin : Node->Pins)
+        {
+            const bool bFollow = Pin->Direction == EGPD_Output ? IsExecPin(Pin) : !IsExecPin(Pin);
+            if (!bFollow)
+            {
+                continue;
+            }
+            for (auto LinkedPin : Pin->LinkedTo)
+            {
+                auto SourceNode = LinkedPin->GetOwningNode();
+                bool bAlreadyLive = false;
+                LiveNodes.Add(SourceNode, &bAlreadyLive);
+                if (!bAlreadyLive)
+                {
+                    Stack.Add(SourceNode);
+                }
+            }
+        }
+    }
+
+    for (auto Node : Graph->Nodes)
+    {
+        if (!Node)
+        {
+            continue;
+        }
+        if (!LiveNodes.Contains(Node))
+        {
+            OutDeadNodes.Nodes.Add(Node);
+            continue;
+        }
+        const int32 NumOrphaned = Node->Pins.FilterByPredicate(IsDeadOrphanedPin).Num();
+        if (NumOrphaned > 0)
+        {
+            OutDeadNodes.NodesWithOrphanedPins.Add(Node);
+            OutDeadNodes.NumOrphanedPins += NumOrphaned;
+        }
+    }
+}
+
+void FAnimBPDeadNodeEliminator::FindDeadNodes(UBlueprint* Blueprint, FAnimBPDeadNodes& OutDeadNodes)
+{
+    OutDeadNodes = FAnimBPDeadNodes();
+    if (!Blueprint)
+    {
+        return;
+    }
+
+    TArray<UEdGraph*> Graphs;
+    Blueprint->GetAllGraphs(Graphs);
+    OutDeadNodes.NumGraphs = Graphs.Num();
+    for (auto Graph : Graphs)
+    {
+        FindDeadNodesInGraph(Graph, OutDeadNodes);
+    }
+    UE_LOG(LogAnimBPDeadNodes, Log, TEXT("[%s] found %d dead nodes and %d orphaned pins over %d graphs"),
+           *Blueprint->GetName(), OutDeadNodes.Nodes.Num(), OutDeadNodes.NumOrphanedPins, OutDeadNodes.NumGraphs);
+}
+
+int32 FAnimBPDeadNodeEliminator::RemoveDeadNodes(UBlueprint* Blueprint, FAnimBPDeadNodes const& DeadNodes)
+{
+    if (!Blueprint || DeadNodes.IsEmpty())
+    {
+        return 0;
+    }
+
+    FScopedTransaction Transaction(LOCTEXT("RemoveDeadNodes", "Remove Dead Nodes"));
+    Blueprint->Modify();
+    int32 NumRemoved = 0;
+    for (auto const& WeakNode : DeadNodes.Nodes)
+    {
+        auto Node = WeakNode.Get();
+        if (!Node || !Node->GetGraph())
+        {
+            continue;
+        }
+        Node->GetGraph()->Modify();
+        Node->Modify();
+        FBlueprintEditorUtils::RemoveNode(Blueprint, Node, true);
+        ++NumRemoved;
+    }
+
+    // Orphaned pins only survive a reconstruct while they are flagged to be saved
+    int32 NumRebuilt = 0;
+    for (auto const& WeakNode : DeadNodes.NodesWithOrphanedPins)
+    {
+        auto Node = WeakNode.Get();
+        if (!Node)
+        {
+            continue;
+        }
+        Node->Modify();
+        for (auto Pin : Node->Pins)
+        {
+            if (IsDeadOrphanedPin(Pin))
+            {
+                Pin->SetSavePinIfOrphaned(false);
+            }
+        }
+        Node->ReconstructNode();
+        ++NumRebuilt;
+    }
+
+    if (NumRemoved + NumRebuilt > 0)
+    {
+        FBlueprintEditorUtils::MarkBlueprintAsStructurallyModified(Blueprint);
+    }
+    else
+    {
+        Transaction.Cancel();
+    }
+    UE_LOG(LogAnimBPDeadNodes, Log, TEXT("[%s] removed %d dead nodes, dropped orphaned pins of %d nodes"),
+           *Blueprint->GetName(), NumRemoved, NumRebuilt);
+    return NumRemoved;
+}
+
+void FAnimBPDeadNodeEliminator::ReportToMessageLog(UBlueprint* Blueprint, FAnimBPDeadNodes const& DeadNodes)
+{
+    auto AddNodeMessage = [](FMessageLog& MessageLog, UEdGraphNode* Node, FText const& Text)
+    {
+        auto NodeToken = FUObjectToken::Create(Node, Node->GetNodeTitle(ENodeTitleType::ListView));
+        NodeToken->OnMessageTokenActivated(FOnMessageTokenActivated::CreateLambda(
+            [](const TSharedRef<IMessageToken>& Token)
+            {
+                auto Object = StaticCastSharedRef<FUObjectToken>(Token)->GetObject().Get();
+                if (Object)
+                {
+                    FKismetEditorUtilities::BringKismetToFocusAttentionOnObject(Object);
+                }
+            }));
+        MessageLog.Info()->AddToken(NodeToken)->AddToken(FTextToken::Create(Text));
+    };
+
+    FMessageLog MessageLog(FAnimBPToolModule::MessageLogName);
+    MessageLog.NewPage(FText::Format(LOCTEXT("DeadNodesPage", "Dead Nodes: {0}"),
+                                     FText::FromString(Blueprint->GetName())));
+    for (auto const& WeakNode : DeadNodes.Nodes)
+    {
+        if (auto Node = WeakNode.Get())
+        {
+            AddNodeMessage(MessageLog, Node,
+                           FText::Format(LOCTEXT("DeadNode", "in {0} is reached by no event or result"),
+                                         FText::FromString(Node->GetGraph()->GetName())));
+        }
+    }
+    for (auto const& WeakNode : DeadNodes.NodesWithOrphanedPins)
+    {
+        if (auto Node = WeakNode.Get())
+        {
+            const int32 NumOrphaned = Node->Pins.FilterByPredicate(IsDeadOrphanedPin).Num();
+            AddNodeMessage(MessageLog, Node, FText::Format(
+                               LOCTEXT("OrphanedPins", "keeps {0} unconnected orphaned pins"), NumOrphaned));
+        }
+    }
+    MessageLog.Info(FText::Format(
+        LOCTEXT("DeadNodesSummary", "{0} dead nodes and {1} orphaned pins over {2} graphs"), DeadNodes.Nodes.Num(),
+        DeadNodes.NumOrphanedPins, DeadNodes.NumGraphs));
+    MessageLog.Open(EMessageSeverity::Info, true);
+}
+
+#undef LOCTEXT_NAMESPACE
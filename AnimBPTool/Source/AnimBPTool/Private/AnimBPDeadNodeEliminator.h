@@ -0,0 +1,42 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UBlueprint;
+class UEdGraph;
+class UEdGraphNode;
+
+struct FAnimBPDeadNodes
+{
+    int32 NumGraphs = 0;
+    // Nodes neither executed nor read by anything that is
+    TArray<TWeakObjectPtr<UEdGraphNode>> Nodes;
+    // Live nodes keeping unconnected orphaned pins
+    TArray<TWeakObjectPtr<UEdGraphNode>> NodesWithOrphanedPins;
+    int32 NumOrphanedPins = 0;
+
+    bool IsEmpty() const { return Nodes.Num() == 0 && NumOrphanedPins == 0; }
+};
+
+/*
+ * Finds dead code over a whole blueprint. Events and function entries are live along their exec wires, the
+ * output pose, state, transition and cached pose results are live, and so is everything feeding a live node
+ * through its data and pose inputs; the remaining deletable nodes are dead. Finding and removing are split so
+ * the caller can preview the list.
+ */
+class FAnimBPDeadNodeEliminator
+{
+public:
+    static void FindDeadNodes(UBlueprint* Blueprint, FAnimBPDeadNodes& OutDeadNodes);
+
+    // Removes the found nodes and orphaned pins under one transaction, returns the number of nodes removed
+    static int32 RemoveDeadNodes(UBlueprint* Blueprint, FAnimBPDeadNodes const& DeadNodes);
+
+    // Lists the dead nodes in the AnimBPTool message log, each linking to its node
+    static void ReportToMessageLog(UBlueprint* Blueprint, FAnimBPDeadNodes const& DeadNodes);
+
+private:
+    static void FindDeadNodesInGraph(UEdGraph* Graph, FAnimBPDeadNodes& OutDeadNodes);
+};
@@ -0,0 +1,341 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "AnimBPFastPathAuditor.h"
+
+#include "AnimBPTool.h"
+#include "AnimGraphNode_Base.h"
+#include "AnimationGraphSchema.h"
+#include "EdGraphSchema_K2.h"
+#include "EdGraphUtilities.h"
+#include "K2Node_BreakStruct.h"
+#include "K2Node_CallFunction.h"
+#include "K2Node_Knot.h"
+#include "K2Node_VariableGet.h"
+#include "ScopedTransaction.h"
+#include "Engine/Blueprint.h"
+#include "Kismet/KismetMathLibrary.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+#include "Kismet2/KismetEditorUtilities.h"
+#include "Logging/MessageLog.h"
+#include "Misc/UObjectToken.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimBPFastPath, Log, All);
+
+#define LOCTEXT_NAMESPACE "FAnimBPToolModule"
+
+namespace
+{
+    // Function side of HasNativeBreak, FBlueprintMetadata only names the struct side
+    const FName NativeBreakFuncMetadata(TEXT("NativeBreakFunc"));
+
+    UEdGraphPin* SkipKnots(UEdGraphPin* Pin)
+    {
+        while (Pin)
+        {
+            auto Knot = Cast<UK2Node_Knot>(Pin->GetOwningNode());
+            if (!Knot || Knot->GetInputPin()->LinkedTo.Num() != 1)
+            {
+                break;
+            }
+            Pin = Knot->GetInputPin()->LinkedTo[0];
+        }
+        return Pin;
+    }
+
+    // Source of the first data input pin, knots skipped
+    UEdGraphPin* FindInputSource(UEdGraphNode* Node)
+    {
+        for (auto Pin : Node->Pins)
+        {
+            if (Pin->Direction == EGPD_Input && !Pin->bHidden && Pin->PinType.PinCategory != UEdGraphSchema_K2::PC_Exec
+                && Pin->PinName != UEdGraphSchema_K2::PN_Self)
+            {
+                return Pin->LinkedTo.Num() == 1 ? SkipKnots(Pin->LinkedTo[0]) : nullptr;
+            }
+        }
+        return nullptr;
+    }
+
+    bool IsMemberVariableGet(UEdGraphPin* Pin)
+    {
+        auto VariableGet = Pin ? Cast<UK2Node_VariableGet>(Pin->GetOwningNode()) : nullptr;
+        return VariableGet && VariableGet->IsNodePure() && VariableGet->VariableReference.IsSelfContext();
+    }
+
+    // Property bindings are the linked, non pose inputs of an anim node
+    template <typename Func>
+    void ForEachBinding(UBlueprint* Blueprint, Func&& Callback)
+    {
+        TArray<UEdGraph*> Graphs;
+        Blueprint->GetAllGraphs(Graphs);
+        for (auto Graph : Graphs)
+        {
+            for (auto Node : Graph->Nodes)
+            {
+                auto AnimNode = Cast<UAnimGraphNode_Base>(Node);
+                if (!AnimNode)
+                {
+                    continue;
+                }
+                Callback(AnimNode, nullptr);
+                for (auto Pin : AnimNode->Pins)
+                {
+                    if (Pin->Direction == EGPD_Input && Pin->LinkedTo.Num() > 0
+                        && !UAnimationGraphSchema::IsPosePin(Pin->PinType))
+                    {
+                        Callback(AnimNode, Pin);
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool FAnimBPFastPathAuditor::IsNativeBreakFunction(const UFunction* Function)
+{
+    if (!Function)
+    {
+        return false;
+    }
+    if (Function->HasMetaData(NativeBreakFuncMetadata))
+    {
+        return true;
+    }
+    for (TFieldIterator<FStructProperty> It(Function); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
+    {
+        // Const references are inputs too, e.g. BreakHitResult
+        const bool bInput = !It->HasAnyPropertyFlags(CPF_ReturnParm)
+            && (!It->HasAnyPropertyFlags(CPF_OutParm) || It->HasAnyPropertyFlags(CPF_ConstParm));
+        if (bInput)
+        {
+            const FString& NativeBreak = It->Struct->GetMetaData(FBlueprintMetadata::MD_NativeBreakFunction);
+            return !NativeBreak.IsEmpty() && NativeBreak == Function->GetPathName();
+        }
+    }
+    return false;
+}
+
+EAnimBPBindingPath FAnimBPFastPathAuditor::ClassifyBinding(UEdGraphPin* SourcePin, FText& OutReason)
+{
+    auto SourceNode = SourcePin->GetOwningNode();
+    if (auto VariableGet = Cast<UK2Node_VariableGet>(SourceNode))
+    {
+        if (IsMemberVariableGet(SourcePin))
+        {
+            return EAnimBPBindingPath::FastPath;
+        }
+        OutReason = VariableGet->VariableReference.IsSelfContext()
+                        ? LOCTEXT("FastPath_ImpureGet", "reads a variable through a validated get")
+                        : LOCTEXT("FastPath_OtherObject", "reads a variable of another object");
+        return EAnimBPBindingPath::Slow;
+    }
+
+    if (auto BreakStruct = Cast<UK2Node_BreakStruct>(SourceNode))
+    {
+        auto StructSource = FindInputSource(BreakStruct);
+        if (IsMemberVariableGet(StructSource))
+        {
+            return EAnimBPBindingPath::FastPath;
+        }
+        OutReason = StructSource && Cast<UK2Node_BreakStruct>(StructSource->GetOwningNode())
+                        ? LOCTEXT("FastPath_BreakChain", "breaks a struct out of another struct break")
+                        : LOCTEXT("FastPath_BreakNonMember", "breaks a struct that is not a member variable");
+        return EAnimBPBindingPath::Slow;
+    }
+
+    if (auto CallFunction = Cast<UK2Node_CallFunction>(SourceNode))
+    {
+        auto Function = CallFunction->GetTargetFunction();
+        if (!Function)
+        {
+            OutReason = LOCTEXT("FastPath_MissingFunction", "calls a missing function");
+            return EAnimBPBindingPath::Slow;
+        }
+        const bool bMemberInput = IsMemberVariableGet(FindInputSource(CallFunction));
+        if (Function->GetFName() == GET_FUNCTION_NAME_CHECKED(UKismetMathLibrary, Not_PreBool) && bMemberInput)
+        {
+            return EAnimBPBindingPath::FastPath;
+        }
+        if (IsNativeBreakFunction(Function))
+        {
+            OutReason = FText::Format(LOCTEXT("FastPath_NativeBreak", "breaks through native function {0}"),
+                                      FText::FromName(Function->GetFName()));
+            return bMemberInput ? EAnimBPBindingPath::Convertible : EAnimBPBindingPath::Slow;
+        }
+        OutReason = FText::Format(Function->GetOwnerClass() == UKismetMathLibrary::StaticClass()
+                                      ? LOCTEXT("FastPath_Math", "computes math node {0}")
+                                      : LOCTEXT("FastPath_Function", "calls function {0}"),
+                                  FText::FromName(Function->GetFName()));
+        return EAnimBPBindingPath::Slow;
+    }
+
+    OutReason = FText::Format(LOCTEXT("FastPath_OtherNode", "is evaluated by {0}"),
+                              SourceNode->GetNodeTitle(ENodeTitleType::ListView));
+    return EAnimBPBindingPath::Slow;
+}
+
+void FAnimBPFastPathAuditor::Audit(UBlueprint* Blueprint, FAnimBPFastPathReport& OutReport)
+{
+    OutReport = FAnimBPFastPathReport();
+    if (!Blueprint)
+    {
+        return;
+    }
+
+    ForEachBinding(Blueprint, [&OutReport](UAnimGraphNode_Base* AnimNode, UEdGraphPin* Pin)
+    {
+        if (!Pin)
+        {
+            ++OutReport.NumAnimNodes;
+            return;
+        }
+        ++OutReport.NumBindings;
+        auto SourcePin = SkipKnots(Pin->LinkedTo[0]);
+        FAnimBPBindingDiagnostic Diagnostic;
+        Diagnostic.Path = ClassifyBinding(SourcePin, Diagnostic.Reason);
+        if (Diagnostic.Path == EAnimBPBindingPath::FastPath)
+        {
+            ++OutReport.NumFastPath;
+            return;
+        }
+        Diagnostic.AnimNode = AnimNode;
+        Diagnostic.PinName = Pin->PinName;
+        Diagnostic.SourceNode = SourcePin->GetOwningNode();
+        OutReport.Diagnostics.Add(MoveTemp(Diagnostic));
+    });
+
+    UE_LOG(LogAnimBPFastPath, Log, TEXT("[%s] %d of %d bindings on %d anim nodes are off the fast path"),
+           *Blueprint->GetName(), OutReport.NumSlow(), OutReport.NumBindings, OutReport.NumAnimNodes);
+}
+
+int32 FAnimBPFastPathAuditor::ConvertToFastPath(UBlueprint* Blueprint)
+{
+    FAnimBPFastPathReport Report;
+    Audit(Blueprint, Report);
+
+    // One native break can feed several bindings
+    TSet<UK2Node_CallFunction*> NativeBreaks;
+    for (auto const& Diagnostic : Report.Diagnostics)
+    {
+        if (Diagnostic.Path == EAnimBPBindingPath::Convertible)
+        {
+            NativeBreaks.Add(CastChecked<UK2Node_CallFunction>(Diagnostic.SourceNode.Get()));
+        }
+    }
+    if (NativeBreaks.Num() == 0)
+    {
+        return 0;
+    }
+
+    const FScopedTransaction Transaction(LOCTEXT("ConvertToFastPath", "Convert Bindings To Fast Path"));
+    auto Schema = GetDefault<UEdGraphSchema_K2>();
+    int32 NumConverted = 0;
+    for (auto NativeBreak : NativeBreaks)
+    {
+        auto StructSource = FindInputSource(NativeBreak);
+        auto StructPin = StructSource ? StructSource->LinkedTo.FindByPredicate([NativeBreak](UEdGraphPin* Pin)
+        {
+            return Pin->GetOwningNode() == NativeBreak;
+        }) : nullptr;
+        // CanBeBroken is false for every HasNativeBreak struct, the member check below is what matters here
+        auto Struct = StructPin ? Cast<UScriptStruct>((*StructPin)->PinType.PinSubCategoryObject.Get()) : nullptr;
+        if (!Struct)
+        {
+            continue;
+        }
+
+        // Native break outputs only map over when they are named after blueprint visible struct members of a
+        // compatible type, those are the pins a Break Struct node gets. BreakTransform's Rotation is a rotator
+        // while the member is a quat, its links would not compile on the Break Struct pin.
+        bool bOutputsMatch = true;
+        for (auto Pin : NativeBreak->Pins)
+        {
+            if (Pin->Direction != EGPD_Output || Pin->LinkedTo.Num() == 0)
+            {
+                continue;
+            }
+            auto Property = Struct->FindPropertyByName(Pin->PinName);
+            FEdGraphPinType MemberType;
+            if (!Property || !Property->HasAnyPropertyFlags(CPF_BlueprintVisible)
+                || !Schema->ConvertPropertyToPinType(Property, MemberType)
+                || !Schema->ArePinTypesCompatible(MemberType, Pin->PinType))
+            {
+                bOutputsMatch = false;
+                break;
+            }
+        }
+        if (!bOutputsMatch)
+        {
+            UE_LOG(LogAnimBPFastPath, Log, TEXT("[%s] outputs of %s do not match %s members, left as is"),
+                   *Blueprint->GetName(), *NativeBreak->GetName(), *Struct->GetName());
+            continue;
+        }
+
+        auto Graph = NativeBreak->GetGraph();
+        Graph->Modify();
+        NativeBreak->Modify();
+        FGraphNodeCreator<UK2Node_BreakStruct> NodeCreator(*Graph);
+        auto BreakStruct = NodeCreator.CreateNode();
+        BreakStruct->StructType = Struct;
+        BreakStruct->NodePosX = NativeBreak->NodePosX;
+        BreakStruct->NodePosY = NativeBreak->NodePosY;
+        NodeCreator.Finalize();
+
+        Schema->MovePinLinks(**StructPin, *BreakStruct->FindPinChecked(Struct->GetFName(), EGPD_Input));
+        for (auto Pin : NativeBreak->Pins)
+        {
+            if (Pin->Direction == EGPD_Output && Pin->LinkedTo.Num() > 0)
+            {
+                Schema->MovePinLinks(*Pin, *BreakStruct->FindPinChecked(Pin->PinName, EGPD_Output));
+            }
+        }
+        NativeBreak->DestroyNode();
+        ++NumConverted;
+    }
+
+    if (NumConverted > 0)
+    {
+        FBlueprintEditorUtils::MarkBlueprintAsStructurallyModified(Blueprint);
+    }
+    UE_LOG(LogAnimBPFastPath, Log, TEXT("[%s] converted %d native struct breaks"), *Blueprint->GetName(),
+           NumConverted);
+    return NumConverted;
+}
+
+void FAnimBPFastPathAuditor::ReportToMessageLog(UBlueprint* Blueprint, FAnimBPFastPathReport const& Report)
+{
+    FMessageLog MessageLog(FAnimBPToolModule::MessageLogName);
+    MessageLog.NewPage(FText::Format(LOCTEXT("FastPathPage", "Fast Path: {0}"),
+                                     FText::FromString(Blueprint->GetName())));
+    for (auto const& Diagnostic : Report.Diagnostics)
+    {
+        auto AnimNode = Diagnostic.AnimNode.Get();
+        if (!AnimNode)
+        {
+            continue;
+        }
+        auto NodeToken = FUObjectToken::Create(AnimNode, AnimNode->GetNodeTitle(ENodeTitleType::ListView));
+        NodeToken->OnMessageTokenActivated(FOnMessageTokenActivated::CreateLambda(
+            [](const TSharedRef<IMessageToken>& Token)
+            {
+                auto Object = StaticCastSharedRef<FUObjectToken>(Token)->GetObject().Get();
+                if (Object)
+                {
+                    FKismetEditorUtilities::BringKismetToFocusAttentionOnObject(Object);
+                }
+            }));
+        auto Message = Diagnostic.Path == EAnimBPBindingPath::Convertible ? MessageLog.Info() : MessageLog.Warning();
+        Message->AddToken(NodeToken);
+        Message->AddToken(FTextToken::Create(FText::Format(
+            LOCTEXT("FastPathBinding", "pin {0} {1}{2}"), FText::FromName(Diagnostic.PinName), Diagnostic.Reason,
+            Diagnostic.Path == EAnimBPBindingPath::Convertible
+                ? LOCTEXT("FastPathConvertible", ", convertible")
+                : FText::GetEmpty())));
+    }
+    MessageLog.Info(FText::Format(
+        LOCTEXT("FastPathSummary", "{0} of {1} bindings on {2} anim nodes are on the fast path"),
+        Report.NumFastPath, Report.NumBindings, Report.NumAnimNodes));
+    MessageLog.Open(EMessageSeverity::Info, true);
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,63 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UBlueprint;
+class UEdGraphNode;
+class UEdGraphPin;
+
+enum class EAnimBPBindingPath : uint8
+{
+    // Copied natively by the anim instance, no VM call
+    FastPath,
+    // Off the fast path, but a rewrite can put it on
+    Convertible,
+    // Evaluated by the Blueprint VM every update
+    Slow,
+};
+
+struct FAnimBPBindingDiagnostic
+{
+    TWeakObjectPtr<UEdGraphNode> AnimNode;
+    FName PinName;
+    // Node the binding reads from, knots skipped
+    TWeakObjectPtr<UEdGraphNode> SourceNode;
+    EAnimBPBindingPath Path = EAnimBPBindingPath::Slow;
+    FText Reason;
+};
+
+struct FAnimBPFastPathReport
+{
+    int32 NumAnimNodes = 0;
+    int32 NumBindings = 0;
+    int32 NumFastPath = 0;
+    // Bindings off the fast path only
+    TArray<FAnimBPBindingDiagnostic> Diagnostics;
+
+    int32 NumSlow() const { return NumBindings - NumFastPath; }
+};
+
+/*
+ * Checks every linked property pin of the anim nodes in all anim graphs against what the anim blueprint compiler
+ * can copy without the VM: a member variable, one struct break of a member variable, or the logical not of a
+ * member bool. Anything else costs a VM thunk per node update.
+ */
+class FAnimBPFastPathAuditor
+{
+public:
+    static void Audit(UBlueprint* Blueprint, FAnimBPFastPathReport& OutReport);
+
+    // Rewrites convertible bindings under one transaction, returns the number of rewritten source nodes
+    static int32 ConvertToFastPath(UBlueprint* Blueprint);
+
+    // Lists the diagnostics in the AnimBPTool message log, each linking to its anim node
+    static void ReportToMessageLog(UBlueprint* Blueprint, FAnimBPFastPathReport const& Report);
+
+    // A UFUNCTION tagged NativeBreakFunc, or the one its struct input names with HasNativeBreak
+    static bool IsNativeBreakFunction(const UFunction* Function);
+
+private:
+    static EAnimBPBindingPath ClassifyBinding(UEdGraphPin* SourcePin, FText& OutReason);
+};
@@ -0,0 +1,229 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "AnimBPNodeMerger.h"
+
+#include "AnimBPPinPruner.h"
+#include "EdGraphSchema_K2.h"
+#include "K2Node_BreakStruct.h"
+#include "K2Node_GetClassDefaults.h"
+#include "K2Node_Knot.h"
+#include "ScopedTransaction.h"
+#include "EdGraph/EdGraph.h"
+#include "Engine/Blueprint.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimBPNodeMerger, Log, All);
+
+#define LOCTEXT_NAMESPACE "FAnimBPToolModule"
+
+namespace
+{
+    // What a pure node reads: the same type from the same pin, or the same literal
+    struct FMergeKey
+    {
+        UClass* NodeClass = nullptr;
+        UObject* Type = nullptr;
+        UEdGraphPin* SourcePin = nullptr;
+        UObject* DefaultObject = nullptr;
+        FString DefaultValue;
+
+        bool operator==(FMergeKey const& Other) const
+        {
+            return NodeClass == Other.NodeClass && Type == Other.Type && SourcePin == Other.SourcePin
+                && DefaultObject == Other.DefaultObject && DefaultValue == Other.DefaultValue;
+        }
+    };
+
+    UEdGraphPin* SkipKnots(UEdGraphPin* Pin)
+    {
+        while (Pin)
+        {
+            auto Knot = Cast<UK2Node_Knot>(Pin->GetOwningNode());
+            if (!Knot || Knot->GetInputPin()->LinkedTo.Num() != 1)
+            {
+                break;
+            }
+            Pin = Knot->GetInputPin()->LinkedTo[0];
+        }
+        return Pin;
+    }
+
+    bool MakeMergeKey(UK2Node* Node, FMergeKey& OutKey)
+    {
+        if (auto BreakStruct = Cast<UK2Node_BreakStruct>(Node))
+        {
+            OutKey.Type = BreakStruct->StructType;
+        }
+        else if (!Cast<UK2Node_GetClassDefaults>(Node))
+        {
+            return false;
+        }
+        OutKey.NodeClass = Node->GetClass();
+
+        for (auto Pin : Node->Pins)
+        {
+            if (Pin->Direction != EGPD_Input || Pin->PinType.PinCategory == UEdGraphSchema_K2::PC_Exec)
+            {
+                continue;
+            }
+            if (Pin->LinkedTo.Num() > 1)
+            {
+                return false;
+            }
+            OutKey.SourcePin = Pin->LinkedTo.Num() == 1 ? SkipKnots(Pin->LinkedTo[0]) : nullptr;
+            OutKey.DefaultObject = Pin->DefaultObject;
+            OutKey.DefaultValue = Pin->DefaultValue;
+            return true;
+        }
+        return false;
+    }
+}
+
+bool FAnimBPNodeMerger::ShowOutputPin(UK2Node* Node, FName PinName)
+{
+    // Get Class Defaults keeps its list private, the pruner reaches it through reflection
+    auto ShowPinForProperties = FAnimBPPinPruner::FindOptionalPins(Node);
+    auto PropertyPin = ShowPinForProperties
+                           ? ShowPinForProperties->FindByPredicate([PinName](FOptionalPinFromProperty const& Pin)
+                           {
+                               return Pin.PropertyName == PinName;
+                           })
+                           : nullptr;
+    if (!PropertyPin || PropertyPin->bShowPin)
+    {
+        return false;
+    }
+    PropertyPin->bShowPin = true;
+    return true;
+}
+
+int32 FAnimBPNodeMerger::MergeGraph(UEdGraph* Graph, FAnimBPMergeStats& Stats)
+{
+    TArray<TPair<FMergeKey, TArray<UK2Node*>>> Groups;
+    for (auto Node : Graph->Nodes)
+    {
+        auto K2Node = Cast<UK2Node>(Node);
+        FMergeKey Key;
+        if (!K2Node || !MakeMergeKey(K2Node, Key))
+        {
+            continue;
+        }
+        auto Group = Groups.FindByPredicate([&Key](TPair<FMergeKey, TArray<UK2Node*>> const& Pair)
+        {
+            return Pair.Key == Key;
+        });
+        if (Group)
+        {
+            Group->Value.Add(K2Node);
+        }
+        else
+        {
+            Groups.Emplace(Key, TArray<UK2Node*>{K2Node});
+        }
+    }
+
+    auto Schema = GetDefault<UEdGraphSchema_K2>();
+    int32 NumRemoved = 0;
+    for (auto& Group : Groups)
+    {
+        auto& Nodes = Group.Value;
+        if (Nodes.Num() < 2)
+        {
+            continue;
+        }
+
+        // Reveal every pin the duplicates use, then rebuild the survivor once
+        auto Survivor = Nodes[0];
+        Graph->Modify();
+        Survivor->Modify();
+        bool bShowPins = false;
+        for (int32 i = 1; i < Nodes.Num(); ++i)
+        {
+            for (auto Pin : Nodes[i]->Pins)
+            {
+                if (Pin->Direction == EGPD_Output && Pin->LinkedTo.Num() > 0 && !Survivor->FindPin(
+                    Pin->PinName, EGPD_Output))
+                {
+                    bShowPins |= ShowOutputPin(Survivor, Pin->PinName);
+                }
+            }
+        }
+        if (bShowPins)
+        {
+            Survivor->ReconstructNode();
+        }
+
+        int32 NumMerged = 0;
+        for (int32 i = 1; i < Nodes.Num(); ++i)
+        {
+            auto Duplicate = Nodes[i];
+            const bool bAllPinsFound = !Duplicate->Pins.ContainsByPredicate([Survivor](UEdGraphPin* Pin)
+            {
+                return Pin->Direction == EGPD_Output && Pin->LinkedTo.Num() > 0
+                    && !Survivor->FindPin(Pin->PinName, EGPD_Output);
+            });
+            if (!bAllPinsFound)
+            {
+                UE_LOG(LogAnimBPNodeMerger, Warning, TEXT("[%s] %s has pins missing on %s, not merged"),
+                       *Graph->GetName(), *Duplicate->GetName(), *Survivor->GetName());
+                continue;
+            }
+
+            Duplicate->Modify();
+            for (auto Pin : Duplicate->Pins)
+            {
+                if (Pin->Direction == EGPD_Output && Pin->LinkedTo.Num() > 0)
+                {
+                    Schema->MovePinLinks(*Pin, *Survivor->FindPin(Pin->PinName, EGPD_Output));
+                }
+            }
+            Duplicate->DestroyNode();
+            ++NumMerged;
+        }
+        if (NumMerged > 0)
+        {
+            ++Stats.NumNodesKept;
+            NumRemoved += NumMerged;
+        }
+    }
+    return NumRemoved;
+}
+
+bool FAnimBPNodeMerger::MergeBlueprint(UBlueprint* Blueprint, FAnimBPMergeStats* OutStats)
+{
+    if (!Blueprint)
+    {
+        return false;
+    }
+
+    TArray<UEdGraph*> Graphs;
+    Blueprint->GetAllGraphs(Graphs);
+
+    FAnimBPMergeStats Stats;
+    Stats.NumGraphs = Graphs.Num();
+
+    FScopedTransaction Transaction(LOCTEXT("MergeDuplicateNodes", "Merge Duplicate Nodes"));
+    for (auto Graph : Graphs)
+    {
+        Stats.NumNodesRemoved += MergeGraph(Graph, Stats);
+    }
+
+    if (Stats.NumNodesRemoved > 0)
+    {
+        FBlueprintEditorUtils::MarkBlueprintAsStructurallyModified(Blueprint);
+    }
+    else
+    {
+        Transaction.Cancel();
+    }
+
+    UE_LOG(LogAnimBPNodeMerger, Log, TEXT("[%s] merged %d duplicate nodes into %d over %d graphs"),
+           *Blueprint->GetName(), Stats.NumNodesRemoved, Stats.NumNodesKept, Stats.NumGraphs);
+    if (OutStats)
+    {
+        *OutStats = Stats;
+    }
+    return Stats.NumNodesRemoved > 0;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,35 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UBlueprint;
+class UEdGraph;
+class UK2Node;
+
+struct FAnimBPMergeStats
+{
+    int32 NumGraphs = 0;
+    // Nodes that absorbed duplicates, and the duplicates removed
+    int32 NumNodesKept = 0;
+    int32 NumNodesRemoved = 0;
+};
+
+/*
+ * Merges struct break and class defaults nodes that read the same value within one graph. The first node of each
+ * group stays, shows the union of the output pins its duplicates had connected, and takes over their links.
+ * The whole blueprint is merged under one transaction.
+ */
+class FAnimBPNodeMerger
+{
+public:
+    // Returns true if any node was removed
+    static bool MergeBlueprint(UBlueprint* Blueprint, FAnimBPMergeStats* OutStats = nullptr);
+
+private:
+    static int32 MergeGraph(UEdGraph* Graph, FAnimBPMergeStats& Stats);
+
+    // Shows the output pin of the property, returns true if it was hidden
+    static bool ShowOutputPin(UK2Node* Node, FName PinName);
+};
@@ -0,0 +1,150 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "AnimBPPinPruner.h"
+
+#include "K2Node_BreakStruct.h"
+#include "K2Node_GetClassDefaults.h"
+#include "ScopedTransaction.h"
+#include "EdGraph/EdGraph.h"
+#include "Engine/Blueprint.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimBPPinPruner, Log, All);
+
+#define LOCTEXT_NAMESPACE "FAnimBPToolModule"
+
+namespace
+{
+    int32 HideUnconnectedPins(UK2Node* Node, TArray<FOptionalPinFromProperty>& ShowPinForProperties,
+                              EEdGraphPinDirection Direction, bool bApply)
+    {
+        int32 NumHidden = 0;
+        for (auto& PropertyPin : ShowPinForProperties)
+        {
+            if (!PropertyPin.bShowPin)
+            {
+                continue;
+            }
+            const auto NodePin = Node->FindPin(PropertyPin.PropertyName, Direction);
+            if (NodePin && NodePin->LinkedTo.Num() <= 0)
+            {
+                if (!bApply)
+                {
+                    ++NumHidden;
+                    continue;
+                }
+                if (NumHidden++ == 0)
+                {
+                    Node->Modify();
+                }
+                PropertyPin.bShowPin = false;
+                NodePin->SetSavePinIfOrphaned(false);
+            }
+        }
+        return NumHidden;
+    }
+}
+
+TArray<FOptionalPinFromProperty>* FAnimBPPinPruner::FindOptionalPins(UK2Node* Node)
+{
+    if (auto BreakStruct = Cast<UK2Node_BreakStruct>(Node))
+    {
+        return &BreakStruct->ShowPinForProperties;
+    }
+    if (auto ClassDefaults = Cast<UK2Node_GetClassDefaults>(Node))
+    {
+        // Not public on Get Class Defaults, the property is reflected though
+        static const auto ShowPinsProperty = FindFProperty<FArrayProperty>(UK2Node_GetClassDefaults::StaticClass(),
+                                                                           TEXT("ShowPinForProperties"));
+        return ShowPinsProperty
+                   ? ShowPinsProperty->ContainerPtrToValuePtr<TArray<FOptionalPinFromProperty>>(ClassDefaults)
+                   : nullptr;
+    }
+    return nullptr;
+}
+
+int32 FAnimBPPinPruner::PruneNode(UK2Node* Node, bool bApply)
+{
+    // Set Fields is left alone, a visible pin there writes its value even when unconnected
+    auto OptionalPins = FindOptionalPins(Node);
+    return OptionalPins ? HideUnconnectedPins(Node, *OptionalPins, EGPD_Output, bApply) : 0;
+}
+
+int32 FAnimBPPinPruner::CountPins(TArray<UEdGraph*> const& Graphs)
+{
+    int32 NumPins = 0;
+    for (auto Graph : Graphs)
+    {
+        for (auto Node : Graph->Nodes)
+        {
+            NumPins += Node ? Node->Pins.Num() : 0;
+        }
+    }
+    return NumPins;
+}
+
+bool FAnimBPPinPruner::PruneBlueprint(UBlueprint* Blueprint, FAnimBPPruneStats* OutStats, bool bApply)
+{
+    if (!Blueprint)
+    {
+        return false;
+    }
+
+    // Includes sub graphs, which is where state machines and transitions live
+    TArray<UEdGraph*> Graphs;
+    Blueprint->GetAllGraphs(Graphs);
+
+    FAnimBPPruneStats Stats;
+    Stats.NumGraphs = Graphs.Num();
+    Stats.PinsBefore = CountPins(Graphs);
+
+    FScopedTransaction Transaction(LOCTEXT("HideAllUnconnectedPins", "Hide All Unconnected Pins"), bApply);
+    TArray<UK2Node*> ChangedNodes;
+    for (auto Graph : Graphs)
+    {
+        for (auto Node : Graph->Nodes)
+        {
+            auto K2Node = Cast<UK2Node>(Node);
+            const int32 NumHidden = K2Node ? PruneNode(K2Node, bApply) : 0;
+            if (NumHidden > 0)
+            {
+                ChangedNodes.Add(K2Node);
+                Stats.NumPinsHidden += NumHidden;
+            }
+        }
+    }
+
+    Stats.NumNodesChanged = ChangedNodes.Num();
+    if (!bApply)
+    {
+        // Every hidden pin is one pin less once the node is rebuilt
+        Stats.PinsAfter = Stats.PinsBefore - Stats.NumPinsHidden;
+    }
+    else
+    {
+        // Rebuild after everything is gathered, and recompile once for all of them
+        for (auto Node : ChangedNodes)
+        {
+            Node->ReconstructNode();
+        }
+        if (ChangedNodes.Num())
+        {
+            FBlueprintEditorUtils::MarkBlueprintAsStructurallyModified(Blueprint);
+        }
+        else
+        {
+            Transaction.Cancel();
+        }
+        Stats.PinsAfter = CountPins(Graphs);
+    }
+    UE_LOG(LogAnimBPPinPruner, Log, TEXT("[%s] %s %d pins on %d nodes over %d graphs, %d -> %d pins"),
+           *Blueprint->GetName(), bApply ? TEXT("hid") : TEXT("would hide"), Stats.NumPinsHidden, Stats.NumNodesChanged, Stats.NumGraphs, Stats.PinsBefore,
+           Stats.PinsAfter);
+    if (OutStats)
+    {
+        *OutStats = Stats;
+    }
+    return ChangedNodes.Num() > 0;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,43 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UBlueprint;
+class UEdGraph;
+class UK2Node;
+struct FOptionalPinFromProperty;
+
+struct FAnimBPPruneStats
+{
+    int32 NumGraphs = 0;
+    int32 NumNodesChanged = 0;
+    int32 NumPinsHidden = 0;
+    // Pins of every node in every graph, before and after pruning. A count-only run estimates the after count.
+    int32 PinsBefore = 0;
+    int32 PinsAfter = 0;
+};
+
+/*
+ * Hides unconnected optional pins over a whole blueprint: event graphs, functions, the AnimGraph, state
+ * machines and transitions. Visibility changes are gathered first, then the changed nodes are rebuilt
+ * together under one transaction and the blueprint is marked for recompile once.
+ */
+class FAnimBPPinPruner
+{
+public:
+    // Returns true if any node changed, or would change when bApply is false. Without bApply the blueprint
+    // is only counted, nothing is modified or transacted.
+    static bool PruneBlueprint(UBlueprint* Blueprint, FAnimBPPruneStats* OutStats = nullptr, bool bApply = true);
+
+    static int32 CountPins(TArray<UEdGraph*> const& Graphs);
+
+    // Optional pin list of a Break Struct or Get Class Defaults node, nullptr for other nodes
+    static TArray<FOptionalPinFromProperty>* FindOptionalPins(UK2Node* Node);
+
+private:
+    // Hides the unconnected pins of one node, Modify()s it first when something will change.
+    // Only counts them without bApply.
+    static int32 PruneNode(UK2Node* Node, bool bApply);
+};
@@ -0,0 +1,395 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "AnimBPRuntimeProfiler.h"
+
+#include "AnimGraphNode_Base.h"
+#include "Animation/AnimBlueprint.h"
+#include "Animation/AnimBlueprintGeneratedClass.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimNodeBase.h"
+#include "Animation/Skeleton.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "EdGraph/EdGraph.h"
+#include "Editor.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/World.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Subsystems/AssetEditorSubsystem.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimBPRuntimeProfiler, Log, All);
+
+FDelegateHandle FAnimBPRuntimeProfiler::PreSaveHandle;
+FDelegateHandle FAnimBPRuntimeProfiler::AssetClosedHandle;
+TMap<TWeakObjectPtr<UAnimGraphNode_Base>, FString> FAnimBPRuntimeProfiler::OverlayNodes;
+
+namespace
+{
+    // Nodes nest through their links, children report their inclusive time to the parent on the way out
+    struct FNodeTimerStack
+    {
+        TArray<uint64> ChildCycles;
+
+        uint64 Begin()
+        {
+            ChildCycles.Push(0);
+            return FPlatformTime::Cycles64();
+        }
+
+        void End(uint64 StartCycles, double& SelfSeconds, double& InclusiveSeconds)
+        {
+            const uint64 Inclusive = FPlatformTime::Cycles64() - StartCycles;
+            const uint64 Self = Inclusive - FMath::Min(Inclusive, ChildCycles.Pop(false));
+            if (ChildCycles.Num())
+            {
+                ChildCycles.Last() += Inclusive;
+            }
+            SelfSeconds += FPlatformTime::GetSecondsPerCycle64() * Self;
+            InclusiveSeconds += FPlatformTime::GetSecondsPerCycle64() * Inclusive;
+        }
+    };
+
+    struct FAnimBPNodeTimer : public FAnimNode_Base
+    {
+        FAnimNode_Base* Inner = nullptr;
+        FPoseLinkBase* Link = nullptr;
+        FAnimBPNodeCost* Cost = nullptr;
+        FNodeTimerStack* Stack = nullptr;
+
+        virtual void Initialize_AnyThread(const FAnimationInitializeContext& Context) override
+        {
+            Inner->Initialize_AnyThread(Context);
+        }
+
+        virtual void CacheBones_AnyThread(const FAnimationCacheBonesContext& Context) override
+        {
+            Inner->CacheBones_AnyThread(Context);
+        }
+
+        virtual void Update_AnyThread(const FAnimationUpdateContext& Context) override
+        {
+            const uint64 StartCycles = Stack->Begin();
+            Inner->Update_AnyThread(Context);
+            Stack->End(StartCycles, Cost->UpdateSelfSeconds, Cost->UpdateInclusiveSeconds);
+            ++Cost->UpdateCalls;
+        }
+
+        virtual void Evaluate_AnyThread(FPoseContext& Output) override
+        {
+            const uint64 StartCycles = Stack->Begin();
+            Inner->Evaluate_AnyThread(Output);
+            Stack->End(StartCycles, Cost->EvaluateSelfSeconds, Cost->EvaluateInclusiveSeconds);
+            ++Cost->EvaluateCalls;
+        }
+
+        virtual void EvaluateComponentSpace_AnyThread(FComponentSpacePoseContext& Output) override
+        {
+            const uint64 StartCycles = Stack->Begin();
+            Inner->EvaluateComponentSpace_AnyThread(Output);
+            Stack->End(StartCycles, Cost->EvaluateSelfSeconds, Cost->EvaluateInclusiveSeconds);
+            ++Cost->EvaluateCalls;
+        }
+
+        virtual void GatherDebugData(FNodeDebugData& DebugData) override
+        {
+            Inner->GatherDebugData(DebugData);
+        }
+    };
+
+    // Reflected pose links of a runtime node, single links and arrays of them (blend poses)
+    template <typename Func>
+    void ForEachPoseLink(UScriptStruct* NodeType, FAnimNode_Base* Node, Func&& Callback)
+    {
+        for (TFieldIterator<FProperty> It(NodeType); It; ++It)
+        {
+            if (auto StructProperty = CastField<FStructProperty>(*It))
+            {
+                if (StructProperty->Struct->IsChildOf(FPoseLinkBase::StaticStruct()))
+                {
+                    Callback(StructProperty->ContainerPtrToValuePtr<FPoseLinkBase>(Node));
+                }
+            }
+            else if (auto ArrayProperty = CastField<FArrayProperty>(*It))
+            {
+                auto InnerProperty = CastField<FStructProperty>(ArrayProperty->Inner);
+                if (InnerProperty && InnerProperty->Struct->IsChildOf(FPoseLinkBase::StaticStruct()))
+                {
+                    FScriptArrayHelper ArrayHelper(ArrayProperty, ArrayProperty->ContainerPtrToValuePtr<void>(Node));
+                    for (int32 i = 0; i < ArrayHelper.Num(); ++i)
+                    {
+                        Callback(reinterpret_cast<FPoseLinkBase*>(ArrayHelper.GetRawPtr(i)));
+                    }
+                }
+            }
+        }
+    }
+
+    void SweepInputs(UAnimInstance* AnimInstance, FAnimBPRuntimeProfileOptions const& Options, int32 Frame)
+    {
+        int32 VariableIndex = 0;
+        for (TFieldIterator<FProperty> It(AnimInstance->GetClass(), EFieldIteratorFlags::ExcludeSuper); It; ++It)
+        {
+            if (!It->HasAnyPropertyFlags(CPF_BlueprintVisible) || It->HasAnyPropertyFlags(CPF_BlueprintReadOnly))
+            {
+                continue;
+            }
+            // Offset per variable so they don't all move together
+            const int32 Offset = 17 * VariableIndex++;
+            if (auto FloatProperty = CastField<FFloatProperty>(*It))
+            {
+                const float Phase = 2.0f * PI * (Frame + Offset) / FMath::Max(Options.NumFrames, 1);
+                FloatProperty->SetPropertyValue_InContainer(AnimInstance,
+                                                            0.5f * Options.SweepRange * (1.0f - FMath::Cos(Phase)));
+            }
+            else if (auto BoolProperty = CastField<FBoolProperty>(*It))
+            {
+                BoolProperty->SetPropertyValue_InContainer(AnimInstance, ((Frame + Offset) / 30) % 2 == 1);
+            }
+        }
+    }
+}
+
+void FAnimBPRuntimeProfiler::Register()
+{
+    PreSaveHandle = UPackage::PreSavePackageEvent.AddStatic(&FAnimBPRuntimeProfiler::OnPreSavePackage);
+}
+
+void FAnimBPRuntimeProfiler::Unregister()
+{
+    ClearGraphOverlay();
+    UPackage::PreSavePackageEvent.Remove(PreSaveHandle);
+    if (GEditor && AssetClosedHandle.IsValid())
+    {
+        GEditor->GetEditorSubsystem<UAssetEditorSubsystem>()->OnAssetClosedInEditor().Remove(AssetClosedHandle);
+    }
+}
+
+bool FAnimBPRuntimeProfiler::Profile(UAnimBlueprint* AnimBlueprint, FAnimBPRuntimeProfileOptions const& Options,
+                                     FAnimBPRuntimeProfile& OutProfile)
+{
+    OutProfile = FAnimBPRuntimeProfile();
+    if (!AnimBlueprint || !AnimBlueprint->GeneratedClass || AnimBlueprint->Status == BS_Error)
+    {
+        UE_LOG(LogAnimBPRuntimeProfiler, Error, TEXT("[%s] is not compiled, nothing to profile"),
+               AnimBlueprint ? *AnimBlueprint->GetName() : TEXT("None"));
+        return false;
+    }
+    OutProfile.BlueprintPath = AnimBlueprint->GetPathName();
+
+    auto Mesh = Options.Mesh ? Options.Mesh : AnimBlueprint->GetPreviewMesh(true);
+    if (!Mesh && AnimBlueprint->TargetSkeleton)
+    {
+        Mesh = AnimBlueprint->TargetSkeleton->GetPreviewMesh(true);
+    }
+    if (!Mesh)
+    {
+        UE_LOG(LogAnimBPRuntimeProfiler, Error, TEXT("[%s] has no preview mesh, pass one to profile with"),
+               *AnimBlueprint->GetName());
+        return false;
+    }
+    OutProfile.MeshPath = Mesh->GetPathName();
+
+    auto World = UWorld::CreateWorld(EWorldType::EditorPreview, false);
+    auto MeshComponent = NewObject<USkeletalMeshComponent>(World);
+    MeshComponent->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+    MeshComponent->SetSkeletalMesh(Mesh);
+    MeshComponent->SetAnimationMode(EAnimationMode::AnimationBlueprint);
+    MeshComponent->SetAnimInstanceClass(AnimBlueprint->GeneratedClass);
+    MeshComponent->RegisterComponentWithWorld(World);
+
+    auto AnimInstance = MeshComponent->GetAnimInstance();
+    if (!AnimInstance)
+    {
+        UE_LOG(LogAnimBPRuntimeProfiler, Error, TEXT("[%s] fails to instantiate on %s"), *AnimBlueprint->GetName(),
+               *Mesh->GetName());
+        MeshComponent->UnregisterComponent();
+        World->DestroyWorld(false);
+        return false;
+    }
+
+    // Runtime nodes of the instance, matched to the graph nodes they were compiled from
+    TArray<UEdGraph*> Graphs;
+    AnimBlueprint->GetAllGraphs(Graphs);
+    TMap<FAnimNode_Base*, UAnimGraphNode_Base*> RuntimeToGraphNode;
+    for (auto Graph : Graphs)
+    {
+        for (auto Node : Graph->Nodes)
+        {
+            auto GraphNode = Cast<UAnimGraphNode_Base>(Node);
+            auto RuntimeNode = GraphNode ? GraphNode->GetActiveInstanceNode<FAnimNode_Base>(AnimInstance) : nullptr;
+            if (RuntimeNode)
+            {
+                RuntimeToGraphNode.Add(RuntimeNode, GraphNode);
+            }
+        }
+    }
+
+    // Costs are referenced by the timers, so no reallocation once they are handed out
+    OutProfile.Nodes.Reserve(RuntimeToGraphNode.Num());
+    TMap<FAnimNode_Base*, FAnimBPNodeCost*> Costs;
+    FNodeTimerStack Stack;
+    TArray<TUniquePtr<FAnimBPNodeTimer>> Timers;
+    for (auto const& Pair : RuntimeToGraphNode)
+    {
+        ForEachPoseLink(Pair.Value->GetFNodeType(), Pair.Key, [&](FPoseLinkBase* Link)
+        {
+            auto Target = Link->GetLinkNode();
+            auto TargetGraphNode = Target ? RuntimeToGraphNode.FindRef(Target) : nullptr;
+            if (!TargetGraphNode)
+            {
+                return;
+            }
+            auto& Cost = Costs.FindOrAdd(Target);
+            if (!Cost)
+            {
+                Cost = &OutProfile.Nodes.AddDefaulted_GetRef();
+                Cost->GraphNode = TargetGraphNode;
+                Cost->NodeName = TargetGraphNode->GetNodeTitle(ENodeTitleType::ListView).ToString();
+                Cost->GraphName = TargetGraphNode->GetGraph()->GetName();
+            }
+            auto Timer = MakeUnique<FAnimBPNodeTimer>();
+            Timer->Inner = Target;
+            Timer->Link = Link;
+            Timer->Cost = Cost;
+            Timer->Stack = &Stack;
+            Link->SetLinkNode(Timer.Get());
+            Timers.Add(MoveTemp(Timer));
+        });
+    }
+
+    // No tick function given, so update and evaluation stay on this thread
+    for (int32 Frame = 0; Frame < Options.NumFrames; ++Frame)
+    {
+        if (Options.bSweepInputs)
+        {
+            SweepInputs(AnimInstance, Options, Frame);
+        }
+        const double StartTime = FPlatformTime::Seconds();
+        MeshComponent->TickAnimation(Options.DeltaTime, false);
+        const double TickedTime = FPlatformTime::Seconds();
+        MeshComponent->RefreshBoneTransforms();
+        OutProfile.TickSeconds += TickedTime - StartTime;
+        OutProfile.RefreshSeconds += FPlatformTime::Seconds() - TickedTime;
+    }
+    OutProfile.NumFrames = Options.NumFrames;
+
+    for (auto const& Timer : Timers)
+    {
+        Timer->Link->SetLinkNode(Timer->Inner);
+    }
+    MeshComponent->UnregisterComponent();
+    World->DestroyWorld(false);
+
+    OutProfile.Nodes.Sort([](FAnimBPNodeCost const& A, FAnimBPNodeCost const& B)
+    {
+        return A.SelfSeconds() > B.SelfSeconds();
+    });
+    UE_LOG(LogAnimBPRuntimeProfiler, Log,
+           TEXT("[%s] %d frames on %s, %.3f ms tick, %.3f ms refresh per frame, %d nodes timed"),
+           *AnimBlueprint->GetName(), OutProfile.NumFrames, *Mesh->GetName(),
+           OutProfile.TickSeconds * 1000.0 / FMath::Max(OutProfile.NumFrames, 1),
+           OutProfile.RefreshSeconds * 1000.0 / FMath::Max(OutProfile.NumFrames, 1), OutProfile.Nodes.Num());
+    return true;
+}
+
+bool FAnimBPRuntimeProfiler::WriteReport(const FString& Directory, FAnimBPRuntimeProfile const& Profile)
+{
+    const auto CsvPath = FPaths::ConvertRelativePathToFull(
+        Directory / FString::Printf(TEXT("RuntimeProfile_%s_%s.csv"), *FPaths::GetBaseFilename(Profile.BlueprintPath),
+                                    *FDateTime::Now().ToString()));
+    const double MsPerFrame = 1000.0 / FMath::Max(Profile.NumFrames, 1);
+
+    FString CsvString = TEXT("Node,Graph,UpdateCalls,UpdateSelfMs,UpdateInclusiveMs,EvaluateCalls,EvaluateSelfMs,")
+        TEXT("EvaluateInclusiveMs") LINE_TERMINATOR;
+    for (auto const& Cost : Profile.Nodes)
+    {
+        const FString Name = Cost.NodeName.Replace(TEXT("\""), TEXT("'")).Replace(TEXT("\n"), TEXT(" "));
+        CsvString += FString::Printf(TEXT("\"%s\",\"%s\",%d,%.4f,%.4f,%d,%.4f,%.4f") LINE_TERMINATOR, *Name,
+                                     *Cost.GraphName, Cost.UpdateCalls, Cost.UpdateSelfSeconds * MsPerFrame,
+                                     Cost.UpdateInclusiveSeconds * MsPerFrame, Cost.EvaluateCalls,
+                                     Cost.EvaluateSelfSeconds * MsPerFrame, Cost.EvaluateInclusiveSeconds * MsPerFrame);
+    }
+    // Component totals last, node costs are per frame as well
+    CsvString += FString::Printf(TEXT("\"(Tick Animation)\",,%d,%.4f,,,,") LINE_TERMINATOR, Profile.NumFrames,
+                                 Profile.TickSeconds * MsPerFrame);
+    CsvString += FString::Printf(TEXT("\"(Refresh Bone Transforms)\",,,,,%d,%.4f,") LINE_TERMINATOR,
+                                 Profile.NumFrames, Profile.RefreshSeconds * MsPerFrame);
+    if (!FFileHelper::SaveStringToFile(CsvString, *CsvPath))
+    {
+        UE_LOG(LogAnimBPRuntimeProfiler, Error, TEXT("Fail to write runtime profile %s"), *CsvPath);
+        return false;
+    }
+    UE_LOG(LogAnimBPRuntimeProfiler, Log, TEXT("Runtime profile written to %s"), *CsvPath);
+    return true;
+}
+
+void FAnimBPRuntimeProfiler::ApplyGraphOverlay(FAnimBPRuntimeProfile const& Profile)
+{
+    ClearGraphOverlay();
+    // The editor does not exist yet when the module starts up
+    if (GEditor && !AssetClosedHandle.IsValid())
+    {
+        AssetClosedHandle = GEditor->GetEditorSubsystem<UAssetEditorSubsystem>()->OnAssetClosedInEditor().AddStatic(
+            &FAnimBPRuntimeProfiler::OnAssetClosedInEditor);
+    }
+    const double MsPerFrame = 1000.0 / FMath::Max(Profile.NumFrames, 1);
+    TSet<UEdGraph*> Graphs;
+    for (auto const& Cost : Profile.Nodes)
+    {
+        auto GraphNode = Cost.GraphNode.Get();
+        if (!GraphNode)
+        {
+            continue;
+        }
+        GraphNode->bHasCompilerMessage = true;
+        GraphNode->ErrorType = EMessageSeverity::Info;
+        GraphNode->ErrorMsg = FString::Printf(TEXT("Update %.3f ms, Evaluate %.3f ms per frame"),
+                                              Cost.UpdateSelfSeconds * MsPerFrame,
+                                              Cost.EvaluateSelfSeconds * MsPerFrame);
+        OverlayNodes.Add(GraphNode, GraphNode->ErrorMsg);
+        Graphs.Add(GraphNode->GetGraph());
+    }
+    for (auto Graph : Graphs)
+    {
+        Graph->NotifyGraphChanged();
+    }
+}
+
+void FAnimBPRuntimeProfiler::ClearGraphOverlay(UPackage* Package)
+{
+    TSet<UEdGraph*> Graphs;
+    for (auto It = OverlayNodes.CreateIterator(); It; ++It)
+    {
+        auto GraphNode = It.Key().Get();
+        if (GraphNode && Package && GraphNode->GetOutermost() != Package)
+        {
+            continue;
+        }
+        // A compile since may have put its own message there
+        if (GraphNode && GraphNode->bHasCompilerMessage && GraphNode->ErrorMsg == It.Value())
+        {
+            GraphNode->bHasCompilerMessage = false;
+            GraphNode->ErrorType = EMessageSeverity::Info;
+            GraphNode->ErrorMsg.Empty();
+            Graphs.Add(GraphNode->GetGraph());
+        }
+        It.RemoveCurrent();
+    }
+    for (auto Graph : Graphs)
+    {
+        Graph->NotifyGraphChanged();
+    }
+}
+
+void FAnimBPRuntimeProfiler::OnPreSavePackage(UPackage* Package)
+{
+    ClearGraphOverlay(Package);
+}
+
+void FAnimBPRuntimeProfiler::OnAssetClosedInEditor(UObject* Asset, IAssetEditorInstance* EditorInstance)
+{
+    if (Cast<UAnimBlueprint>(Asset))
+    {
+        ClearGraphOverlay(Asset->GetOutermost());
+    }
+}
@@ -0,0 +1,85 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IAssetEditorInstance;
+class UAnimBlueprint;
+class UAnimGraphNode_Base;
+class UPackage;
+class USkeletalMesh;
+
+struct FAnimBPNodeCost
+{
+    TWeakObjectPtr<UAnimGraphNode_Base> GraphNode;
+    FString NodeName;
+    FString GraphName;
+    int32 UpdateCalls = 0;
+    int32 EvaluateCalls = 0;
+    // Self excludes the time spent in the child nodes linked from this node
+    double UpdateSelfSeconds = 0.0;
+    double UpdateInclusiveSeconds = 0.0;
+    double EvaluateSelfSeconds = 0.0;
+    double EvaluateInclusiveSeconds = 0.0;
+
+    double SelfSeconds() const { return UpdateSelfSeconds + EvaluateSelfSeconds; }
+};
+
+struct FAnimBPRuntimeProfileOptions
+{
+    int32 NumFrames = 300;
+    float DeltaTime = 1.0f / 30.0f;
+    // Falls back to the preview mesh of the blueprint, then of its skeleton
+    USkeletalMesh* Mesh = nullptr;
+    // Sweeps float variables over [0, SweepRange] and toggles bool variables so more of the graph runs
+    bool bSweepInputs = true;
+    float SweepRange = 600.0f;
+};
+
+struct FAnimBPRuntimeProfile
+{
+    FString BlueprintPath;
+    FString MeshPath;
+    int32 NumFrames = 0;
+    // Whole component, tick includes the event graph
+    double TickSeconds = 0.0;
+    double RefreshSeconds = 0.0;
+    // Most expensive first
+    TArray<FAnimBPNodeCost> Nodes;
+};
+
+/*
+ * Runs an Animation Blueprint on a transient skeletal mesh component in a throwaway world and times every anim
+ * node. Each pose link between nodes is pointed at a timing node that forwards to the original, so nothing in
+ * the blueprint changes and no rendering is involved, which keeps it usable under -nullrhi. Output pose and
+ * state results are entered by the instance and the state machines rather than through a pose link, so they are
+ * not timed; they only forward to their input, and whatever they cost stays in the tick total and in the self
+ * time of the owning state machine.
+ */
+class FAnimBPRuntimeProfiler
+{
+public:
+    static void Register();
+    static void Unregister();
+
+    static bool Profile(UAnimBlueprint* AnimBlueprint, FAnimBPRuntimeProfileOptions const& Options,
+                        FAnimBPRuntimeProfile& OutProfile);
+
+    static bool WriteReport(const FString& Directory, FAnimBPRuntimeProfile const& Profile);
+
+    // Shows the per frame cost as a note above each node. The notes are taken down before the package is saved,
+    // when the blueprint editor closes, or by the next compile, whichever comes first.
+    static void ApplyGraphOverlay(FAnimBPRuntimeProfile const& Profile);
+    static void ClearGraphOverlay(UPackage* Package = nullptr);
+
+private:
+    static void OnPreSavePackage(UPackage* Package);
+    static void OnAssetClosedInEditor(UObject* Asset, IAssetEditorInstance* EditorInstance);
+
+    static FDelegateHandle PreSaveHandle;
+    static FDelegateHandle AssetClosedHandle;
+
+    // Note written on each node, only cleared while it is still ours
+    static TMap<TWeakObjectPtr<UAnimGraphNode_Base>, FString> OverlayNodes;
+};
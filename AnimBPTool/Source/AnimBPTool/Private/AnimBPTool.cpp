@@ -1,20 +1,34 @@
 // Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
 
 #include "AnimBPTool.h"
+#include "AnimBPCompileProfileView.h"
+#include "AnimBPComplexityReport.h"
+#include "AnimBPComplexityTags.h"
+#include "AnimBPDeadNodeEliminator.h"
+#include "AnimBPFastPathAuditor.h"
+#include "AnimBPNodeMerger.h"
+#include "AnimBPPinPruner.h"
+#include "AnimBPRuntimeProfiler.h"
 #include "AnimBPToolStyle.h"
 #include "AnimBPToolCommands.h"
 #include "BlueprintEditorModule.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Framework/Docking/TabManager.h"
 #include "Framework/MultiBox/MultiBoxBuilder.h"
 
 #include "IAnimationBlueprintEditorModule.h"
 #include "GraphEditorActions.h"
-#include "K2Node_BreakStruct.h"
-#include "K2Node_GetClassDefaults.h"
-#include "K2Node_SetFieldsInStruct.h"
-#include "EdGraph/EdGraph.h"
+#include "MessageLogModule.h"
+#include "Logging/MessageLog.h"
+#include "Animation/AnimBlueprint.h"
+#include "Misc/MessageDialog.h"
+#include "Widgets/SWindow.h"
+#include "Widgets/Docking/SDockTab.h"
 
 static const FName AnimBPToolTabName("AnimBPTool");
 
+const FName FAnimBPToolModule::MessageLogName("AnimBPTool");
+
 #define LOCTEXT_NAMESPACE "FAnimBPToolModule"
 
 void FAnimBPToolModule::StartupModule()
@@ -33,6 +47,51 @@ void FAnimBPToolModule::StartupModule()
        FExecuteAction::CreateRaw(this, &FAnimBPToolModule::HideUnconnectedPins),
        FCanExecuteAction());
 
+    PluginCommands->MapAction(
+       FAnimBPToolCommands::Get().AuditFastPath,
+       FExecuteAction::CreateRaw(this, &FAnimBPToolModule::AuditFastPath),
+       FCanExecuteAction());
+
+    PluginCommands->MapAction(
+       FAnimBPToolCommands::Get().ConvertFastPath,
+       FExecuteAction::CreateRaw(this, &FAnimBPToolModule::ConvertToFastPath),
+       FCanExecuteAction());
+
+    PluginCommands->MapAction(
+       FAnimBPToolCommands::Get().MergeNodes,
+       FExecuteAction::CreateRaw(this, &FAnimBPToolModule::MergeDuplicateNodes),
+       FCanExecuteAction());
+
+    PluginCommands->MapAction(
+       FAnimBPToolCommands::Get().RemoveDeadNodes,
+       FExecuteAction::CreateRaw(this, &FAnimBPToolModule::RemoveDeadNodes),
+       FCanExecuteAction());
+
+    PluginCommands->MapAction(
+       FAnimBPToolCommands::Get().ProfileCompile,
+       FExecuteAction::CreateRaw(this, &FAnimBPToolModule::ProfileCompile),
+       FCanExecuteAction());
+
+    PluginCommands->MapAction(
+       FAnimBPToolCommands::Get().ComplexityReport,
+       FExecuteAction::CreateRaw(this, &FAnimBPToolModule::OpenComplexityReport),
+       FCanExecuteAction());
+
+    PluginCommands->MapAction(
+       FAnimBPToolCommands::Get().ProfileRuntime,
+       FExecuteAction::CreateRaw(this, &FAnimBPToolModule::ProfileRuntime),
+       FCanExecuteAction());
+
+    FAnimBPComplexityTags::Register();
+    FAnimBPRuntimeProfiler::Register();
+    FGlobalTabmanager::Get()->RegisterNomadTabSpawner(
+            AnimBPToolTabName, FOnSpawnTab::CreateRaw(this, &FAnimBPToolModule::OnSpawnComplexityReportTab))
+        .SetDisplayName(LOCTEXT("ComplexityReportTabTitle", "AnimBP Complexity"))
+        .SetMenuType(ETabSpawnerMenuType::Hidden);
+
+    FMessageLogModule& MessageLogModule = FModuleManager::LoadModuleChecked<FMessageLogModule>("MessageLog");
+    MessageLogModule.RegisterLogListing(MessageLogName, LOCTEXT("AnimBPToolMessageLog", "AnimBPTool"));
+
     AddAnimationBlueprintEditorToolbarExtender();
 }
 
@@ -88,9 +147,65 @@ void FAnimBPToolModule::AddToolbarExtension(FToolBarBuilder& Builder)
             NAME_None,
             LOCTEXT("HideUnconnectedPins", "Hide Unconnected Pins"),
             LOCTEXT("HideUnconnectedPinsTooltip",
-                    "Hide unconnected pins for K2Node_BreakStruct in blueprint"),
+                    "Hide unconnected pins of struct break and class defaults nodes in every graph of the blueprint"),
             FSlateIcon("AnimBPToolStyle", "AnimBPTool.HidePins"));
-        
+
+        Builder.AddToolBarButton(
+            FAnimBPToolCommands::Get().AuditFastPath,
+            NAME_None,
+            LOCTEXT("AuditFastPath", "Audit Fast Path"),
+            LOCTEXT("AuditFastPathTooltip",
+                    "List the anim node bindings that are evaluated by the Blueprint VM instead of the fast path"),
+            FSlateIcon("AnimBPToolStyle", "AnimBPTool.AuditFastPath"));
+
+        Builder.AddToolBarButton(
+            FAnimBPToolCommands::Get().ConvertFastPath,
+            NAME_None,
+            LOCTEXT("ConvertFastPath", "Convert Fast Path"),
+            LOCTEXT("ConvertFastPathTooltip",
+                    "Rewrite native struct breaks of member variables so their bindings take the fast path"),
+            FSlateIcon("AnimBPToolStyle", "AnimBPTool.ConvertFastPath"));
+
+        Builder.AddToolBarButton(
+            FAnimBPToolCommands::Get().MergeNodes,
+            NAME_None,
+            LOCTEXT("MergeDuplicateNodes", "Merge Duplicate Nodes"),
+            LOCTEXT("MergeDuplicateNodesTooltip",
+                    "Merge struct break and class defaults nodes that read the same value in the same graph"),
+            FSlateIcon("AnimBPToolStyle", "AnimBPTool.MergeNodes"));
+
+        Builder.AddToolBarButton(
+            FAnimBPToolCommands::Get().RemoveDeadNodes,
+            NAME_None,
+            LOCTEXT("RemoveDeadNodes", "Remove Dead Nodes"),
+            LOCTEXT("RemoveDeadNodesTooltip",
+                    "Preview and remove nodes no event or result reaches (pure, impure and anim nodes), and unconnected "
+                    "orphaned pins, in every graph"),
+            FSlateIcon("AnimBPToolStyle", "AnimBPTool.RemoveDeadNodes"));
+
+        Builder.AddToolBarButton(
+            FAnimBPToolCommands::Get().ProfileCompile,
+            NAME_None,
+            LOCTEXT("ProfileCompile", "Profile Compile"),
+            LOCTEXT("ProfileCompileTooltip",
+                    "Compile with detailed timing and show which graphs and nodes expand the most"),
+            FSlateIcon("AnimBPToolStyle", "AnimBPTool.ProfileCompile"));
+
+        Builder.AddToolBarButton(
+            FAnimBPToolCommands::Get().ComplexityReport,
+            NAME_None,
+            LOCTEXT("ComplexityReport", "Complexity Report"),
+            LOCTEXT("ComplexityReportTooltip",
+                    "Rank every Animation Blueprint in the project by the complexity tags saved with it"),
+            FSlateIcon("AnimBPToolStyle", "AnimBPTool.ComplexityReport"));
+
+        Builder.AddToolBarButton(
+            FAnimBPToolCommands::Get().ProfileRuntime,
+            NAME_None,
+            LOCTEXT("ProfileRuntime", "Profile Runtime"),
+            LOCTEXT("ProfileRuntimeTooltip",
+                    "Run the blueprint on its preview mesh for a few hundred frames and time every anim node"),
+            FSlateIcon("AnimBPToolStyle", "AnimBPTool.ProfileRuntime"));
     }
     Builder.EndSection();
 }
@@ -98,38 +213,128 @@ void FAnimBPToolModule::AddToolbarExtension(FToolBarBuilder& Builder)
 void FAnimBPToolModule::HideUnconnectedPins() const
 {
     if(!AnimBPEditorPtr.IsValid()) return;
-    const auto GraphPtr = AnimBPEditorPtr.Pin()->GetFocusedGraph();
-    GEditor->BeginTransaction(LOCTEXT("HideAllUnconnectedPins", "Hide All Unconnected Pins"));
-    GraphPtr->Modify();
-    for (const auto Node : GraphPtr->Nodes)
+    FAnimBPPinPruner::PruneBlueprint(AnimBPEditorPtr.Pin()->GetBlueprintObj());
+}
+
+void FAnimBPToolModule::AuditFastPath() const
+{
+    if(!AnimBPEditorPtr.IsValid()) return;
+    auto Blueprint = AnimBPEditorPtr.Pin()->GetBlueprintObj();
+    FAnimBPFastPathReport Report;
+    FAnimBPFastPathAuditor::Audit(Blueprint, Report);
+    FAnimBPFastPathAuditor::ReportToMessageLog(Blueprint, Report);
+}
+
+void FAnimBPToolModule::ConvertToFastPath() const
+{
+    if(!AnimBPEditorPtr.IsValid()) return;
+    auto Blueprint = AnimBPEditorPtr.Pin()->GetBlueprintObj();
+    FAnimBPFastPathAuditor::ConvertToFastPath(Blueprint);
+    // Show what is still off the fast path
+    FAnimBPFastPathReport Report;
+    FAnimBPFastPathAuditor::Audit(Blueprint, Report);
+    FAnimBPFastPathAuditor::ReportToMessageLog(Blueprint, Report);
+}
+
+void FAnimBPToolModule::MergeDuplicateNodes() const
+{
+    if(!AnimBPEditorPtr.IsValid()) return;
+    FAnimBPNodeMerger::MergeBlueprint(AnimBPEditorPtr.Pin()->GetBlueprintObj());
+}
+
+void FAnimBPToolModule::RemoveDeadNodes() const
+{
+    if(!AnimBPEditorPtr.IsValid()) return;
+    auto Blueprint = AnimBPEditorPtr.Pin()->GetBlueprintObj();
+    FAnimBPDeadNodes DeadNodes;
+    FAnimBPDeadNodeEliminator::FindDeadNodes(Blueprint, DeadNodes);
+    FAnimBPDeadNodeEliminator::ReportToMessageLog(Blueprint, DeadNodes);
+    if (DeadNodes.IsEmpty())
+    {
+        return;
+    }
+
+    const FText Message = FText::Format(
+        LOCTEXT("RemoveDeadNodesConfirm",
+                "Remove {0} dead nodes and {1} orphaned pins? Dead nodes include impure calls and anim nodes that no "
+                "event or result reaches. They are listed in the AnimBPTool message log."),
+        DeadNodes.Nodes.Num(), DeadNodes.NumOrphanedPins);
+    if (FMessageDialog::Open(EAppMsgType::YesNo, Message) == EAppReturnType::Yes)
+    {
+        FAnimBPDeadNodeEliminator::RemoveDeadNodes(Blueprint, DeadNodes);
+    }
+}
+
+void FAnimBPToolModule::ProfileCompile() const
+{
+    if(!AnimBPEditorPtr.IsValid()) return;
+    auto Blueprint = AnimBPEditorPtr.Pin()->GetBlueprintObj();
+    auto Profile = MakeShared<FAnimBPCompileProfile>();
+    FAnimBPCompileProfiler::Profile(Blueprint, *Profile);
+
+    // Phase timings as the compiler reports them
+    FMessageLog MessageLog(MessageLogName);
+    MessageLog.NewPage(FText::Format(LOCTEXT("CompileProfilePage", "Compile Profile: {0}"),
+                                     FText::FromString(Blueprint->GetName())));
+    for (auto const& Event : Profile->CompilerEvents)
+    {
+        MessageLog.Info(FText::FromString(Event));
+    }
+
+    FSlateApplication::Get().AddWindow(
+        SNew(SWindow)
+        .Title(FText::Format(LOCTEXT("CompileProfileTitle", "Compile Profile - {0}"),
+                             FText::FromString(Blueprint->GetName())))
+        .ClientSize(FVector2D(900, 600))
+        [
+            SNew(SAnimBPCompileProfileView)
+            .Profile(Profile)
+        ]);
+}
+
+void FAnimBPToolModule::ProfileRuntime() const
+{
+    if(!AnimBPEditorPtr.IsValid()) return;
+    auto AnimBlueprint = Cast<UAnimBlueprint>(AnimBPEditorPtr.Pin()->GetBlueprintObj());
+    FAnimBPRuntimeProfile Profile;
+    if (!FAnimBPRuntimeProfiler::Profile(AnimBlueprint, FAnimBPRuntimeProfileOptions(), Profile))
     {
-        if (Node && Node->IsA<UK2Node_BreakStruct>())
-        {
-            const auto Node_BreakStruct = Cast<UK2Node_BreakStruct>(Node);
-            bool bWasChanged = false;
-            for (auto& PropertyPin : Node_BreakStruct->ShowPinForProperties)
-            {
-                const auto NodePin = Node_BreakStruct->FindPin(
-                    PropertyPin.PropertyName.ToString(), EGPD_Output);
-                if (NodePin && NodePin->LinkedTo.Num() <= 0)
-                {
-                    bWasChanged = true;
-                    PropertyPin.bShowPin = false;
-                    NodePin->SetSavePinIfOrphaned(false);
-                }
-            }
-            // Node_BreakStruct->Modify();
-            if(bWasChanged) 
-                Node_BreakStruct->ReconstructNode();
-            // Node_BreakStruct->Modify();
-        }
+        FMessageDialog::Open(EAppMsgType::Ok, LOCTEXT("ProfileRuntimeError",
+                                                      "Fail to profile, compile the blueprint and set a preview mesh"));
+        return;
     }
-    GEditor->EndTransaction();
-    // auto SelectedNodes = AnimationBlueprintEditor->GetSelectedNodes();
-    // for (auto Node : SelectedNodes)
-    // {
-    //     UE_LOG(LogTemp, Log, TEXT("Select Node %s.%s"), *Node->GetName(), *Node->GetDesc());
-    // }
+    FAnimBPRuntimeProfiler::ApplyGraphOverlay(Profile);
+    FAnimBPRuntimeProfiler::WriteReport(FAnimBPCompileProfiler::GetDefaultReportDirectory(), Profile);
+
+    FMessageLog MessageLog(MessageLogName);
+    MessageLog.NewPage(FText::Format(LOCTEXT("RuntimeProfilePage", "Runtime Profile: {0}"),
+                                     FText::FromString(AnimBlueprint->GetName())));
+    const double MsPerFrame = 1000.0 / FMath::Max(Profile.NumFrames, 1);
+    for (auto const& Cost : Profile.Nodes)
+    {
+        MessageLog.Info(FText::Format(LOCTEXT("RuntimeProfileNode", "{0} ({1}): update {2} ms, evaluate {3} ms"),
+                                      FText::FromString(Cost.NodeName), FText::FromString(Cost.GraphName),
+                                      FText::AsNumber(Cost.UpdateSelfSeconds * MsPerFrame),
+                                      FText::AsNumber(Cost.EvaluateSelfSeconds * MsPerFrame)));
+    }
+    MessageLog.Info(FText::Format(
+        LOCTEXT("RuntimeProfileSummary", "{0} frames, tick {1} ms and refresh {2} ms per frame"), Profile.NumFrames,
+        FText::AsNumber(Profile.TickSeconds * MsPerFrame), FText::AsNumber(Profile.RefreshSeconds * MsPerFrame)));
+    MessageLog.Open(EMessageSeverity::Info, true);
+}
+
+void FAnimBPToolModule::OpenComplexityReport() const
+{
+    FGlobalTabmanager::Get()->TryInvokeTab(AnimBPToolTabName);
+}
+
+TSharedRef<SDockTab> FAnimBPToolModule::OnSpawnComplexityReportTab(const FSpawnTabArgs& SpawnTabArgs)
+{
+    return SNew(SDockTab)
+        .TabRole(ETabRole::NomadTab)
+        [
+            SNew(SAnimBPComplexityReport)
+        ];
 }
 
 
@@ -138,6 +343,14 @@ void FAnimBPToolModule::ShutdownModule()
     // This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
     // we call this function before unloading the module.
     RemoveAnimationBlueprintEditorToolbarExtender();
+    FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(AnimBPToolTabName);
+    FAnimBPComplexityTags::Unregister();
+    FAnimBPRuntimeProfiler::Unregister();
+    if (FModuleManager::Get().IsModuleLoaded("MessageLog"))
+    {
+        FMessageLogModule& MessageLogModule = FModuleManager::GetModuleChecked<FMessageLogModule>("MessageLog");
+        MessageLogModule.UnregisterLogListing(MessageLogName);
+    }
     FAnimBPToolStyle::Shutdown();
     FAnimBPToolCommands::Unregister();
 }
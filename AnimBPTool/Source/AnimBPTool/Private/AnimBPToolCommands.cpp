@@ -7,7 +7,14 @@
 void FAnimBPToolCommands::RegisterCommands()
 {
 	// UI_COMMAND(PluginAction, "AnimBPTool", "Execute AnimBPTool action", EUserInterfaceActionType::Button, FInputChord());
-	UI_COMMAND(HidePins, "HideUnconnectedPins", "Hide All Unconnected Pins for K2Node_BreakStruct", EUserInterfaceActionType::Button, FInputChord())
+	UI_COMMAND(HidePins, "HideUnconnectedPins", "Hide All Unconnected Pins for struct break and class defaults nodes in the whole blueprint", EUserInterfaceActionType::Button, FInputChord())
+	UI_COMMAND(AuditFastPath, "AuditFastPath", "List anim node bindings that are off the fast path", EUserInterfaceActionType::Button, FInputChord())
+	UI_COMMAND(ConvertFastPath, "ConvertFastPath", "Rewrite native struct breaks of member variables so their bindings take the fast path", EUserInterfaceActionType::Button, FInputChord())
+	UI_COMMAND(MergeNodes, "MergeDuplicateNodes", "Merge struct break and class defaults nodes that read the same value in the same graph", EUserInterfaceActionType::Button, FInputChord())
+	UI_COMMAND(RemoveDeadNodes, "RemoveDeadNodes", "Remove nodes no event or result reaches, impure and anim nodes included, and unconnected orphaned pins in the whole blueprint", EUserInterfaceActionType::Button, FInputChord())
+	UI_COMMAND(ProfileCompile, "ProfileCompile", "Compile the blueprint with detailed timing and show the heaviest graphs and nodes", EUserInterfaceActionType::Button, FInputChord())
+	UI_COMMAND(ComplexityReport, "ComplexityReport", "Rank every Animation Blueprint by the complexity tags saved with it", EUserInterfaceActionType::Button, FInputChord())
+	UI_COMMAND(ProfileRuntime, "ProfileRuntime", "Run the blueprint on its preview mesh and time every anim node", EUserInterfaceActionType::Button, FInputChord())
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -47,6 +47,13 @@ TSharedRef< FSlateStyleSet > FAnimBPToolStyle::Create()
 	Style->SetContentRoot(IPluginManager::Get().FindPlugin("AnimBPTool")->GetBaseDir() / TEXT("Resources"));
 
 	Style->Set("AnimBPTool.HidePins", new IMAGE_BRUSH(TEXT("ButtonIcon_40x"), Icon40x40));
+	Style->Set("AnimBPTool.AuditFastPath", new IMAGE_BRUSH(TEXT("ButtonIcon_40x"), Icon40x40));
+	Style->Set("AnimBPTool.ConvertFastPath", new IMAGE_BRUSH(TEXT("ButtonIcon_40x"), Icon40x40));
+	Style->Set("AnimBPTool.MergeNodes", new IMAGE_BRUSH(TEXT("ButtonIcon_40x"), Icon40x40));
+	Style->Set("AnimBPTool.RemoveDeadNodes", new IMAGE_BRUSH(TEXT("ButtonIcon_40x"), Icon40x40));
+	Style->Set("AnimBPTool.ProfileCompile", new IMAGE_BRUSH(TEXT("ButtonIcon_40x"), Icon40x40));
+	Style->Set("AnimBPTool.ComplexityReport", new IMAGE_BRUSH(TEXT("ButtonIcon_40x"), Icon40x40));
+	Style->Set("AnimBPTool.ProfileRuntime", new IMAGE_BRUSH(TEXT("ButtonIcon_40x"), Icon40x40));
 
 	return Style;
 }
@@ -0,0 +1,95 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "AnimBPProfileCommandlet.h"
+
+#include "AnimBPCompileProfiler.h"
+#include "AnimBPRuntimeProfiler.h"
+#include "AssetRegistryModule.h"
+#include "Animation/AnimBlueprint.h"
+#include "Engine/SkeletalMesh.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimBPProfileCommandlet, Log, All);
+
+UAnimBPProfileCommandlet::UAnimBPProfileCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+    ShowErrorCount = true;
+}
+
+int32 UAnimBPProfileCommandlet::Main(const FString& Params)
+{
+    FAnimBPRuntimeProfileOptions Options;
+    FParse::Value(*Params, TEXT("Frames="), Options.NumFrames);
+    FParse::Value(*Params, TEXT("DeltaTime="), Options.DeltaTime);
+    Options.bSweepInputs = !FParse::Param(*Params, TEXT("NoSweep"));
+    FString MeshPath;
+    if (FParse::Value(*Params, TEXT("Mesh="), MeshPath))
+    {
+        Options.Mesh = LoadObject<USkeletalMesh>(nullptr, *MeshPath);
+        if (!Options.Mesh)
+        {
+            UE_LOG(LogAnimBPProfileCommandlet, Error, TEXT("Load Failed from %s"), *MeshPath);
+            return 1;
+        }
+    }
+    FString ReportDir = FAnimBPCompileProfiler::GetDefaultReportDirectory();
+    FParse::Value(*Params, TEXT("ReportDir="), ReportDir);
+
+    TArray<FSoftObjectPath> BlueprintPaths;
+    FString BlueprintPath, SearchPath;
+    if (FParse::Value(*Params, TEXT("Blueprint="), BlueprintPath))
+    {
+        BlueprintPaths.Add(BlueprintPath.Contains(TEXT("."))
+                               ? BlueprintPath
+                               : BlueprintPath + TEXT(".") + FPackageName::GetShortName(BlueprintPath));
+    }
+    else if (FParse::Value(*Params, TEXT("SearchPath="), SearchPath))
+    {
+        FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(
+            "AssetRegistry");
+        AssetRegistryModule.Get().SearchAllAssets(true);
+        FARFilter Filter;
+        Filter.PackagePaths.Add(*SearchPath);
+        Filter.ClassNames.Add(UAnimBlueprint::StaticClass()->GetFName());
+        Filter.bRecursivePaths = true;
+        TArray<FAssetData> AssetDatas;
+        AssetRegistryModule.Get().GetAssets(Filter, AssetDatas);
+        for (auto const& AssetData : AssetDatas)
+        {
+            BlueprintPaths.Add(AssetData.ToSoftObjectPath());
+        }
+    }
+    else
+    {
+        UE_LOG(LogAnimBPProfileCommandlet, Error, TEXT("Pass -Blueprint=<path> or -SearchPath=<path>"));
+        return 1;
+    }
+
+    int32 NumFailed = 0;
+    for (auto const& Path : BlueprintPaths)
+    {
+        auto AnimBlueprint = Cast<UAnimBlueprint>(Path.TryLoad());
+        FAnimBPRuntimeProfile Profile;
+        if (!AnimBlueprint || !FAnimBPRuntimeProfiler::Profile(AnimBlueprint, Options, Profile)
+            || !FAnimBPRuntimeProfiler::WriteReport(ReportDir, Profile))
+        {
+            UE_LOG(LogAnimBPProfileCommandlet, Error, TEXT("Fail to profile %s"), *Path.ToString());
+            ++NumFailed;
+            continue;
+        }
+        for (int32 i = 0; i < FMath::Min(Profile.Nodes.Num(), 5); ++i)
+        {
+            auto const& Cost = Profile.Nodes[i];
+            UE_LOG(LogAnimBPProfileCommandlet, Display, TEXT("  %-48s %8.4f ms/frame  (%s)"), *Cost.NodeName,
+                   Cost.SelfSeconds() * 1000.0 / FMath::Max(Profile.NumFrames, 1), *Cost.GraphName);
+        }
+        CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+    }
+
+    UE_LOG(LogAnimBPProfileCommandlet, Display, TEXT("Profiled %d of %d Animation Blueprints"),
+           BlueprintPaths.Num() - NumFailed, BlueprintPaths.Num());
+    return NumFailed > 0 ? 1 : 0;
+}
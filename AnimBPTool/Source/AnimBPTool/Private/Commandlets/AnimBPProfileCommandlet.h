@@ -0,0 +1,27 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "AnimBPProfileCommandlet.generated.h"
+
+/*
+ * Times every anim node of Animation Blueprints without an editor window, e.g.
+ *   -run=AnimBPProfile -nullrhi -Blueprint=/Game/Characters/ABP_Hero [-Frames=300] [-DeltaTime=0.0333]
+ *                      [-Mesh=/Game/Characters/SK_Hero] [-NoSweep] [-ReportDir=<dir>]
+ *   -run=AnimBPProfile -nullrhi -SearchPath=/Game/Characters
+ * Writes RuntimeProfile_<Blueprint>_<Timestamp>.csv per blueprint, defaults to Saved/AnimBPTool/Reports.
+ * Returns 1 if any blueprint could not be profiled.
+ */
+UCLASS()
+class UAnimBPProfileCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UAnimBPProfileCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,127 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "AnimBPPruneCommandlet.h"
+
+#include "AnimBPPinPruner.h"
+#include "AssetRegistryModule.h"
+#include "FileHelpers.h"
+#include "Animation/AnimBlueprint.h"
+#include "Kismet2/KismetEditorUtilities.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimBPPruneCommandlet, Log, All);
+
+namespace
+{
+    // Blueprints hold on to a lot, collect every so often
+    constexpr int32 BlueprintsPerGarbageCollection = 32;
+
+    struct FPruneRecord
+    {
+        FString BlueprintPath;
+        FAnimBPPruneStats Stats;
+        double CompileSeconds = 0.0;
+        bool bCompiled = false;
+        bool bSaved = false;
+        bool bFailed = false;
+    };
+}
+
+UAnimBPPruneCommandlet::UAnimBPPruneCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+    ShowErrorCount = true;
+}
+
+int32 UAnimBPPruneCommandlet::Main(const FString& Params)
+{
+    FString SearchPath = TEXT("/Game");
+    FParse::Value(*Params, TEXT("SearchPath="), SearchPath);
+    FString ReportDir = FPaths::ProjectSavedDir() / TEXT("AnimBPTool") / TEXT("Reports");
+    FParse::Value(*Params, TEXT("ReportDir="), ReportDir);
+    const bool bDryRun = FParse::Param(*Params, TEXT("DryRun"));
+
+    FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(
+        "AssetRegistry");
+    AssetRegistryModule.Get().SearchAllAssets(true);
+
+    FARFilter Filter;
+    Filter.PackagePaths.Add(*SearchPath);
+    Filter.ClassNames.Add(UAnimBlueprint::StaticClass()->GetFName());
+    Filter.bRecursivePaths = true;
+    TArray<FAssetData> AssetDatas;
+    AssetRegistryModule.Get().GetAssets(Filter, AssetDatas);
+    UE_LOG(LogAnimBPPruneCommandlet, Display, TEXT("Pruning %d Animation Blueprints under %s%s"), AssetDatas.Num(),
+           *SearchPath, bDryRun ? TEXT(" (dry run)") : TEXT(""));
+
+    TArray<FPruneRecord> Records;
+    int32 NumFailed = 0;
+    for (int32 i = 0; i < AssetDatas.Num(); ++i)
+    {
+        auto& Record = Records.AddDefaulted_GetRef();
+        Record.BlueprintPath = AssetDatas[i].ObjectPath.ToString();
+        auto Blueprint = Cast<UAnimBlueprint>(AssetDatas[i].GetAsset());
+        if (!Blueprint)
+        {
+            UE_LOG(LogAnimBPPruneCommandlet, Warning, TEXT("Load Failed from %s"), *Record.BlueprintPath);
+            Record.bFailed = true;
+            ++NumFailed;
+            continue;
+        }
+
+        // Unchanged blueprints are neither compiled nor saved, a dry run only counts
+        if (FAnimBPPinPruner::PruneBlueprint(Blueprint, &Record.Stats, !bDryRun) && !bDryRun)
+        {
+            const double StartTime = FPlatformTime::Seconds();
+            FKismetEditorUtilities::CompileBlueprint(Blueprint, EBlueprintCompileOptions::SkipGarbageCollection);
+            Record.CompileSeconds = FPlatformTime::Seconds() - StartTime;
+            Record.bCompiled = true;
+            if (Blueprint->Status == BS_Error)
+            {
+                UE_LOG(LogAnimBPPruneCommandlet, Error, TEXT("[%s] fails to compile after pruning, not saved"),
+                       *Record.BlueprintPath);
+                Record.bFailed = true;
+            }
+            else
+            {
+                Record.bSaved = UEditorLoadingAndSavingUtils::SavePackages({Blueprint->GetOutermost()}, false);
+                Record.bFailed = !Record.bSaved;
+            }
+            NumFailed += Record.bFailed ? 1 : 0;
+        }
+
+        if ((i + 1) % BlueprintsPerGarbageCollection == 0)
+        {
+            CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+        }
+    }
+
+    FString CsvString = TEXT("Blueprint,Graphs,NodesChanged,PinsHidden,PinsBefore,PinsAfter,CompileMs,Result")
+        LINE_TERMINATOR;
+    int32 NumChanged = 0;
+    for (auto const& Record : Records)
+    {
+        NumChanged += Record.Stats.NumNodesChanged > 0 ? 1 : 0;
+        const TCHAR* Result = Record.bFailed ? TEXT("Failed")
+                              : Record.bSaved ? TEXT("Saved")
+                              : Record.Stats.NumNodesChanged > 0 ? TEXT("Changed")
+                              : TEXT("Unchanged");
+        CsvString += FString::Printf(TEXT("\"%s\",%d,%d,%d,%d,%d,%.1f,%s") LINE_TERMINATOR, *Record.BlueprintPath,
+                                     Record.Stats.NumGraphs, Record.Stats.NumNodesChanged, Record.Stats.NumPinsHidden,
+                                     Record.Stats.PinsBefore, Record.Stats.PinsAfter, Record.CompileSeconds * 1000.0,
+                                     Result);
+    }
+    const FString CsvPath = ReportDir / FString::Printf(TEXT("AnimBPPrune_%s.csv"), *FDateTime::Now().ToString());
+    if (!FFileHelper::SaveStringToFile(CsvString, *CsvPath))
+    {
+        UE_LOG(LogAnimBPPruneCommandlet, Error, TEXT("Fail to write %s"), *CsvPath);
+    }
+
+    UE_LOG(LogAnimBPPruneCommandlet, Display, TEXT("%d of %d Animation Blueprints changed, %d failed, report %s"),
+           NumChanged, Records.Num(), NumFailed, *CsvPath);
+    return NumFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,26 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "AnimBPPruneCommandlet.generated.h"
+
+/*
+ * Prunes unconnected pins of every Animation Blueprint under a content path, compiles and resaves only the
+ * blueprints that changed, e.g.
+ *   -run=AnimBPPrune -SearchPath=/Game/Characters [-DryRun] [-ReportDir=<dir>]
+ * Writes AnimBPPrune_<Timestamp>.csv with pin counts before and after and compile times, defaults to
+ * Saved/AnimBPTool/Reports. Returns 1 if a changed blueprint fails to compile or save.
+ */
+UCLASS()
+class UAnimBPPruneCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UAnimBPPruneCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -23,7 +23,26 @@ public:
     /** This function will be bound to Command. */
     void HideUnconnectedPins() const;
 
+    void AuditFastPath() const;
+
+    void ConvertToFastPath() const;
+
+    void MergeDuplicateNodes() const;
+
+    void RemoveDeadNodes() const;
+
+    void ProfileCompile() const;
+
+    void OpenComplexityReport() const;
+
+    void ProfileRuntime() const;
+
+    /** Listing for graph diagnostics of the tool actions */
+    static const FName MessageLogName;
+
 private:
+    TSharedRef<class SDockTab> OnSpawnComplexityReportTab(const class FSpawnTabArgs& SpawnTabArgs);
+
     void AddToolbarExtension(FToolBarBuilder& Builder);
     TSharedRef<FExtender> GetAnimationBlueprintEditorToolbarExtender(
         const TSharedRef<FUICommandList> CommandList, TSharedRef<IAnimationBlueprintEditor> InAnimationBlueprintEditor);
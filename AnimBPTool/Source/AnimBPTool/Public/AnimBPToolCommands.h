@@ -21,4 +21,11 @@ public:
 public:
 	// TSharedPtr< FUICommandInfo > PluginAction;
 	TSharedPtr< FUICommandInfo > HidePins;
+	TSharedPtr< FUICommandInfo > AuditFastPath;
+	TSharedPtr< FUICommandInfo > ConvertFastPath;
+	TSharedPtr< FUICommandInfo > MergeNodes;
+	TSharedPtr< FUICommandInfo > RemoveDeadNodes;
+	TSharedPtr< FUICommandInfo > ProfileCompile;
+	TSharedPtr< FUICommandInfo > ComplexityReport;
+	TSharedPtr< FUICommandInfo > ProfileRuntime;
 };
@@ -48,7 +48,9 @@ public class AnimCurveTool : ModuleRules
 				"AnimationModifiers",
 				"EditorStyle",
 				"AnimationBlueprintEditor",
-				"DesktopPlatform"
+				"DesktopPlatform",
+				"ContentBrowser",
+				"AnimCurveToolRuntime"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
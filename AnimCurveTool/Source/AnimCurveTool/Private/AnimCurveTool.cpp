@@ -8,6 +8,8 @@
 #include "Framework/MultiBox/MultiBoxBuilder.h"
 #include "UI/AnimCurveToolWidget.h"
 #include "UI/AnimRuleCustomization.h"
+#include "Util/AnimAnalysisTags.h"
+#include "Util/AnimFootstepAutoMarker.h"
 
 static const FName AnimCurveToolTabName("AnimCurveTool");
 
@@ -60,6 +62,9 @@ void FAnimCurveToolModule::StartupModule()
                                                     FOnGetPropertyTypeCustomizationInstance::CreateStatic(
                                                         &FAnimRuleCustomization::MakeInstance)
     );
+
+    FAnimAnalysisTags::Register();
+    FAnimFootstepAutoMarker::Register();
 }
 
 
@@ -67,6 +72,9 @@ void FAnimCurveToolModule::ShutdownModule()
 {
     // This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
     // we call this function before unloading the module.
+    FAnimFootstepAutoMarker::Unregister();
+    FAnimAnalysisTags::Unregister();
+
     FAnimCurveToolStyle::Shutdown();
 
     FAnimCurveToolCommands::Unregister();
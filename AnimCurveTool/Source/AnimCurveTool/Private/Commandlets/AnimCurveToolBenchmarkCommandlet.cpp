@@ -0,0 +1,244 @@
+﻿#include "AnimCurveToolBenchmarkCommandlet.h"
+
+#include "Animation/AnimSequence.h"
+#include "AssetRegistryModule.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "PackageTools.h"
+#include "Serialization/JsonSerializer.h"
+#include "Util/AnimBatchReport.h"
+#include "Util/AnimBatchUtils.h"
+#include "Util/AnimCurveUtils.h"
+#include "Util/AnimSyntheticSequences.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimCurveToolBenchmark, Log, All);
+
+namespace
+{
+    // Best and mean seconds of Iterations runs
+    TSharedRef<FJsonObject> TimeIt(int32 Iterations, TFunctionRef<void()> Body)
+    {
+        double Best = TNumericLimits<double>::Max(), Total = 0.0;
+        for (int32 i = 0; i < Iterations; ++i)
+        {
+            const double Start = FPlatformTime::Seconds();
+            Body();
+            const double Elapsed = FPlatformTime::Seconds() - Start;
+            Best = FMath::Min(Best, Elapsed);
+            Total += Elapsed;
+        }
+        auto JsonObj = MakeShared<FJsonObject>();
+        JsonObj->SetNumberField(TEXT("Best"), Best);
+        JsonObj->SetNumberField(TEXT("Mean"), Total / Iterations);
+        return JsonObj;
+    }
+
+    void ParseIntList(const FString& Params, const TCHAR* Key, TArray<int32>& InOutValues)
+    {
+        FString Value;
+        if (FParse::Value(*Params, Key, Value))
+        {
+            TArray<FString> Items;
+            Value.ParseIntoArray(Items, TEXT(","));
+            InOutValues.Reset();
+            for (auto const& Item : Items)
+            {
+                InOutValues.Add(FMath::Max(FCString::Atoi(*Item), 1));
+            }
+        }
+    }
+}
+
+UAnimCurveToolBenchmarkCommandlet::UAnimCurveToolBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UAnimCurveToolBenchmarkCommandlet::Main(const FString& Params)
+{
+    TArray<int32> FrameCounts = {2, 30, 300, 3000, 20000};
+    TArray<int32> Depths = {4, 16, 64};
+    ParseIntList(Params, TEXT("Frames="), FrameCounts);
+    ParseIntList(Params, TEXT("Depth="), Depths);
+    int32 Iterations = 3, Seed = 1, Tolerance = 1, ListSize = 10000;
+    float Noise = 0.0f, MinRecall = 0.95f;
+    FParse::Value(*Params, TEXT("Iterations="), Iterations);
+    FParse::Value(*Params, TEXT("Seed="), Seed);
+    FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+    FParse::Value(*Params, TEXT("ListSize="), ListSize);
+    FParse::Value(*Params, TEXT("Noise="), Noise);
+    FParse::Value(*Params, TEXT("MinRecall="), MinRecall);
+    Iterations = FMath::Max(Iterations, 1);
+    const bool bSave = !FParse::Param(*Params, TEXT("NoSave"));
+    FString ReportDir = FPaths::ProjectSavedDir() / TEXT("AnimCurveTool") / TEXT("Benchmarks");
+    FParse::Value(*Params, TEXT("ReportDir="), ReportDir);
+    // Curve assets need a mounted content path, they are deleted once the run is over
+    const auto ScratchDir = FPaths::ProjectContentDir() / TEXT("__AnimCurveToolBenchmark");
+
+    FRandomStream Random(Seed);
+    FAnimBatchReport Report(TEXT("Benchmark"));
+    TArray<TSharedPtr<FJsonValue>> CaseValues;
+    bool bAccurate = true;
+
+    for (auto NumFrames : FrameCounts)
+    {
+        for (auto Depth : Depths)
+        {
+            const FAnimSyntheticSequences::FCase Case{FMath::Max(NumFrames, 2), Depth};
+            auto Synthetic = FAnimSyntheticSequences::Make(Case, Noise, Random);
+            auto Seq = Synthetic.Seq;
+            FAnimBatchReport::FSequenceScope SequenceScope(&Report, Seq->GetName());
+
+            auto CaseObj = MakeShared<FJsonObject>();
+            CaseObj->SetNumberField(TEXT("Frames"), Case.NumFrames);
+            CaseObj->SetNumberField(TEXT("Depth"), Case.Depth);
+
+            TArray<FVector> PosKeys;
+            TArray<FQuat> RotKeys;
+            CaseObj->SetObjectField(TEXT("GetBoneKeysByNameHelper"), TimeIt(Iterations, [&]()
+            {
+                FAnimCurveUtils::GetBoneKeysByNameHelper(Seq, TEXT("LeftHand"), PosKeys, RotKeys, true);
+            }));
+            CaseObj->SetObjectField(TEXT("GetBoneKeysByNameHelperFrameParallel"), TimeIt(Iterations, [&]()
+            {
+                FAnimCurveUtils::FFrameParallelScope FrameParallelScope(1);
+                FAnimCurveUtils::GetBoneKeysByNameHelper(Seq, TEXT("LeftHand"), PosKeys, RotKeys, true);
+            }));
+            if (bSave)
+            {
+                CaseObj->SetObjectField(TEXT("SaveBonesCurves"), TimeIt(Iterations, [&]()
+                {
+                    FAnimCurveUtils::SaveBonesCurves(Seq, TEXT("LeftHand"), ScratchDir, 0xff);
+                }));
+            }
+            TArray<FAnimCurveUtils::FFootstepMarker> Markers;
+            CaseObj->SetObjectField(TEXT("CaptureLocalMinimaMarksByBoneName"), TimeIt(Iterations, [&]()
+            {
+                Markers.Reset();
+                FAnimCurveUtils::CaptureLocalMinimaMarksByBoneName(Seq, TEXT("LeftHand"), Markers, false);
+            }));
+            CaseObj->SetObjectField(TEXT("MarkFootstepsFor1PAnimation"), TimeIt(Iterations, [&]()
+            {
+                FAnimCurveUtils::MarkFootstepsFor1PAnimation(Seq, {TEXT("LeftHand"), TEXT("RightHand")});
+            }));
+
+            // A loop shorter than a few frames per step has no well defined minima
+            if (Case.NumFrames >= 8)
+            {
+                const int32 Matched = FAnimSyntheticSequences::CountMatchedSteps(Synthetic.StepFrames, Markers,
+                                                                                 Case.NumFrames - 1, Tolerance);
+                const float Recall = static_cast<float>(Matched) / Synthetic.StepFrames.Num();
+                const float Precision = Markers.Num() ? static_cast<float>(Matched) / Markers.Num() : 0.0f;
+                CaseObj->SetNumberField(TEXT("Steps"), Synthetic.StepFrames.Num());
+                CaseObj->SetNumberField(TEXT("Detected"), Markers.Num());
+                CaseObj->SetNumberField(TEXT("Recall"), Recall);
+                CaseObj->SetNumberField(TEXT("Precision"), Precision);
+                if (Recall < MinRecall)
+                {
+                    UE_LOG(LogAnimCurveToolBenchmark, Error, TEXT("[%s] recall %.3f below %.3f (%d/%d steps)"),
+                           *Seq->GetName(), Recall, MinRecall, Matched, Synthetic.StepFrames.Num());
+                    bAccurate = false;
+                }
+            }
+
+            auto Best = [&CaseObj](const TCHAR* Field)
+            {
+                return CaseObj->GetObjectField(Field)->GetNumberField(TEXT("Best"));
+            };
+            UE_LOG(LogAnimCurveToolBenchmark, Display,
+                   TEXT("[%s] keys %.4fs (frame-parallel %.4fs), minima %.4fs, footsteps %.4fs"),
+                   *Seq->GetName(), Best(TEXT("GetBoneKeysByNameHelper")),
+                   Best(TEXT("GetBoneKeysByNameHelperFrameParallel")),
+                   Best(TEXT("CaptureLocalMinimaMarksByBoneName")), Best(TEXT("MarkFootstepsFor1PAnimation")));
+            CaseValues.Push(MakeShared<FJsonValueObject>(CaseObj));
+
+            Seq->MarkPendingKill();
+            CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+        }
+    }
+
+    // The Generate Json / Load From Json list format
+    auto ListObj = MakeShared<FJsonObject>();
+    {
+        TArray<FString> Paths, LoadedPaths;
+        for (int32 i = 0; i < ListSize; ++i)
+        {
+            Paths.Add(FString::Printf(TEXT("/Game/Animations/Bench/Bench_%05d.Bench_%05d"), i, i));
+        }
+        const auto ListPath = FPaths::ProjectIntermediateDir() / TEXT("AnimCurveTool") / TEXT("BenchmarkList.json");
+        ListObj->SetNumberField(TEXT("Sequences"), ListSize);
+        ListObj->SetObjectField(TEXT("SaveSequenceList"), TimeIt(Iterations, [&]()
+        {
+            FAnimBatchUtils::SaveSequenceList(ListPath, Paths);
+        }));
+        ListObj->SetObjectField(TEXT("LoadSequenceList"), TimeIt(Iterations, [&]()
+        {
+            LoadedPaths.Reset();
+            FAnimBatchUtils::LoadSequenceList(ListPath, LoadedPaths);
+        }));
+        if (LoadedPaths != Paths)
+        {
+            UE_LOG(LogAnimCurveToolBenchmark, Error, TEXT("Sequence list does not round trip, %d of %d loaded"),
+                   LoadedPaths.Num(), Paths.Num());
+            bAccurate = false;
+        }
+        IFileManager::Get().Delete(*ListPath, false, true, true);
+    }
+
+    if (bSave)
+    {
+        // Unregister and unload the curve packages first, a later run would find them as phantom assets
+        FString ScratchPackagePath;
+        if (FPackageName::TryConvertFilenameToLongPackageName(ScratchDir, ScratchPackagePath))
+        {
+            TArray<UPackage*> ScratchPackages;
+            for (TObjectIterator<UPackage> It; It; ++It)
+            {
+                if (It->GetName().StartsWith(ScratchPackagePath / TEXT("")))
+                {
+                    ScratchPackages.Add(*It);
+                }
+            }
+            for (auto Package : ScratchPackages)
+            {
+                ForEachObjectWithOuter(Package, [](UObject* Object)
+                {
+                    if (Object->IsAsset())
+                    {
+                        FAssetRegistryModule::AssetDeleted(Object);
+                    }
+                }, false);
+            }
+            UPackageTools::UnloadPackages(ScratchPackages);
+        }
+        IFileManager::Get().DeleteDirectory(*ScratchDir, false, true);
+    }
+
+    auto JsonObj = MakeShared<FJsonObject>();
+    JsonObj->SetNumberField(TEXT("Iterations"), Iterations);
+    JsonObj->SetNumberField(TEXT("Noise"), Noise);
+    JsonObj->SetNumberField(TEXT("Seed"), Seed);
+    JsonObj->SetArrayField(TEXT("Cases"), CaseValues);
+    JsonObj->SetObjectField(TEXT("SequenceList"), ListObj);
+
+    FString JsonString;
+    auto Writer = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&JsonString);
+    FJsonSerializer::Serialize(JsonObj, Writer);
+    const auto JsonPath = FPaths::ConvertRelativePathToFull(
+        ReportDir / FString::Printf(TEXT("Benchmark_%s.json"), *FDateTime::Now().ToString()));
+    if (!FFileHelper::SaveStringToFile(JsonString, *JsonPath))
+    {
+        UE_LOG(LogAnimCurveToolBenchmark, Error, TEXT("Fail to write benchmark %s"), *JsonPath);
+        return 1;
+    }
+    UE_LOG(LogAnimCurveToolBenchmark, Display, TEXT("Benchmark written to %s"), *JsonPath);
+    // Per-stage breakdown of the same runs
+    Report.Write(ReportDir);
+    return bAccurate ? 0 : 1;
+}
@@ -0,0 +1,26 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "AnimCurveToolBenchmarkCommandlet.generated.h"
+
+/*
+ * Times FAnimCurveUtils on procedurally generated walk-cycle sequences and checks footstep detection
+ * against the known step frames. Nothing is loaded from the project, so it runs headless, e.g.
+ *   -run=AnimCurveToolBenchmark -nullrhi -Frames=2,300,3000,20000 -Depth=4,32 -Iterations=3
+ * Options: -Noise=0.0 (cm) -Seed=1 -Tolerance=1 (frames) -ListSize=10000 -NoSave -MinRecall=0.95
+ *          -ReportDir=<dir>, defaults to Saved/AnimCurveTool/Benchmarks
+ * Returns 1 if any case detects less than MinRecall of the ground-truth steps. The pass/fail checks also run
+ * as the AnimCurveTool automation tests, this is the timing front end.
+ */
+UCLASS()
+class UAnimCurveToolBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UAnimCurveToolBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
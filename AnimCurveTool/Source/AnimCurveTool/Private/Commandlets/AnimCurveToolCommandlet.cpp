@@ -0,0 +1,267 @@
+﻿#include "AnimCurveToolCommandlet.h"
+
+#include "UI/AnimToolSettings.h"
+#include "Util/AnimBatchJournal.h"
+#include "Util/AnimBatchReport.h"
+#include "Util/AnimBatchUtils.h"
+#include "Util/AnimCompressionAudit.h"
+#include "Util/AnimMemoryAudit.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimCurveToolCommandlet, Log, All);
+
+UAnimCurveToolCommandlet::UAnimCurveToolCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+    ShowErrorCount = true;
+}
+
+FString UAnimCurveToolCommandlet::ApplySettingOverrides(const FString& Params)
+{
+    // Returns the overrides that were found, so a coordinator can forward them to its workers
+    FString Forwarded;
+    FString Value;
+    bool bValue = false;
+
+    const auto FootstepSetting = UFootstepSettings::Get();
+    if (FParse::Value(*Params, TEXT("KeyBones="), Value))
+    {
+        FootstepSetting->TrackBoneNames.Reset();
+        Value.ParseIntoArray(FootstepSetting->TrackBoneNames, TEXT(","));
+        Forwarded += FString::Printf(TEXT(" -KeyBones=%s"), *Value);
+    }
+    if (FParse::Bool(*Params, TEXT("UseCurve="), bValue))
+    {
+        // Older spelling of -FootstepOutput=Curve|Notifies
+        FootstepSetting->FootstepOutput = bValue ? EAnimFootstepOutput::Curve : EAnimFootstepOutput::Notifies;
+        Forwarded += FString::Printf(TEXT(" -UseCurve=%s"), bValue ? TEXT("true") : TEXT("false"));
+    }
+    if (FParse::Value(*Params, TEXT("FootstepOutput="), Value))
+    {
+        const int64 Output = StaticEnum<EAnimFootstepOutput>()->GetValueByNameString(Value);
+        if (Output != INDEX_NONE)
+        {
+            FootstepSetting->FootstepOutput = static_cast<EAnimFootstepOutput>(Output);
+            Forwarded += FString::Printf(TEXT(" -FootstepOutput=%s"), *Value);
+        }
+        else
+        {
+            UE_LOG(LogAnimCurveToolCommandlet, Warning, TEXT("Unknown -FootstepOutput=%s, expected Curve, Notifies or SyncMarkers"), *Value);
+        }
+    }
+    if (FParse::Bool(*Params, TEXT("Debug="), bValue))
+    {
+        FootstepSetting->IsEnableDebug = bValue;
+        Forwarded += FString::Printf(TEXT(" -Debug=%s"), bValue ? TEXT("true") : TEXT("false"));
+    }
+
+    const auto AnimCurveSetting = UAnimCurveSettings::Get();
+    if (FParse::Value(*Params, TEXT("TargetBone="), Value))
+    {
+        AnimCurveSetting->TargetBoneName = Value;
+        Forwarded += FString::Printf(TEXT(" -TargetBone=%s"), *Value);
+    }
+    if (FParse::Value(*Params, TEXT("ExportDir="), Value))
+    {
+        AnimCurveSetting->ExportDirectoryPath.Path = Value;
+        Forwarded += FString::Printf(TEXT(" -ExportDir=\"%s\""), *Value);
+    }
+
+    float FloatValue = 0.0f;
+    if (FParse::Value(*Params, TEXT("CurveTolerance="), FloatValue))
+    {
+        AnimCurveSetting->CurveOptimizeTolerance = FloatValue;
+        Forwarded += FString::Printf(TEXT(" -CurveTolerance=%f"), FloatValue);
+    }
+    if (FParse::Bool(*Params, TEXT("StripDebugCurves="), bValue))
+    {
+        AnimCurveSetting->bStripDebugCurves = bValue;
+        Forwarded += FString::Printf(TEXT(" -StripDebugCurves=%s"), bValue ? TEXT("true") : TEXT("false"));
+    }
+    if (FParse::Bool(*Params, TEXT("ReduceCurveKeys="), bValue))
+    {
+        AnimCurveSetting->bReduceCurveKeys = bValue;
+        Forwarded += FString::Printf(TEXT(" -ReduceCurveKeys=%s"), bValue ? TEXT("true") : TEXT("false"));
+    }
+    if (FParse::Bool(*Params, TEXT("RemoveDuplicateCurves="), bValue))
+    {
+        AnimCurveSetting->bRemoveDuplicateCurves = bValue;
+        Forwarded += FString::Printf(TEXT(" -RemoveDuplicateCurves=%s"), bValue ? TEXT("true") : TEXT("false"));
+    }
+
+    const auto CheckSetting = UAnimCheckSettings::Get();
+    if (FParse::Bool(*Params, TEXT("CheckCameraRoot="), bValue))
+    {
+        CheckSetting->bCheckIfCameraRootAtOrigin = bValue;
+        Forwarded += FString::Printf(TEXT(" -CheckCameraRoot=%s"), bValue ? TEXT("true") : TEXT("false"));
+    }
+    if (FParse::Bool(*Params, TEXT("CheckSingleFrame="), bValue))
+    {
+        CheckSetting->bCheckIfSingleFrameAnim = bValue;
+        Forwarded += FString::Printf(TEXT(" -CheckSingleFrame=%s"), bValue ? TEXT("true") : TEXT("false"));
+    }
+    if (FParse::Bool(*Params, TEXT("StampCheck="), bValue))
+    {
+        CheckSetting->bStampCheckResults = bValue;
+        Forwarded += FString::Printf(TEXT(" -StampCheck=%s"), bValue ? TEXT("true") : TEXT("false"));
+    }
+    if (FParse::Value(*Params, TEXT("AuditBones="), Value))
+    {
+        CheckSetting->CompressionAuditBones.Reset();
+        Value.ParseIntoArray(CheckSetting->CompressionAuditBones, TEXT(","));
+        Forwarded += FString::Printf(TEXT(" -AuditBones=%s"), *Value);
+    }
+    if (FParse::Value(*Params, TEXT("ErrorThreshold="), FloatValue))
+    {
+        CheckSetting->CompressionErrorThreshold = FloatValue;
+        Forwarded += FString::Printf(TEXT(" -ErrorThreshold=%f"), FloatValue);
+    }
+    if (FParse::Value(*Params, TEXT("RotationThreshold="), FloatValue))
+    {
+        CheckSetting->CompressionRotationThreshold = FloatValue;
+        Forwarded += FString::Printf(TEXT(" -RotationThreshold=%f"), FloatValue);
+    }
+
+    int32 IntValue = 0;
+    if (FParse::Value(*Params, TEXT("FrameParallelMinFrames="), IntValue))
+    {
+        UAnimBatchSettings::Get()->FrameParallelMinFrames = FMath::Max(IntValue, 0);
+        Forwarded += FString::Printf(TEXT(" -FrameParallelMinFrames=%d"), IntValue);
+    }
+    return Forwarded;
+}
+
+int32 UAnimCurveToolCommandlet::Main(const FString& Params)
+{
+    FString ReportDir = FAnimBatchReport::GetDefaultDirectory();
+    FParse::Value(*Params, TEXT("ReportDir="), ReportDir);
+
+    if (FParse::Param(*Params, TEXT("MemoryAudit")))
+    {
+        FString SearchPath = TEXT("/Game");
+        FParse::Value(*Params, TEXT("SearchPath="), SearchPath);
+        TArray<FAnimMemoryRecord> Records;
+        const auto JsonSetting = UAnimJsonSettings::Get();
+        FAnimMemoryAudit::Run(SearchPath, JsonSetting->AnimRuleFilters, JsonSetting->bEnableNameConventionFilter,
+                              FParse::Param(*Params, TEXT("Load")), Records);
+        return FAnimMemoryAudit::WriteReport(ReportDir, Records) ? 0 : 1;
+    }
+
+    if (FParse::Param(*Params, TEXT("CompressionAudit")))
+    {
+        FString AuditListPath;
+        TArray<FString> AuditPaths;
+        if (!FParse::Value(*Params, TEXT("List="), AuditListPath) ||
+            !FAnimBatchUtils::LoadSequenceList(AuditListPath, AuditPaths))
+        {
+            UE_LOG(LogAnimCurveToolCommandlet, Error, TEXT("Missing -List= or illegal Json file"));
+            return 1;
+        }
+        ApplySettingOverrides(Params);
+        const auto CheckSetting = UAnimCheckSettings::Get();
+        TArray<FAnimCompressionError> Errors;
+        FAnimCompressionAudit::Run(AuditPaths, CheckSetting->CompressionAuditBones, Errors);
+        const int32 NumOverThreshold = FAnimCompressionAudit::WriteReport(
+            ReportDir, Errors, CheckSetting->CompressionErrorThreshold, CheckSetting->CompressionRotationThreshold);
+        return NumOverThreshold == 0 ? 0 : 1;
+    }
+
+    FString OperationName, ListPath, ResultPath;
+    EAnimBatchOperation Operation;
+    if (!FParse::Value(*Params, TEXT("Op="), OperationName) ||
+        !FAnimBatchUtils::LexFromString(Operation, *OperationName))
+    {
+        UE_LOG(LogAnimCurveToolCommandlet, Error, TEXT("Missing or unknown -Op=, expect MarkFootsteps, ExtractCurves, CheckAnimation or OptimizeCurves"));
+        return 1;
+    }
+    if (!FParse::Value(*Params, TEXT("List="), ListPath) || !FParse::Value(*Params, TEXT("Result="), ResultPath))
+    {
+        UE_LOG(LogAnimCurveToolCommandlet, Error, TEXT("Missing -List= or -Result="));
+        return 1;
+    }
+
+    TArray<FString> SequencePaths;
+    if (!FAnimBatchUtils::LoadSequenceList(ListPath, SequencePaths))
+    {
+        UE_LOG(LogAnimCurveToolCommandlet, Error, TEXT("Load Json error from %s, file not found or illegal Json file"),
+               *ListPath);
+        return 1;
+    }
+
+    auto ForwardedParams = ApplySettingOverrides(Params);
+    const double StartTime = FPlatformTime::Seconds();
+    FAnimBatchResult Result;
+
+    const auto Options = FAnimBatchOptions::FromSettings();
+    const bool bResume = !FParse::Param(*Params, TEXT("NoResume"));
+    FString JournalPath;
+    const bool bHasJournal = FParse::Value(*Params, TEXT("Journal="), JournalPath);
+
+    int32 NumWorkers = 0;
+    if (FParse::Value(*Params, TEXT("Workers="), NumWorkers) && NumWorkers > 0)
+    {
+        if (bHasJournal)
+        {
+            UE_LOG(LogAnimCurveToolCommandlet, Error,
+                   TEXT("-Journal= is not supported with -Workers=, workers journal next to their shard lists"));
+            return 1;
+        }
+        int32 SaveWindowSize = 0;
+        if (FParse::Value(*Params, TEXT("SaveWindow="), SaveWindowSize))
+        {
+            ForwardedParams += FString::Printf(TEXT(" -SaveWindow=%d"), SaveWindowSize);
+        }
+        if (!bResume)
+        {
+            ForwardedParams += TEXT(" -NoResume");
+        }
+        if (FParse::Value(*Params, TEXT("ReportDir="), ReportDir))
+        {
+            ForwardedParams += FString::Printf(TEXT(" -ReportDir=\"%s\""), *ReportDir);
+        }
+        const bool bAllSucceeded = FAnimBatchUtils::RunShardedWorkers(Operation, SequencePaths, Options, NumWorkers,
+                                                                      bResume, ForwardedParams, Result);
+        if (!FAnimBatchUtils::SaveBatchResult(ResultPath, Result))
+        {
+            UE_LOG(LogAnimCurveToolCommandlet, Error, TEXT("Fail to write result %s"), *ResultPath);
+            return 1;
+        }
+        UE_LOG(LogAnimCurveToolCommandlet, Display, TEXT("%s: %d processed, %d errors by %d workers in %.1fs"),
+               FAnimBatchUtils::LexToString(Operation), Result.ProcessedSequences.Num(),
+               Result.ErrorSequences.Num(), NumWorkers, FPlatformTime::Seconds() - StartTime);
+        return bAllSucceeded ? 0 : 1;
+    }
+
+    TUniquePtr<FAnimBatchJournal> Journal;
+    if (bHasJournal)
+    {
+        Journal = MakeUnique<FAnimBatchJournal>(JournalPath,
+                                                FAnimBatchUtils::ComputeRunHash(Operation, SequencePaths, Options),
+                                                bResume);
+    }
+    int32 SaveWindowSize = 100;
+    FParse::Value(*Params, TEXT("SaveWindow="), SaveWindowSize);
+
+    // One report per worker, named after its result file
+    FAnimBatchReport Report(FString::Printf(TEXT("%s_%s"), FAnimBatchUtils::LexToString(Operation),
+                                            *FPaths::GetBaseFilename(ResultPath)));
+    FAnimBatchUtils::RunBatch(Operation, SequencePaths, Options, Journal.Get(),
+                              FMath::Max(SaveWindowSize, 1), Result, &Report);
+    if (Journal)
+    {
+        Journal->Finish();
+    }
+    Report.Write(ReportDir);
+
+    if (!FAnimBatchUtils::SaveBatchResult(ResultPath, Result))
+    {
+        UE_LOG(LogAnimCurveToolCommandlet, Error, TEXT("Fail to write result %s"), *ResultPath);
+        return 1;
+    }
+    UE_LOG(LogAnimCurveToolCommandlet, Display, TEXT("%s: %d processed, %d errors in %.1fs"),
+           FAnimBatchUtils::LexToString(Operation), Result.ProcessedSequences.Num(), Result.ErrorSequences.Num(),
+           FPlatformTime::Seconds() - StartTime);
+    return 0;
+}
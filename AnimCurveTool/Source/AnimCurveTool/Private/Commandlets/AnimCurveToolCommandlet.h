@@ -0,0 +1,38 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "AnimCurveToolCommandlet.generated.h"
+
+/*
+ * Headless batch runner, e.g.
+ *   Worker:      -run=AnimCurveTool -Op=MarkFootsteps -List=anim_list.json -Result=result.json
+ *   Coordinator: -run=AnimCurveTool -Op=MarkFootsteps -List=anim_list.json -Result=result.json -Workers=16
+ * Restart safety: -Journal=<path> [-NoResume] -SaveWindow=100, workers always journal next to their shard list,
+ *                 a coordinator rerun with the same list and options keeps the shards and resumes every worker
+ * Performance report: -ReportDir=<dir>, defaults to Saved/AnimCurveTool/Reports, one report per worker
+ * Memory audit:  -run=AnimCurveTool -MemoryAudit -SearchPath=/Game/Animations [-Load] [-ReportDir=<dir>]
+ * Compression audit: -run=AnimCurveTool -CompressionAudit -List=anim_list.json
+ *                    [-AuditBones=LeftHand,Camera_Root] [-ErrorThreshold=0.1] [-RotationThreshold=0.5],
+ *                    returns 1 if any is over
+ * Setting overrides: -KeyBones=LeftHand,RightHand -FootstepOutput=Curve|Notifies|SyncMarkers -Debug=false
+ *                    -TargetBone=LeftHand -ExportDir=<dir> -CheckCameraRoot=true -CheckSingleFrame=true
+ *                    -StampCheck=false (true stores check verdicts on the sequences, which saves them)
+ *                    -AuditBones=LeftHand,Camera_Root -ErrorThreshold=0.1 -RotationThreshold=0.5
+ *                    -CurveTolerance=0.001 -StripDebugCurves=true -ReduceCurveKeys=true -RemoveDuplicateCurves=false
+ *                    -FrameParallelMinFrames=10000 (0 keeps every sequence on one thread)
+ */
+UCLASS()
+class UAnimCurveToolCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UAnimCurveToolCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+
+private:
+    static FString ApplySettingOverrides(const FString& Params);
+};
@@ -0,0 +1,122 @@
+﻿#include "CoreMinimal.h"
+#include "Animation/AnimSequence.h"
+#include "HAL/FileManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "Util/AnimBatchUtils.h"
+#include "Util/AnimCurveUtils.h"
+#include "Util/AnimSyntheticSequences.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/*
+ * Headless checks on synthetic sequences, e.g.
+ *   UE4Editor-Cmd <project> -nullrhi -unattended -ExecCmds="Automation RunTests AnimCurveTool; Quit"
+ * Timings of the same cases come from -run=AnimCurveToolBenchmark.
+ */
+namespace
+{
+    constexpr uint32 AnimCurveToolTestFlags = EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter;
+    // Frames off the ground-truth step still counted as found
+    constexpr int32 StepTolerance = 1;
+    constexpr float MinRecall = 0.95f;
+    constexpr float MinPrecision = 0.95f;
+
+    bool ParseIntPair(const FString& Parameters, int32& OutFirst, int32& OutSecond)
+    {
+        FString First, Second;
+        if (!Parameters.Split(TEXT(" "), &First, &Second))
+        {
+            return false;
+        }
+        OutFirst = FCString::Atoi(*First);
+        OutSecond = FCString::Atoi(*Second);
+        return true;
+    }
+}
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FAnimCurveToolFootstepTest, "AnimCurveTool.Footsteps", AnimCurveToolTestFlags)
+
+void FAnimCurveToolFootstepTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+    // Shorter loops than a few frames per step have no well defined minima
+    for (int32 NumFrames : {30, 300, 3000, 20000})
+    {
+        for (int32 Depth : {4, 32})
+        {
+            OutBeautifiedNames.Add(FString::Printf(TEXT("Frames%d_Depth%d"), NumFrames, Depth));
+            OutTestCommands.Add(FString::Printf(TEXT("%d %d"), NumFrames, Depth));
+        }
+    }
+}
+
+bool FAnimCurveToolFootstepTest::RunTest(const FString& Parameters)
+{
+    FAnimSyntheticSequences::FCase Case{0, 0};
+    if (!ParseIntPair(Parameters, Case.NumFrames, Case.Depth))
+    {
+        AddError(FString::Printf(TEXT("Expect \"Frames Depth\", got \"%s\""), *Parameters));
+        return false;
+    }
+
+    FRandomStream Random(1);
+    auto Synthetic = FAnimSyntheticSequences::Make(Case, 0.0f, Random);
+    TArray<FAnimCurveUtils::FFootstepMarker> Markers;
+    FAnimCurveUtils::CaptureLocalMinimaMarksByBoneName(Synthetic.Seq, TEXT("LeftHand"), Markers, false);
+
+    const int32 NumSteps = Synthetic.StepFrames.Num();
+    const int32 Matched = FAnimSyntheticSequences::CountMatchedSteps(Synthetic.StepFrames, Markers,
+                                                                     Case.NumFrames - 1, StepTolerance);
+    TestTrue(FString::Printf(TEXT("Recall, %d of %d steps found"), Matched, NumSteps),
+             Matched >= MinRecall * NumSteps);
+    TestTrue(FString::Printf(TEXT("Precision, %d of %d markers on a step"), Matched, Markers.Num()),
+             Markers.Num() > 0 && Matched >= MinPrecision * Markers.Num());
+
+    Synthetic.Seq->MarkPendingKill();
+    return true;
+}
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FAnimCurveToolSequenceListTest, "AnimCurveTool.SequenceList", AnimCurveToolTestFlags)
+
+void FAnimCurveToolSequenceListTest::GetTests(TArray<FString>& OutBeautifiedNames,
+                                              TArray<FString>& OutTestCommands) const
+{
+    for (int32 NumFrames : {30, 300, 3000, 20000})
+    {
+        for (int32 Depth : {4, 32})
+        {
+            OutBeautifiedNames.Add(FString::Printf(TEXT("Frames%d_Depth%d"), NumFrames, Depth));
+            OutTestCommands.Add(FString::Printf(TEXT("%d %d"), NumFrames, Depth));
+        }
+    }
+}
+
+bool FAnimCurveToolSequenceListTest::RunTest(const FString& Parameters)
+{
+    int32 NumFrames = 0, Depth = 0;
+    if (!ParseIntPair(Parameters, NumFrames, Depth))
+    {
+        AddError(FString::Printf(TEXT("Expect \"Frames Depth\", got \"%s\""), *Parameters));
+        return false;
+    }
+
+    // One entry per frame, in the package and object path forms Generate Json and the batch results use
+    TArray<FString> Paths, LoadedPaths;
+    for (int32 i = 0; i < NumFrames; ++i)
+    {
+        Paths.Add(i % 2
+                      ? FString::Printf(TEXT("/Game/Animations/Depth%d/Bench_%05d.Bench_%05d"), Depth, i, i)
+                      : FString::Printf(TEXT("/Game/Animations/Depth%d/Bench_%05d"), Depth, i));
+    }
+    const auto ListPath = FPaths::AutomationTransientDir() / Parameters.Replace(TEXT(" "), TEXT("_")) +
+        TEXT("_List.json");
+    TestTrue(TEXT("Save sequence list"), FAnimBatchUtils::SaveSequenceList(ListPath, Paths));
+    TestTrue(TEXT("Load sequence list"), FAnimBatchUtils::LoadSequenceList(ListPath, LoadedPaths));
+    TestEqual(TEXT("Sequences loaded back"), LoadedPaths.Num(), Paths.Num());
+    TestTrue(TEXT("Sequence list round trip"), LoadedPaths == Paths);
+    IFileManager::Get().Delete(*ListPath, false, true, true);
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
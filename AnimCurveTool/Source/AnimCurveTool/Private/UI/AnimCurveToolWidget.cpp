@@ -1,22 +1,29 @@
 ﻿#include "AnimCurveToolWidget.h"
 
 #include "AnimationBlueprintLibrary.h"
+#include "AssetRegistryModule.h"
+#include "Animation/Skeleton.h"
 #include "DesktopPlatformModule.h"
 #include "EditorDirectories.h"
 #include "PropertyEditing.h"
 #include "Modules/ModuleManager.h"
 #include "Widgets/Layout/SScrollBox.h"
 #include "Widgets/Input/SButton.h"
+#include "UI/AnimSequenceList.h"
+#include "Util/AnimAnalysisTags.h"
+#include "Util/AnimBatchJournal.h"
+#include "Util/AnimBatchReport.h"
+#include "Util/AnimBatchTask.h"
+#include "Util/AnimCompressionAudit.h"
 #include "Util/AnimCurveUtils.h"
+#include "Util/AnimMemoryAudit.h"
 #include "EngineUtils.h"
 #include "IDesktopPlatform.h"
-#include "Dom/JsonObject.h"
 #include "Framework/Application/SlateApplication.h"
 #include "Kismet/KismetSystemLibrary.h"
-#include "Misc/FileHelper.h"
 #include "Misc/MessageDialog.h"
-#include "Serialization/JsonReader.h"
-#include "Serialization/JsonSerializer.h"
+#include "Widgets/Layout/SBox.h"
+#include "Widgets/Notifications/SProgressBar.h"
 #include "Widgets/Text/STextBlock.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogAnimCurveTool, Log, All);
@@ -50,6 +57,16 @@ TSharedPtr<IDetailsView> SAnimCurveToolWidget::CreateSettingView(FString Name, T
     return ObjectSettingView;
 }
 
+SAnimCurveToolWidget::~SAnimCurveToolWidget()
+{
+    if (BatchTask.IsValid())
+    {
+        BatchTask->OnItemFinished.Unbind();
+        BatchTask->OnFinished.Unbind();
+        BatchTask->Cancel();
+    }
+}
+
 void SAnimCurveToolWidget::Construct(const FArguments& Args)
 {
     Setup();
@@ -67,7 +84,8 @@ bool SAnimCurveToolWidget::IsPropertyVisible(const FPropertyAndParent& PropertyA
         "CurveSetting",
         "FootstepSetting",
         "FilterSetting",
-        "CheckSetting"
+        "CheckSetting",
+        "BatchSetting"
     };
 
     FString PropertyCategoryName = PropertyAndParent.Property.GetMetaData("Category");
@@ -103,6 +121,9 @@ void SAnimCurveToolWidget::Setup()
     CheckSetting = UAnimCheckSettings::Get();
     CheckSetting->m_ParentWidget = this;
 
+    BatchSetting = UAnimBatchSettings::Get();
+    BatchSetting->m_ParentWidget = this;
+
     REGISTER_ANIM_NAME_CHECK(EAnimFilterType::Least_One);
     REGISTER_ANIM_NAME_CHECK(EAnimFilterType::Have_All);
     REGISTER_ANIM_NAME_CHECK(EAnimFilterType::Not_Any);
@@ -117,9 +138,9 @@ TSharedRef<SWidget> SAnimCurveToolWidget::Content()
 {
     AnimCurveSettingView = CreateSettingView<UAnimCurveSettings>(TEXT("Resources"), UAnimCurveSettings::Get());
     FootstepSettingView = CreateSettingView<UFootstepSettings>(TEXT("Resources"), UFootstepSettings::Get());
-    SequenceSelectionView = CreateSettingView<UAnimSequenceSelection>(TEXT("Resources"), UAnimSequenceSelection::Get());
     JsonSettingView = CreateSettingView<UAnimJsonSettings>(TEXT("Resources"), UAnimJsonSettings::Get());
     CheckSettingView = CreateSettingView<UAnimCheckSettings>(TEXT("Resources"), UAnimCheckSettings::Get());
+    BatchSettingView = CreateSettingView<UAnimBatchSettings>(TEXT("Resources"), UAnimBatchSettings::Get());
 
     SVerticalBox::FSlot& PropertyPannel = SVerticalBox::Slot().Padding(2.0f, 1.0f)
     [
@@ -132,10 +153,8 @@ TSharedRef<SWidget> SAnimCurveToolWidget::Content()
                                       .AutoHeight()
                                       .Padding(FEditorStyle::GetMargin("StandardDialog.ContentPadding"))
                 [
-                    SNew(SHorizontalBox) + SHorizontalBox::Slot().VAlign(VAlign_Top)
-                    [
-                        SequenceSelectionView->AsShared()
-                    ]
+                    SAssignNew(SequenceListView, SAnimSequenceList)
+                     .Selection(SequenceSelection)
                 ]
 
                 + SVerticalBox::Slot().VAlign(VAlign_Top)
@@ -177,6 +196,16 @@ TSharedRef<SWidget> SAnimCurveToolWidget::Content()
                         CheckSettingView->AsShared()
                     ]
                 ]
+
+                + SVerticalBox::Slot()
+                  .AutoHeight()
+                  .Padding(FEditorStyle::GetMargin("StandardDialog.ContentPadding"))
+                [
+                    SNew(SHorizontalBox) + SHorizontalBox::Slot().VAlign(VAlign_Top)
+                    [
+                        BatchSettingView->AsShared()
+                    ]
+                ]
             ]
         ]
     ];
@@ -196,6 +225,7 @@ TSharedRef<SWidget> SAnimCurveToolWidget::Content()
         [
             SNew(SButton)
 				.Text(LOCTEXT("Extract_Curves", "Extract Curves"))
+				.IsEnabled(this, &SAnimCurveToolWidget::IsBatchIdle)
 				.OnClicked(this, &SAnimCurveToolWidget::OnSubmitExtractCurves)
         ]
 
@@ -207,9 +237,23 @@ TSharedRef<SWidget> SAnimCurveToolWidget::Content()
         [
             SNew(SButton)
 				.Text(LOCTEXT("Mark_Footsteps", "Mark Footsteps"))
+				.IsEnabled(this, &SAnimCurveToolWidget::IsBatchIdle)
 				.OnClicked(this, &SAnimCurveToolWidget::OnSubmitMarkFootsteps)
         ]
 
+        + SHorizontalBox::Slot()
+          .AutoWidth()
+          .HAlign(HAlign_Center)
+          .VAlign(VAlign_Center)
+          .Padding(4, 0, 0, 0)
+        [
+            SNew(SButton)
+				.Text(LOCTEXT("Optimize_Curves", "Optimize Curves"))
+				.ToolTipText(LOCTEXT("Optimize_Curves_Tip", "Strip debug curves and reduce constant, near-linear and redundant curve keys"))
+				.IsEnabled(this, &SAnimCurveToolWidget::IsBatchIdle)
+				.OnClicked(this, &SAnimCurveToolWidget::OnSubmitOptimizeCurves)
+        ]
+
         //+ SHorizontalBox::Slot()
         //	.AutoWidth()
         //	.HAlign(HAlign_Center)
@@ -229,9 +273,36 @@ TSharedRef<SWidget> SAnimCurveToolWidget::Content()
             SNew(SButton)
 						.Text(LOCTEXT("Camera_Animation", "Check Animation"))
 					// .ButtonColorAndOpacity(FLinearColor(0.2f, 1.0f, 0.2f))
+						.IsEnabled(this, &SAnimCurveToolWidget::IsBatchIdle)
 						.OnClicked(this, &SAnimCurveToolWidget::OnSubmitCheckAnimation)
         ]
 
+        + SHorizontalBox::Slot()
+          .AutoWidth()
+          .HAlign(HAlign_Center)
+          .VAlign(VAlign_Center)
+          .Padding(4, 0, 0, 0)
+        [
+            SNew(SButton)
+						.Text(LOCTEXT("Memory_Audit", "Memory Audit"))
+						.ToolTipText(LOCTEXT("Memory_Audit_Tip", "Report the memory footprint of every sequence under the search path"))
+						.IsEnabled(this, &SAnimCurveToolWidget::IsBatchIdle)
+						.OnClicked(this, &SAnimCurveToolWidget::OnSubmitMemoryAudit)
+        ]
+
+        + SHorizontalBox::Slot()
+          .AutoWidth()
+          .HAlign(HAlign_Center)
+          .VAlign(VAlign_Center)
+          .Padding(4, 0, 0, 0)
+        [
+            SNew(SButton)
+						.Text(LOCTEXT("Compression_Audit", "Compression Audit"))
+						.ToolTipText(LOCTEXT("Compression_Audit_Tip", "Compare raw and compressed poses of the selected sequences"))
+						.IsEnabled(this, &SAnimCurveToolWidget::IsBatchIdle)
+						.OnClicked(this, &SAnimCurveToolWidget::OnSubmitCompressionAudit)
+        ]
+
     ];
 
     SVerticalBox::FSlot& ButtonChannel2 = SVerticalBox::Slot()
@@ -248,6 +319,7 @@ TSharedRef<SWidget> SAnimCurveToolWidget::Content()
             SNew(SButton)
              .Text(LOCTEXT("Generate_Json", "Generate Json"))
          // .ButtonColorAndOpacity(FLinearColor(0.2f, 1.0f, 0.2f))
+             .IsEnabled(this, &SAnimCurveToolWidget::IsBatchIdle)
              .OnClicked(this, &SAnimCurveToolWidget::OnSubmitGenerateJson)
         ]
 
@@ -259,6 +331,7 @@ TSharedRef<SWidget> SAnimCurveToolWidget::Content()
         [
             SNew(SButton)
              .Text(LOCTEXT("Load_Json", "Load from Json"))
+             .IsEnabled(this, &SAnimCurveToolWidget::IsBatchIdle)
              .OnClicked(this, &SAnimCurveToolWidget::OnSubmitLoadJson)
         ]
 
@@ -275,7 +348,64 @@ TSharedRef<SWidget> SAnimCurveToolWidget::Content()
         ]
     ];
 
-    TSharedRef<SWidget> MainContent = SNew(SVerticalBox) + PropertyPannel + ButtonChannel1 + ButtonChannel2;
+    SVerticalBox::FSlot& ProgressChannel = SVerticalBox::Slot()
+                                           .AutoHeight()
+                                           .Padding(2.0f, 1.0f)
+                                           .VAlign(VAlign_Bottom)
+    [
+        SNew(SVerticalBox)
+
+        + SVerticalBox::Slot()
+          .AutoHeight()
+          .Padding(4, 2, 4, 2)
+        [
+            SNew(SHorizontalBox)
+
+            + SHorizontalBox::Slot()
+              .FillWidth(1.0f)
+              .VAlign(VAlign_Center)
+            [
+                SNew(SProgressBar)
+                 .Percent(this, &SAnimCurveToolWidget::GetBatchProgress)
+            ]
+
+            + SHorizontalBox::Slot()
+              .AutoWidth()
+              .VAlign(VAlign_Center)
+              .Padding(4, 0, 0, 0)
+            [
+                SNew(SButton)
+                 .Text(LOCTEXT("Cancel_Batch", "Cancel"))
+                 .IsEnabled(this, &SAnimCurveToolWidget::IsBatchRunning)
+                 .OnClicked(this, &SAnimCurveToolWidget::OnCancelBatch)
+            ]
+        ]
+
+        + SVerticalBox::Slot()
+          .AutoHeight()
+          .Padding(4, 0, 4, 2)
+        [
+            SNew(STextBlock)
+             .Text(this, &SAnimCurveToolWidget::GetBatchProgressText)
+        ]
+
+        + SVerticalBox::Slot()
+          .AutoHeight()
+          .Padding(4, 0, 4, 2)
+        [
+            SNew(SBox)
+             .MaxDesiredHeight(160.0f)
+            [
+                SAssignNew(BatchResultsView, SListView<TSharedPtr<FAnimBatchItemResult>>)
+                 .ListItemsSource(&BatchResults)
+                 .SelectionMode(ESelectionMode::None)
+                 .OnGenerateRow(this, &SAnimCurveToolWidget::OnGenerateBatchResultRow)
+            ]
+        ]
+    ];
+
+    TSharedRef<SWidget> MainContent = SNew(SVerticalBox) + PropertyPannel + ButtonChannel1 + ButtonChannel2 +
+        ProgressChannel;
 
     return MainContent;
 }
@@ -287,62 +417,205 @@ void SAnimCurveToolWidget::ProcessAnimSequencesFilter()
     //     LoadFromAnimJson(SequenceSelection->AnimJsonPath);
     // }
 
-    SequenceSelection->AnimationSequences.RemoveAll([](const auto Ptr)
+    SequenceSelection->AnimationSequences.RemoveAll([](FSoftObjectPath const& Path)
     {
-        return Ptr == nullptr;
+        return !Path.IsValid();
     });
 }
 
 
-FReply SAnimCurveToolWidget::OnSubmitMarkFootsteps()
+void SAnimCurveToolWidget::RunBatchOperation(EAnimBatchOperation Operation)
+{
+    if (IsBatchRunning())
+    {
+        return;
+    }
+
+    TArray<FString> SequencePaths = PrepareBatch();
+    if (Operation == EAnimBatchOperation::CheckAnimation && CheckSetting->bCheckFromRegistryTags)
+    {
+        FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(
+            "AssetRegistry");
+        SequencePaths.RemoveAll([&](const FString& Path)
+        {
+            bool bPassed = false;
+            const FAssetData AssetData = AssetRegistryModule.Get().GetAssetByObjectPath(*Path);
+            if (!FAnimAnalysisTags::TryGetCheckResult(AssetData, CheckSetting->bCheckIfCameraRootAtOrigin,
+                                                      CheckSetting->bCheckIfSingleFrameAnim, bPassed))
+            {
+                return false;
+            }
+            OnBatchItemFinished(Path, bPassed, 0.0);
+            return true;
+        });
+    }
+
+    auto Options = FAnimBatchOptions::FromSettings();
+    TUniquePtr<FAnimBatchJournal> Journal;
+    if (BatchSetting->bEnableJournal)
+    {
+        Journal = MakeUnique<FAnimBatchJournal>(
+            FAnimBatchJournal::MakeJournalPath(BatchSetting->JournalDirectory.Path,
+                                               FAnimBatchUtils::LexToString(Operation)),
+            FAnimBatchUtils::ComputeRunHash(Operation, SequencePaths, Options), BatchSetting->bResumeFromJournal);
+    }
+    const int32 SaveWindowSize = Journal ? BatchSetting->SaveWindowSize : 0;
+
+    StartBatchTask(MakeShared<FAnimBatchTask>(Operation, MoveTemp(SequencePaths), MoveTemp(Options),
+                                              MoveTemp(Journal), SaveWindowSize, BatchSetting->MaxPendingCommits,
+                                              MakeShared<FAnimGameThreadExecutor>(BatchSetting->GameThreadBudgetMs)));
+}
+
+TArray<FString> SAnimCurveToolWidget::PrepareBatch()
 {
     ProcessAnimSequencesFilter();
     SequenceSelection->ErrorSequences.Empty();
-    for (auto Seq : SequenceSelection->AnimationSequences)
+    SequenceListView->Refresh();
+    BatchResults.Empty();
+    BatchResultsView->RequestListRefresh();
+
+    TArray<FString> SequencePaths;
+    for (auto const& Path : SequenceSelection->AnimationSequences)
     {
-        bool IsNoError = false;
-        if (!FAnimCurveUtils::MarkFootstepsFor1PAnimation(Seq, FootstepSetting->TrackBoneNames,
-                                                          FootstepSetting->bUseCurve,
-                                                          FootstepSetting->IsEnableDebug))
+        SequencePaths.Add(Path.ToString());
+    }
+    return SequencePaths;
+}
+
+void SAnimCurveToolWidget::StartBatchTask(TSharedRef<FAnimBatchTask> Task, TFunction<void()> FinishedAction)
+{
+    BatchTask = Task;
+    BatchFinishedAction = MoveTemp(FinishedAction);
+    BatchTask->OnItemFinished.BindSP(this, &SAnimCurveToolWidget::OnBatchItemFinished);
+    BatchTask->OnFinished.BindSP(this, &SAnimCurveToolWidget::OnBatchFinished);
+    BatchTask->Start();
+}
+
+void SAnimCurveToolWidget::OnBatchItemFinished(const FString& SequencePath, bool bSucceeded, double Seconds)
+{
+    BatchResults.Add(MakeShared<FAnimBatchItemResult>(FAnimBatchItemResult{SequencePath, bSucceeded, Seconds}));
+    BatchResultsView->RequestListRefresh();
+
+    if (!bSucceeded)
+    {
+        SequenceSelection->ErrorSequences.Add(FSoftObjectPath(SequencePath));
+        // Re-sorting a large selection per error is wasted work, throttle it
+        const double Now = FPlatformTime::Seconds();
+        if (Now - LastErrorsRefreshTime > 1.0)
         {
-            SequenceSelection->ErrorSequences.Add(Seq);
-            UE_LOG(LogAnimCurveTool, Log, TEXT("[%s] may not be suitable for footstep recognition."), *Seq->GetName());
+            LastErrorsRefreshTime = Now;
+            SequenceListView->Refresh();
         }
     }
+}
+
+void SAnimCurveToolWidget::OnBatchFinished()
+{
+    if (BatchFinishedAction)
+    {
+        auto FinishedAction = MoveTemp(BatchFinishedAction);
+        BatchFinishedAction = nullptr;
+        FinishedAction();
+    }
+    SequenceListView->Refresh();
+}
+
+FReply SAnimCurveToolWidget::OnCancelBatch()
+{
+    if (BatchTask.IsValid())
+    {
+        BatchTask->Cancel();
+    }
     return FReply::Handled();
 }
 
-FReply SAnimCurveToolWidget::OnSubmitExtractCurves()
+bool SAnimCurveToolWidget::IsBatchRunning() const
 {
-    ProcessAnimSequencesFilter();
-    for (auto Seq : SequenceSelection->AnimationSequences)
+    return BatchTask.IsValid() && BatchTask->IsRunning();
+}
+
+TOptional<float> SAnimCurveToolWidget::GetBatchProgress() const
+{
+    if (!BatchTask.IsValid() || BatchTask->GetNumTotal() == 0)
     {
-        uint32 SaveFlags = 0;
-        SaveFlags |= AnimCurveSetting->IsExtractPositionXYZ ? 0xf0 : 0x00;
-        SaveFlags |= AnimCurveSetting->IsExtractRotationXYZ ? 0x0f : 0x00;
-        if (!FAnimCurveUtils::SaveBonesCurves(Seq, AnimCurveSetting->TargetBoneName,
-                                              AnimCurveSetting->ExportDirectoryPath.Path, SaveFlags))
-        {
-            UE_LOG(LogAnimCurveTool, Warning, TEXT("[%s->%s]: Error ocurrs when save bone curves!"), *Seq->GetName(),
-                   *AnimCurveSetting->TargetBoneName);
-        }
+        return 0.0f;
+    }
+    return static_cast<float>(BatchTask->GetNumFinished()) / BatchTask->GetNumTotal();
+}
+
+FText SAnimCurveToolWidget::GetBatchProgressText() const
+{
+    if (!BatchTask.IsValid())
+    {
+        return FText::GetEmpty();
+    }
+
+    FText State = LOCTEXT("Batch_Running", "Running");
+    if (!BatchTask->IsRunning())
+    {
+        State = BatchTask->IsCancelled() ? LOCTEXT("Batch_Cancelled", "Cancelled") : LOCTEXT("Batch_Done", "Done");
+    }
+    else if (BatchTask->IsCancelled())
+    {
+        State = LOCTEXT("Batch_Cancelling", "Cancelling");
     }
+
+    const FTimespan Eta = FTimespan::FromSeconds(BatchTask->GetEstimatedSecondsLeft());
+    return FText::Format(
+        LOCTEXT("Batch_Progress", "{0} {1}: {2}/{3}, {4} errors, {5} sequences/s, ETA {6}"),
+        FText::FromString(BatchTask->GetRunName()), State,
+        FText::AsNumber(BatchTask->GetNumFinished()), FText::AsNumber(BatchTask->GetNumTotal()),
+        FText::AsNumber(BatchTask->GetResult().ErrorSequences.Num()),
+        FText::AsNumber(BatchTask->GetThroughput()),
+        FText::FromString(Eta.ToString(TEXT("%h:%m:%s"))));
+}
+
+TSharedRef<ITableRow> SAnimCurveToolWidget::OnGenerateBatchResultRow(TSharedPtr<FAnimBatchItemResult> Item,
+                                                                     const TSharedRef<STableViewBase>& OwnerTable)
+{
+    return SNew(STableRow<TSharedPtr<FAnimBatchItemResult>>, OwnerTable)
+    [
+        SNew(STextBlock)
+         .Text(FText::FromString(FString::Printf(TEXT("[%s] %s  %.1f ms"),
+                                                 Item->bSucceeded ? TEXT("OK") : TEXT("ERR"),
+                                                 *FPackageName::ObjectPathToObjectName(Item->SequencePath),
+                                                 Item->Seconds * 1000.0)))
+         .ColorAndOpacity(Item->bSucceeded ? FLinearColor::White : FLinearColor(1.0f, 0.3f, 0.3f))
+    ];
+}
+
+FReply SAnimCurveToolWidget::OnSubmitMarkFootsteps()
+{
+    RunBatchOperation(EAnimBatchOperation::MarkFootsteps);
+    return FReply::Handled();
+}
+
+FReply SAnimCurveToolWidget::OnSubmitExtractCurves()
+{
+    RunBatchOperation(EAnimBatchOperation::ExtractCurves);
+    return FReply::Handled();
+}
+
+FReply SAnimCurveToolWidget::OnSubmitOptimizeCurves()
+{
+    RunBatchOperation(EAnimBatchOperation::OptimizeCurves);
     return FReply::Handled();
 }
 
 FReply SAnimCurveToolWidget::OnSubmitGenerateJson()
 {
-    TArray<UAnimSequence*> AnimSequences;
-    FAnimCurveUtils::GetAnimAssets(JsonSetting->SearchPath.Path, AnimSequences);
+    // Names and curve tags are both in the registry, nothing is loaded
+    TArray<FAssetData> AnimSequences;
+    FAnimCurveUtils::GetAnimAssetData(JsonSetting->SearchPath.Path, AnimSequences);
 
     if (JsonSetting->bEnableNameConventionFilter)
     {
         for (auto& Filter : JsonSetting->AnimRuleFilters)
         {
             AnimSequences.RemoveAll(
-                [&](auto Seq) -> bool
+                [&](FAssetData const& Seq) -> bool
                 {
-                    auto IsRequired = CheckRegistryTable[Filter.FilterType](Filter.Keywords, Seq->GetName());
+                    auto IsRequired = CheckRegistryTable[Filter.FilterType](Filter.Keywords, Seq.AssetName.ToString());
                     // if(!IsRequired)
                     // {
                     //     UE_LOG(LogAnimCurveTool, Log, TEXT("Remove %s, due to rule %s"), *Seq->GetName(), *Filter.Keywords[0]);
@@ -356,42 +629,31 @@ FReply SAnimCurveToolWidget::OnSubmitGenerateJson()
     {
         for (auto& CurveName : JsonSetting->VariableCurvesNames)
         {
+            const FString CurveToken = USkeleton::CurveTagDelimiter + CurveName + USkeleton::CurveTagDelimiter;
             AnimSequences.RemoveAll(
-                [&](auto Seq) -> bool
+                [&](FAssetData const& Seq) -> bool
                 {
-                    return !UAnimationBlueprintLibrary::DoesCurveExist(Seq, *CurveName, ERawCurveTrackTypes::RCT_MAX);
+                    // Written by UAnimSequenceBase::GetAssetRegistryTags as ;Name;Name;
+                    FString CurveNames;
+                    return !Seq.GetTagValue(USkeleton::CurveNameTag, CurveNames) || !CurveNames.Contains(CurveToken);
                 });
         }
     }
 
-    TArray<TSharedPtr<FJsonValue>> SequencesRefs;
-    for (const auto Seq : AnimSequences)
+    TArray<FString> SequencesRefs;
+    for (auto const& Seq : AnimSequences)
     {
         FString PackagePath; // = FString::Format(TEXT("{0}'{1}'"), {TEXT("AnimSequence"), Seq->GetPathName()});
-        if (FPackageName::TryConvertFilenameToLongPackageName(Seq->GetPathName(), PackagePath))
+        if (FPackageName::TryConvertFilenameToLongPackageName(Seq.ObjectPath.ToString(), PackagePath))
         {
-            SequencesRefs.Push(MakeShared<FJsonValueString>(PackagePath));
+            SequencesRefs.Push(PackagePath);
         }
     }
-    // Construct Json Object
-    TSharedPtr<FJsonObject> JsonObj = MakeShared<FJsonObject>();
-    JsonObj->SetArrayField(TEXT("AnimSequences"), SequencesRefs);
-
-    typedef TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>> FPrettyJsonStringWriterFactory;
-    typedef TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>> FPrettyJsonStringWriter;
 
-    FString OutputString;
-    TSharedRef<FPrettyJsonStringWriter> Writer = FPrettyJsonStringWriterFactory::Create(&OutputString);
-    if (FJsonSerializer::Serialize(JsonObj.ToSharedRef(), Writer))
+    auto AbsPath = FPaths::ConvertRelativePathToFull(JsonSetting->ExportPath.FilePath);
+    if (FAnimBatchUtils::SaveSequenceList(AbsPath, SequencesRefs))
     {
-        auto AbsPath =
-            FPaths::ConvertRelativePathToFull(JsonSetting->ExportPath.FilePath);
-        if (FFileHelper::SaveStringToFile(OutputString, *AbsPath,
-                                          FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(),
-                                          FILEWRITE_None))
-        {
-            UE_LOG(LogAnimCurveTool, Log, TEXT("Save Json to '%s' Success!"), *AbsPath);
-        }
+        UE_LOG(LogAnimCurveTool, Log, TEXT("Save Json to '%s' Success!"), *AbsPath);
     }
 
     return FReply::Handled();
@@ -453,102 +715,122 @@ FReply SAnimCurveToolWidget::OnSubmitLoadJson()
 
 FReply SAnimCurveToolWidget::OnSubmitCheckAnimation()
 {
-    if (CheckSetting->bCheckIfCameraRootAtOrigin)
-    {
-        CheckCameraRootAtOrigin();
-    }
-    if (CheckSetting->bCheckIfSingleFrameAnim)
-    {
-        CheckSingleFrameAnimation();
-    }
+    RunBatchOperation(EAnimBatchOperation::CheckAnimation);
     return FReply::Handled();
 }
 
-void SAnimCurveToolWidget::CheckCameraRootAtOrigin()
+FReply SAnimCurveToolWidget::OnSubmitMemoryAudit()
 {
-    ProcessAnimSequencesFilter();
-    SequenceSelection->ErrorSequences.Empty();
-    for (auto Seq : SequenceSelection->AnimationSequences)
+    if (IsBatchRunning())
     {
-        TArray<FVector> PosKeys;
-        TArray<FQuat> RotKeys;
-        if (FAnimCurveUtils::GetBoneKeysByNameHelper(Seq, "Camera_Root", PosKeys, RotKeys, true))
-        {
-            float Eps = 1e-10;
-            auto Sign = [=](float x) -> int { return (x > Eps) - (x < Eps); };
+        return FReply::Handled();
+    }
 
-            if (Sign(PosKeys[0].X) != 0 || Sign(PosKeys[0].Y) != 0 || Sign(PosKeys[0].Z) != 0)
-            {
-                UE_LOG(LogAnimCurveTool, Warning, TEXT("[%s->%s] Camera_Root not start at Origin(0, 0, 0)!"),
-                       *Seq->GetName(),
-                       TEXT("Camera_Root"));
-                SequenceSelection->ErrorSequences.Push(Seq);
-            }
-            else if (Sign(PosKeys.Last().X) != 0 || Sign(PosKeys.Last().Y) != 0 || Sign(PosKeys.Last().Z) != 0)
-            {
-                UE_LOG(LogAnimCurveTool, Warning, TEXT("[%s->%s] Camera_Root not end at Origin(0, 0, 0)!"),
-                       *Seq->GetName(),
-                       TEXT("Camera_Root"));
-                SequenceSelection->ErrorSequences.Push(Seq);
-            }
+    const auto Records = MakeShared<TArray<FAnimMemoryRecord>, ESPMode::ThreadSafe>();
+    if (!FAnimMemoryAudit::Collect(JsonSetting->SearchPath.Path, JsonSetting->AnimRuleFilters,
+                                   JsonSetting->bEnableNameConventionFilter, *Records))
+    {
+        return FReply::Handled();
+    }
+    auto WriteReport = [Records]()
+    {
+        if (!FAnimMemoryAudit::WriteReport(FAnimBatchReport::GetDefaultDirectory(), *Records))
+        {
+            FMessageDialog::Open(EAppMsgType::Ok,
+                                 LOCTEXT("Memory_Audit_Error", "Fail to write the memory audit report"));
         }
+    };
+    if (!CheckSetting->bMemoryAuditLoadAssets)
+    {
+        WriteReport();
+        return FReply::Handled();
     }
-}
 
-void SAnimCurveToolWidget::CheckSingleFrameAnimation()
-{
-    ProcessAnimSequencesFilter();
-    SequenceSelection->ErrorSequences.Empty();
-    for (auto Seq : SequenceSelection->AnimationSequences)
+    // Loads go through the batch task, the records are filled in its commits on the game thread
+    TMap<FString, int32> RecordIndices;
+    TArray<FString> SequencePaths;
+    for (int32 i = 0; i < Records->Num(); ++i)
     {
-        if (Seq->GetNumberOfFrames() == 1)
+        RecordIndices.Add((*Records)[i].SequencePath, i);
+        SequencePaths.Add((*Records)[i].SequencePath);
+    }
+    auto Analyze = [Records, RecordIndices = MoveTemp(RecordIndices)](UAnimSequence* Seq) -> TFunction<bool()>
+    {
+        // A redirected path loads a sequence the registry listed under another name
+        const int32* RecordIndexPtr = RecordIndices.Find(Seq->GetPathName());
+        if (!RecordIndexPtr)
         {
-            UE_LOG(LogAnimCurveTool, Warning, TEXT("[%s] only contains one frame!"), *Seq->GetName());
-            SequenceSelection->ErrorSequences.Push(Seq);
+            return []() { return false; };
         }
-    }
+        const int32 RecordIndex = *RecordIndexPtr;
+        return [Records, RecordIndex, Seq]()
+        {
+            FAnimMemoryAudit::FillFromSequence(Seq, (*Records)[RecordIndex]);
+            return true;
+        };
+    };
+
+    BatchResults.Empty();
+    BatchResultsView->RequestListRefresh();
+    StartBatchTask(MakeShared<FAnimBatchTask>(TEXT("MemoryAudit"), MoveTemp(Analyze), MoveTemp(SequencePaths),
+                                              BatchSetting->MaxPendingCommits,
+                                              MakeShared<FAnimGameThreadExecutor>(BatchSetting->GameThreadBudgetMs)),
+                   MoveTemp(WriteReport));
+    return FReply::Handled();
 }
 
-bool SAnimCurveToolWidget::LoadFromAnimJson(const FString& JsonName)
+FReply SAnimCurveToolWidget::OnSubmitCompressionAudit()
 {
-    FString FileContents;
-    if (!FFileHelper::LoadFileToString(FileContents, *JsonName))
+    if (IsBatchRunning())
     {
-        return false;
+        return FReply::Handled();
     }
 
-    TSharedPtr<FJsonObject> JsonObj;
-    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(FileContents);
-    if (!FJsonSerializer::Deserialize(Reader, JsonObj) || !JsonObj.IsValid())
+    // Evaluated on the batch workers, collected in the commits on the game thread
+    const auto Errors = MakeShared<TArray<FAnimCompressionError>, ESPMode::ThreadSafe>();
+    const auto BoneNames = CheckSetting->CompressionAuditBones;
+    const float ThresholdCm = CheckSetting->CompressionErrorThreshold;
+    const float ThresholdDegrees = CheckSetting->CompressionRotationThreshold;
+    auto Analyze = [Errors, BoneNames, ThresholdCm, ThresholdDegrees](UAnimSequence* Seq) -> TFunction<bool()>
     {
-        return false;
-    }
-
-    TArray<FString> AnimSequencePaths;
+        FAnimCompressionError Error;
+        FAnimCompressionAudit::Evaluate(Seq, BoneNames, Error);
+        return [Errors, Error, ThresholdCm, ThresholdDegrees]()
+        {
+            Errors->Add(Error);
+            return !Error.IsOverThreshold(ThresholdCm, ThresholdDegrees);
+        };
+    };
 
-    // for (auto GunTypeIter = JsonObj->Values.CreateConstIterator(); GunTypeIter; ++GunTypeIter)
-    // {
-    // 	UE_LOG(LogAnimCurveTool, Log, TEXT("Parse GunType %s"), *GunTypeIter->Key);
-    // 	const auto GunTypeObj = GunTypeIter->Value->AsObject();
-    // 	for (auto GunNameIter = GunTypeObj->Values.CreateConstIterator(); GunNameIter; ++GunNameIter)
-    // 	{
-    // 		UE_LOG(LogAnimCurveTool, Log, TEXT("Parse GunName %s"), *GunNameIter->Key);
-    // 		auto GunSequences = GunNameIter->Value->AsArray();
-    // 		for (const auto& GunSeq : GunSequences)
-    // 		{
-    // 			UE_LOG(LogAnimCurveTool, Log, TEXT("Parse Gun AnimSequence %s"), *GunSeq->AsString());
-    // 			AnimSequencePaths.Add(GunSeq->AsString());
-    // 		}
-    // 	}
-    // }
+    StartBatchTask(MakeShared<FAnimBatchTask>(TEXT("CompressionAudit"), MoveTemp(Analyze), PrepareBatch(),
+                                              BatchSetting->MaxPendingCommits,
+                                              MakeShared<FAnimGameThreadExecutor>(BatchSetting->GameThreadBudgetMs)),
+                   [Errors, ThresholdCm, ThresholdDegrees]()
+                   {
+                       FAnimCompressionAudit::WriteReport(FAnimBatchReport::GetDefaultDirectory(), *Errors,
+                                                          ThresholdCm, ThresholdDegrees);
+                   });
+    return FReply::Handled();
+}
 
-    auto AnimSequenceJsonArray = JsonObj->GetArrayField("AnimSequences");
-    for (auto& SeqJson : AnimSequenceJsonArray)
+bool SAnimCurveToolWidget::LoadFromAnimJson(const FString& JsonName)
+{
+    TArray<FString> AnimSequencePaths;
+    if (!FAnimBatchUtils::LoadSequenceList(JsonName, AnimSequencePaths))
     {
-        AnimSequencePaths.Add(SeqJson->AsString());
+        return false;
     }
 
-    return FAnimCurveUtils::LoadAnimSequencesByReference(AnimSequencePaths, SequenceSelection->AnimationSequences);
+    // Only paths are recorded, the batch loads each sequence when it gets to it
+    TArray<FSoftObjectPath> Paths;
+    Paths.Reserve(AnimSequencePaths.Num());
+    for (auto const& Reference : AnimSequencePaths)
+    {
+        Paths.Add(UAnimSequenceSelection::MakeSequencePath(Reference));
+    }
+    SequenceSelection->AddSequences(Paths);
+    SequenceListView->Refresh();
+    return true;
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -5,7 +5,19 @@
 #include "Animation/AnimSequence.h"
 
 #include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
 #include "AnimToolSettings.h"
+#include "Util/AnimBatchUtils.h"
+
+class FAnimBatchTask;
+class SAnimSequenceList;
+
+struct FAnimBatchItemResult
+{
+    FString SequencePath;
+    bool bSucceeded;
+    double Seconds;
+};
 
 
 class SAnimCurveToolWidget : public SCompoundWidget
@@ -22,9 +34,7 @@ public:
     {
     }
 
-    ~SAnimCurveToolWidget()
-    {
-    }
+    ~SAnimCurveToolWidget();
 
     void Construct(const FArguments& Args);
 
@@ -52,8 +62,37 @@ private:
     FReply OnSubmitLoadJson();
 
     FReply OnSubmitCheckAnimation();
-    void CheckCameraRootAtOrigin();
-    void CheckSingleFrameAnimation();
+
+    FReply OnSubmitOptimizeCurves();
+
+    FReply OnSubmitMemoryAudit();
+
+    FReply OnSubmitCompressionAudit();
+
+    void RunBatchOperation(EAnimBatchOperation Operation);
+
+    // Applies the sequence filters, clears the previous results and returns the selected paths
+    TArray<FString> PrepareBatch();
+
+    // FinishedAction runs on the game thread once the task finished or was cancelled
+    void StartBatchTask(TSharedRef<FAnimBatchTask> Task, TFunction<void()> FinishedAction = nullptr);
+
+    void OnBatchItemFinished(const FString& SequencePath, bool bSucceeded, double Seconds);
+
+    void OnBatchFinished();
+
+    FReply OnCancelBatch();
+
+    bool IsBatchRunning() const;
+
+    bool IsBatchIdle() const { return !IsBatchRunning(); }
+
+    TOptional<float> GetBatchProgress() const;
+
+    FText GetBatchProgressText() const;
+
+    TSharedRef<ITableRow> OnGenerateBatchResultRow(TSharedPtr<FAnimBatchItemResult> Item,
+                                                   const TSharedRef<STableViewBase>& OwnerTable);
 
     bool LoadFromAnimJson(const FString& JsonName);
 
@@ -66,15 +105,24 @@ private:
     TSharedPtr<IDetailsView> FootstepSettingView;
 
     UAnimSequenceSelection* SequenceSelection;
-    TSharedPtr<IDetailsView> SequenceSelectionView;
+    TSharedPtr<SAnimSequenceList> SequenceListView;
 
     UAnimJsonSettings* JsonSetting;
     TSharedPtr<IDetailsView> JsonSettingView;
     
     UAnimCheckSettings* CheckSetting;
     TSharedPtr<IDetailsView> CheckSettingView;
+
+    UAnimBatchSettings* BatchSetting;
+    TSharedPtr<IDetailsView> BatchSettingView;
     
     TMap<EAnimFilterType, TFunction<bool(TArray<FString> const &, FString const&)>> CheckRegistryTable;
 
+    TSharedPtr<FAnimBatchTask> BatchTask;
+    TFunction<void()> BatchFinishedAction;
+    TArray<TSharedPtr<FAnimBatchItemResult>> BatchResults;
+    TSharedPtr<SListView<TSharedPtr<FAnimBatchItemResult>>> BatchResultsView;
+    double LastErrorsRefreshTime = 0.0;
+
 public:
 };
@@ -0,0 +1,326 @@
+﻿#include "AnimSequenceList.h"
+
+#include "AnimToolSettings.h"
+#include "ContentBrowserModule.h"
+#include "Editor.h"
+#include "EditorStyleSet.h"
+#include "IContentBrowserSingleton.h"
+#include "Animation/AnimSequence.h"
+#include "Subsystems/AssetEditorSubsystem.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Input/SCheckBox.h"
+#include "Widgets/Input/SSearchBox.h"
+#include "Widgets/Layout/SBox.h"
+#include "Widgets/Text/STextBlock.h"
+#include "Widgets/Views/STableRow.h"
+
+#define LOCTEXT_NAMESPACE "SAnimSequenceList"
+
+const FName SAnimSequenceList::NameColumn(TEXT("Name"));
+const FName SAnimSequenceList::FolderColumn(TEXT("Folder"));
+const FName SAnimSequenceList::StatusColumn(TEXT("Status"));
+
+namespace
+{
+    class SAnimSequenceListRow : public SMultiColumnTableRow<TSharedPtr<FAnimSequenceListItem>>
+    {
+    public:
+        SLATE_BEGIN_ARGS(SAnimSequenceListRow)
+            {
+            }
+
+            SLATE_ARGUMENT(TSharedPtr<FAnimSequenceListItem>, Item)
+        SLATE_END_ARGS()
+
+        void Construct(const FArguments& Args, const TSharedRef<STableViewBase>& OwnerTable)
+        {
+            Item = Args._Item;
+            SMultiColumnTableRow<TSharedPtr<FAnimSequenceListItem>>::Construct(
+                FSuperRowType::FArguments(), OwnerTable);
+        }
+
+        virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+        {
+            FString Text;
+            if (ColumnName == SAnimSequenceList::NameColumn)
+            {
+                Text = Item->Name;
+            }
+            else if (ColumnName == SAnimSequenceList::FolderColumn)
+            {
+                Text = Item->Folder;
+            }
+            else
+            {
+                Text = Item->bError ? TEXT("ERR") : TEXT("");
+            }
+            return SNew(STextBlock)
+                .Text(FText::FromString(Text))
+                .ColorAndOpacity(Item->bError ? FLinearColor(1.0f, 0.3f, 0.3f) : FLinearColor::White);
+        }
+
+    private:
+        TSharedPtr<FAnimSequenceListItem> Item;
+    };
+}
+
+void SAnimSequenceList::Construct(const FArguments& Args)
+{
+    Selection = Args._Selection;
+    check(Selection);
+
+    ChildSlot
+    [
+        SNew(SVerticalBox)
+
+        + SVerticalBox::Slot()
+          .AutoHeight()
+          .Padding(0, 0, 0, 2)
+        [
+            SNew(SHorizontalBox)
+
+            + SHorizontalBox::Slot()
+              .FillWidth(1.0f)
+              .VAlign(VAlign_Center)
+            [
+                SNew(SSearchBox)
+                 .HintText(LOCTEXT("Filter_Hint", "Filter sequences"))
+                 .OnTextChanged(this, &SAnimSequenceList::OnFilterTextChanged)
+            ]
+
+            + SHorizontalBox::Slot()
+              .AutoWidth()
+              .VAlign(VAlign_Center)
+              .Padding(4, 0, 0, 0)
+            [
+                SNew(SCheckBox)
+                 .OnCheckStateChanged(this, &SAnimSequenceList::OnErrorsOnlyChanged)
+                [
+                    SNew(STextBlock).Text(LOCTEXT("Errors_Only", "Errors only"))
+                ]
+            ]
+
+            + SHorizontalBox::Slot()
+              .AutoWidth()
+              .VAlign(VAlign_Center)
+              .Padding(4, 0, 0, 0)
+            [
+                SNew(SButton)
+                 .Text(LOCTEXT("Add_Selected", "Add Selected Assets"))
+                 .ToolTipText(LOCTEXT("Add_Selected_Tip", "Add the sequences selected in the Content Browser"))
+                 .OnClicked(this, &SAnimSequenceList::OnAddSelectedAssets)
+            ]
+
+            + SHorizontalBox::Slot()
+              .AutoWidth()
+              .VAlign(VAlign_Center)
+              .Padding(4, 0, 0, 0)
+            [
+                SNew(SButton)
+                 .Text(LOCTEXT("Remove_Selected", "Remove"))
+                 .OnClicked(this, &SAnimSequenceList::OnRemoveSelected)
+            ]
+
+            + SHorizontalBox::Slot()
+              .AutoWidth()
+              .VAlign(VAlign_Center)
+              .Padding(4, 0, 0, 0)
+            [
+                SNew(SButton)
+                 .Text(LOCTEXT("Clear_Selection", "Clear"))
+                 .OnClicked(this, &SAnimSequenceList::OnClear)
+            ]
+        ]
+
+        + SVerticalBox::Slot()
+          .AutoHeight()
+        [
+            SNew(SBox)
+             .MaxDesiredHeight(240.0f)
+            [
+                SAssignNew(ListView, SListView<TSharedPtr<FAnimSequenceListItem>>)
+                 .ListItemsSource(&FilteredItems)
+                 .SelectionMode(ESelectionMode::Multi)
+                 .OnGenerateRow(this, &SAnimSequenceList::OnGenerateRow)
+                 .OnMouseButtonDoubleClick(this, &SAnimSequenceList::OnItemDoubleClicked)
+                 .HeaderRow
+                 (
+                     SNew(SHeaderRow)
+                     + SHeaderRow::Column(NameColumn)
+                       .DefaultLabel(LOCTEXT("Name_Column", "Sequence"))
+                       .FillWidth(0.45f)
+                       .SortMode(this, &SAnimSequenceList::GetSortMode, NameColumn)
+                       .OnSort(this, &SAnimSequenceList::OnSortModeChanged)
+                     + SHeaderRow::Column(FolderColumn)
+                       .DefaultLabel(LOCTEXT("Folder_Column", "Folder"))
+                       .FillWidth(0.45f)
+                       .SortMode(this, &SAnimSequenceList::GetSortMode, FolderColumn)
+                       .OnSort(this, &SAnimSequenceList::OnSortModeChanged)
+                     + SHeaderRow::Column(StatusColumn)
+                       .DefaultLabel(LOCTEXT("Status_Column", "Status"))
+                       .FillWidth(0.1f)
+                       .SortMode(this, &SAnimSequenceList::GetSortMode, StatusColumn)
+                       .OnSort(this, &SAnimSequenceList::OnSortModeChanged)
+                 )
+            ]
+        ]
+
+        + SVerticalBox::Slot()
+          .AutoHeight()
+          .Padding(0, 2, 0, 0)
+        [
+            SNew(STextBlock)
+             .Text(this, &SAnimSequenceList::GetCountText)
+        ]
+    ];
+
+    Refresh();
+}
+
+void SAnimSequenceList::Refresh()
+{
+    const TSet<FSoftObjectPath> Errors(Selection->ErrorSequences);
+    AllItems.Reset(Selection->AnimationSequences.Num());
+    for (auto const& Path : Selection->AnimationSequences)
+    {
+        auto Item = MakeShared<FAnimSequenceListItem>();
+        Item->Path = Path;
+        Item->Name = Path.GetAssetName();
+        Item->Folder = FPackageName::GetLongPackagePath(Path.GetLongPackageName());
+        Item->bError = Errors.Contains(Path);
+        AllItems.Add(MoveTemp(Item));
+    }
+    ApplyFilterAndSort();
+}
+
+void SAnimSequenceList::ApplyFilterAndSort()
+{
+    FilteredItems.Reset();
+    for (auto const& Item : AllItems)
+    {
+        if ((!bErrorsOnly || Item->bError) &&
+            (FilterText.IsEmpty() || Item->Name.Contains(FilterText) || Item->Folder.Contains(FilterText)))
+        {
+            FilteredItems.Add(Item);
+        }
+    }
+
+    const bool bAscending = SortMode != EColumnSortMode::Descending;
+    const FName Column = SortColumn;
+    FilteredItems.Sort([bAscending, Column](TSharedPtr<FAnimSequenceListItem> const& A,
+                                            TSharedPtr<FAnimSequenceListItem> const& B)
+    {
+        int32 Compare;
+        if (Column == StatusColumn)
+        {
+            Compare = static_cast<int32>(A->bError) - static_cast<int32>(B->bError);
+        }
+        else if (Column == FolderColumn)
+        {
+            Compare = A->Folder.Compare(B->Folder, ESearchCase::IgnoreCase);
+        }
+        else
+        {
+            Compare = 0;
+        }
+        if (Compare == 0)
+        {
+            Compare = A->Name.Compare(B->Name, ESearchCase::IgnoreCase);
+        }
+        return bAscending ? Compare < 0 : Compare > 0;
+    });
+    ListView->RequestListRefresh();
+}
+
+void SAnimSequenceList::OnFilterTextChanged(const FText& InFilterText)
+{
+    FilterText = InFilterText.ToString();
+    ApplyFilterAndSort();
+}
+
+void SAnimSequenceList::OnErrorsOnlyChanged(ECheckBoxState NewState)
+{
+    bErrorsOnly = NewState == ECheckBoxState::Checked;
+    ApplyFilterAndSort();
+}
+
+EColumnSortMode::Type SAnimSequenceList::GetSortMode(FName Column) const
+{
+    return Column == SortColumn ? SortMode : EColumnSortMode::None;
+}
+
+void SAnimSequenceList::OnSortModeChanged(EColumnSortPriority::Type Priority, const FName& Column,
+                                          EColumnSortMode::Type NewMode)
+{
+    SortColumn = Column;
+    SortMode = NewMode;
+    ApplyFilterAndSort();
+}
+
+TSharedRef<ITableRow> SAnimSequenceList::OnGenerateRow(TSharedPtr<FAnimSequenceListItem> Item,
+                                                       const TSharedRef<STableViewBase>& OwnerTable)
+{
+    return SNew(SAnimSequenceListRow, OwnerTable).Item(Item);
+}
+
+void SAnimSequenceList::OnItemDoubleClicked(TSharedPtr<FAnimSequenceListItem> Item)
+{
+    // The one place a row loads its sequence
+    if (auto Seq = Cast<UAnimSequence>(Item->Path.TryLoad()))
+    {
+        GEditor->GetEditorSubsystem<UAssetEditorSubsystem>()->OpenEditorForAsset(Seq);
+    }
+}
+
+FReply SAnimSequenceList::OnAddSelectedAssets()
+{
+    FContentBrowserModule& ContentBrowserModule = FModuleManager::LoadModuleChecked<FContentBrowserModule>(
+        "ContentBrowser");
+    TArray<FAssetData> SelectedAssets;
+    ContentBrowserModule.Get().GetSelectedAssets(SelectedAssets);
+
+    TArray<FSoftObjectPath> Paths;
+    for (auto const& AssetData : SelectedAssets)
+    {
+        if (AssetData.AssetClass == UAnimSequence::StaticClass()->GetFName())
+        {
+            Paths.Add(FSoftObjectPath(AssetData.ObjectPath.ToString()));
+        }
+    }
+    if (Selection->AddSequences(Paths) > 0)
+    {
+        Refresh();
+    }
+    return FReply::Handled();
+}
+
+FReply SAnimSequenceList::OnRemoveSelected()
+{
+    TArray<FSoftObjectPath> Paths;
+    for (auto const& Item : ListView->GetSelectedItems())
+    {
+        Paths.Add(Item->Path);
+    }
+    if (Paths.Num())
+    {
+        Selection->RemoveSequences(Paths);
+        Refresh();
+    }
+    return FReply::Handled();
+}
+
+FReply SAnimSequenceList::OnClear()
+{
+    Selection->ResetSequences();
+    Refresh();
+    return FReply::Handled();
+}
+
+FText SAnimSequenceList::GetCountText() const
+{
+    return FText::Format(LOCTEXT("Sequence_Count", "{0} shown, {1} selected, {2} errors"),
+                         FText::AsNumber(FilteredItems.Num()), FText::AsNumber(AllItems.Num()),
+                         FText::AsNumber(Selection->ErrorSequences.Num()));
+}
+
+#undef LOCTEXT_NAMESPACE
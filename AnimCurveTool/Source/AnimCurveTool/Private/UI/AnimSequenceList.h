@@ -0,0 +1,76 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SHeaderRow.h"
+#include "Widgets/Views/SListView.h"
+
+class UAnimSequenceSelection;
+
+struct FAnimSequenceListItem
+{
+    FSoftObjectPath Path;
+    FString Name;
+    FString Folder;
+    bool bError = false;
+};
+
+/*
+ * Virtualized view of UAnimSequenceSelection, only visible rows are built so tens of thousands of entries
+ * stay responsive. Rows are plain soft paths, nothing is loaded until an entry is opened.
+ */
+class SAnimSequenceList : public SCompoundWidget
+{
+public:
+    SLATE_BEGIN_ARGS(SAnimSequenceList)
+        {
+        }
+
+        SLATE_ARGUMENT(UAnimSequenceSelection*, Selection)
+    SLATE_END_ARGS()
+
+    void Construct(const FArguments& Args);
+
+    // Rebuilds the rows after the selection or its errors changed
+    void Refresh();
+
+    static const FName NameColumn;
+    static const FName FolderColumn;
+    static const FName StatusColumn;
+
+private:
+    void ApplyFilterAndSort();
+
+    void OnFilterTextChanged(const FText& InFilterText);
+
+    void OnErrorsOnlyChanged(ECheckBoxState NewState);
+
+    EColumnSortMode::Type GetSortMode(FName Column) const;
+
+    void OnSortModeChanged(EColumnSortPriority::Type Priority, const FName& Column, EColumnSortMode::Type NewMode);
+
+    TSharedRef<ITableRow> OnGenerateRow(TSharedPtr<FAnimSequenceListItem> Item,
+                                        const TSharedRef<STableViewBase>& OwnerTable);
+
+    void OnItemDoubleClicked(TSharedPtr<FAnimSequenceListItem> Item);
+
+    FReply OnAddSelectedAssets();
+
+    FReply OnRemoveSelected();
+
+    FReply OnClear();
+
+    FText GetCountText() const;
+
+private:
+    UAnimSequenceSelection* Selection = nullptr;
+
+    TArray<TSharedPtr<FAnimSequenceListItem>> AllItems;
+    TArray<TSharedPtr<FAnimSequenceListItem>> FilteredItems;
+    TSharedPtr<SListView<TSharedPtr<FAnimSequenceListItem>>> ListView;
+
+    FString FilterText;
+    bool bErrorsOnly = false;
+    FName SortColumn = NameColumn;
+    EColumnSortMode::Type SortMode = EColumnSortMode::Ascending;
+};
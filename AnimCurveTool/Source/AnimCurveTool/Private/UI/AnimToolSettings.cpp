@@ -19,6 +19,15 @@ UFootstepSettings* UFootstepSettings::DefaultSetting = nullptr;
 void UFootstepSettings::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
 {
     Super::PostEditChangeProperty(PropertyChangedEvent);
+
+    // Only the auto-mark switches are config, they must survive an editor restart to be useful
+    const FName PropertyName = PropertyChangedEvent.GetPropertyName();
+    if (PropertyName == GET_MEMBER_NAME_CHECKED(UFootstepSettings, bAutoMarkOnImport) ||
+        PropertyName == GET_MEMBER_NAME_CHECKED(UFootstepSettings, bAutoMarkOnSave))
+    {
+        SaveConfig();
+        GetMutableDefault<UFootstepSettings>()->ReloadConfig();
+    }
 }
 
 bool UAnimSequenceSelection::IsInitialized = false;
@@ -29,6 +38,50 @@ void UAnimSequenceSelection::PostEditChangeProperty(struct FPropertyChangedEvent
     Super::PostEditChangeProperty(PropertyChangedEvent);
 }
 
+int32 UAnimSequenceSelection::AddSequences(TArray<FSoftObjectPath> const& Paths)
+{
+    const int32 NumBefore = AnimationSequences.Num();
+    AnimationSequences.Reserve(NumBefore + Paths.Num());
+    for (auto const& Path : Paths)
+    {
+        bool bAlreadySelected = false;
+        if (Path.IsValid())
+        {
+            SequenceSet.Add(Path, &bAlreadySelected);
+        }
+        if (Path.IsValid() && !bAlreadySelected)
+        {
+            AnimationSequences.Add(Path);
+        }
+    }
+    return AnimationSequences.Num() - NumBefore;
+}
+
+void UAnimSequenceSelection::RemoveSequences(TArray<FSoftObjectPath> const& Paths)
+{
+    const TSet<FSoftObjectPath> Removed(Paths);
+    AnimationSequences.RemoveAll([&Removed](FSoftObjectPath const& Path) { return Removed.Contains(Path); });
+    ErrorSequences.RemoveAll([&Removed](FSoftObjectPath const& Path) { return Removed.Contains(Path); });
+    SequenceSet = SequenceSet.Difference(Removed);
+}
+
+void UAnimSequenceSelection::ResetSequences()
+{
+    AnimationSequences.Reset();
+    ErrorSequences.Reset();
+    SequenceSet.Reset();
+}
+
+FSoftObjectPath UAnimSequenceSelection::MakeSequencePath(const FString& Reference)
+{
+    FString ObjectPath = Reference;
+    if (!ObjectPath.Contains(TEXT(".")))
+    {
+        ObjectPath += TEXT(".") + FPackageName::GetShortName(ObjectPath);
+    }
+    return FSoftObjectPath(ObjectPath);
+}
+
 bool UAnimJsonSettings::IsInitialized = false;
 UAnimJsonSettings* UAnimJsonSettings::DefaultSetting = nullptr;
 
@@ -41,6 +94,14 @@ bool UAnimCheckSettings::IsInitialized = false;
 UAnimCheckSettings* UAnimCheckSettings::DefaultSetting = nullptr;
 
 void UAnimCheckSettings::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+}
+
+bool UAnimBatchSettings::IsInitialized = false;
+UAnimBatchSettings* UAnimBatchSettings::DefaultSetting = nullptr;
+
+void UAnimBatchSettings::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
 {
     Super::PostEditChangeProperty(PropertyChangedEvent);
 }
\ No newline at end of file
@@ -30,6 +30,18 @@ enum class EAnimFilterType : uint8
     End_With,
 };
 
+// How MarkFootsteps writes the detected steps into a sequence
+UENUM()
+enum class EAnimFootstepOutput : uint8
+{
+    // Footsteps_Curve, alternating -1/1 keys
+    Curve,
+    // Footstep_Event notifies on Footstep_Track
+    Notifies,
+    // L/R sync markers on Footstep_Sync, for marker based sync groups
+    SyncMarkers,
+};
+
 USTRUCT()
 struct FAnimRuleFilter
 {
@@ -91,6 +103,21 @@ struct FAnimRuleFilter
         }
         else return true;
     }
+
+    bool Matches(FString const& Input) const
+    {
+        switch (FilterType)
+        {
+        case EAnimFilterType::Not_Any: return MatchAnimName<EAnimFilterType::Not_Any>(Keywords, Input);
+        case EAnimFilterType::Least_One: return MatchAnimName<EAnimFilterType::Least_One>(Keywords, Input);
+        case EAnimFilterType::Have_All: return MatchAnimName<EAnimFilterType::Have_All>(Keywords, Input);
+        case EAnimFilterType::Not_Start: return MatchAnimName<EAnimFilterType::Not_Start>(Keywords, Input);
+        case EAnimFilterType::Start_With: return MatchAnimName<EAnimFilterType::Start_With>(Keywords, Input);
+        case EAnimFilterType::Not_End: return MatchAnimName<EAnimFilterType::Not_End>(Keywords, Input);
+        case EAnimFilterType::End_With: return MatchAnimName<EAnimFilterType::End_With>(Keywords, Input);
+        default: return true;
+        }
+    }
 };
 
 UCLASS()
@@ -142,6 +169,32 @@ public:
     
     UPROPERTY(EditAnywhere, Category = CheckSetting)
     bool bCheckIfSingleFrameAnim {true};
+
+    // Check Animation answers sequences checked before from their registry tags instead of evaluating them,
+    // as long as their raw data did not change since
+    UPROPERTY(EditAnywhere, Category = CheckSetting)
+    bool bCheckFromRegistryTags {true};
+
+    // Check Animation stores its verdicts on the sequences for bCheckFromRegistryTags. This modifies every
+    // checked sequence whose verdict changed, and they have to be saved for the tags to be published.
+    UPROPERTY(EditAnywhere, Category = CheckSetting)
+    bool bStampCheckResults {false};
+
+    // Memory Audit loads every sequence for exact track/curve/raw sizes instead of reading registry tags
+    UPROPERTY(EditAnywhere, Category = CheckSetting)
+    bool bMemoryAuditLoadAssets {false};
+
+    // Bones Compression Audit compares between raw and compressed data
+    UPROPERTY(EditAnywhere, Category = CheckSetting)
+    TArray<FString> CompressionAuditBones {"LeftHand", "RightHand", "LeftFoot", "RightFoot", "Camera_Root"};
+
+    // Component space position error (cm) above which a sequence is reported as an error
+    UPROPERTY(EditAnywhere, Category = CheckSetting, Meta=(ClampMin=0))
+    float CompressionErrorThreshold {0.1f};
+
+    // Component space rotation error (degrees) above which a sequence is reported as an error
+    UPROPERTY(EditAnywhere, Category = CheckSetting, Meta=(ClampMin=0))
+    float CompressionRotationThreshold {0.5f};
     
     SWidget* m_ParentWidget;
 };
@@ -219,7 +272,7 @@ public:
     SWidget* m_ParentWidget;
 };
 
-UCLASS()
+UCLASS(config = EditorPerProjectUserSettings)
 class UFootstepSettings : public UObject
 {
     GENERATED_BODY()
@@ -267,11 +320,20 @@ public:
     TArray<FString> TrackBoneNames = {"LeftHand", "RightHand"};
 
     UPROPERTY(EditAnywhere, Category=FootstepSetting)
-    bool bUseCurve = true;
+    EAnimFootstepOutput FootstepOutput = EAnimFootstepOutput::Curve;
     
     UPROPERTY(EditAnywhere, Category=FootstepSetting)
     bool IsEnableDebug = false;
 
+    // Mark sequences matching the AnimRuleFilters when they are imported or reimported
+    UPROPERTY(EditAnywhere, config, Category=FootstepSetting)
+    bool bAutoMarkOnImport = false;
+
+    // Mark sequences matching the AnimRuleFilters on save, when their bone tracks changed since the last stamp.
+    // They are marked right after the save and saved again. Names new to the skeleton leave it dirty for the user.
+    UPROPERTY(EditAnywhere, config, Category=FootstepSetting)
+    bool bAutoMarkOnSave = false;
+
     SWidget* m_ParentWidget;
 };
 
@@ -330,6 +392,22 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=CurveSetting)
     bool IsExtractRotationXYZ = true;
 
+    // Optimize Curves: largest value change a key reduction may cause at any frame
+    UPROPERTY(EditAnywhere, Category=CurveSetting, Meta=(ClampMin=0))
+    float CurveOptimizeTolerance = 1e-3f;
+
+    // Remove <Bone>_PosX/PosZ/RotY_Curve left by footstep marking in debug mode
+    UPROPERTY(EditAnywhere, Category=CurveSetting)
+    bool bStripDebugCurves = true;
+
+    // Collapse constant and near-linear curves and drop keys on straight runs
+    UPROPERTY(EditAnywhere, Category=CurveSetting)
+    bool bReduceCurveKeys = true;
+
+    // Duplicated curves are reported either way, gameplay may read them by name
+    UPROPERTY(EditAnywhere, Category=CurveSetting)
+    bool bRemoveDuplicateCurves = false;
+
     SWidget* m_ParentWidget;
 };
 
@@ -382,11 +460,98 @@ public:
     // UPROPERTY(EditAnywhere, Category=SequenceSelection, Meta=(EditCondition="IsImportFromJson", EditConditionHides))
     // FFilePath AnimJsonPath;
 
-    UPROPERTY(EditAnywhere, Category=SequenceSelection)
-    TArray<UAnimSequence*> AnimationSequences;
+    // Soft paths keep a list of tens of thousands of sequences from being resident, a sequence loads only
+    // when an operation processes it. Shown by SAnimSequenceList, a details view does not scale to them.
+    UPROPERTY()
+    TArray<FSoftObjectPath> AnimationSequences;
+
+    UPROPERTY()
+    TArray<FSoftObjectPath> ErrorSequences;
+
+    // Appends the paths not selected yet, returns how many were added
+    int32 AddSequences(TArray<FSoftObjectPath> const& Paths);
+
+    void RemoveSequences(TArray<FSoftObjectPath> const& Paths);
+
+    void ResetSequences();
+
+    // Accepts object paths and the package paths Generate Json writes, e.g. /Game/Anims/Walk
+    static FSoftObjectPath MakeSequencePath(const FString& Reference);
+
+    SWidget* m_ParentWidget;
+
+private:
+    TSet<FSoftObjectPath> SequenceSet;
+};
+
+UCLASS()
+class UAnimBatchSettings : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    UAnimBatchSettings()
+    {
+    }
+
+    static UAnimBatchSettings* Get()
+    {
+        if (!IsInitialized)
+        {
+            DefaultSetting = DuplicateObject(GetMutableDefault<UAnimBatchSettings>(), nullptr);
+            DefaultSetting->AddToRoot();
+            IsInitialized = true;
+        }
+
+        return DefaultSetting;
+    }
+
+    static void Destroy()
+    {
+        if (IsInitialized)
+        {
+            if (UObjectInitialized() && DefaultSetting)
+            {
+                DefaultSetting->RemoveFromRoot();
+                DefaultSetting->MarkPendingKill();
+            }
+
+            DefaultSetting = nullptr;
+            IsInitialized = false;
+        }
+    }
 
-    UPROPERTY(VisibleAnywhere, Category=SequenceSelection)
-    TArray<UAnimSequence*> ErrorSequences;
+    virtual void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
+private:
+    static bool IsInitialized;
+    static UAnimBatchSettings* DefaultSetting; // GCMISMATCH_SKIP_CHECK
+
+public:
+    // Journal completed sequences and save modified packages every SaveWindowSize sequences
+    UPROPERTY(EditAnywhere, Category=BatchSetting)
+    bool bEnableJournal = false;
+
+    UPROPERTY(EditAnywhere, Category=BatchSetting, Meta=(EditCondition="bEnableJournal", EditConditionHides))
+    bool bResumeFromJournal = true;
+
+    UPROPERTY(EditAnywhere, Category=BatchSetting, Meta=(EditCondition="bEnableJournal", EditConditionHides))
+    FDirectoryPath JournalDirectory{FPaths::ProjectSavedDir() / "AnimCurveTool"};
+
+    UPROPERTY(EditAnywhere, Category=BatchSetting, Meta=(EditCondition="bEnableJournal", EditConditionHides, ClampMin=1))
+    int32 SaveWindowSize = 50;
+
+    // Game thread time spent per editor tick on loading and committing sequences
+    UPROPERTY(EditAnywhere, Category=BatchSetting, Meta=(ClampMin=1, Units="ms"))
+    float GameThreadBudgetMs = 8.0f;
+
+    // Sequences loaded, in analysis or waiting for their commit at once, capped at twice the worker threads
+    UPROPERTY(EditAnywhere, Category=BatchSetting, Meta=(ClampMin=1))
+    int32 MaxPendingCommits = 64;
+
+    // Sequences with at least this many frames split their frames across all workers instead of
+    // running on one, 0 always runs one sequence per worker
+    UPROPERTY(EditAnywhere, Category=BatchSetting, Meta=(ClampMin=0))
+    int32 FrameParallelMinFrames = 10000;
 
     SWidget* m_ParentWidget;
-};
\ No newline at end of file
+};
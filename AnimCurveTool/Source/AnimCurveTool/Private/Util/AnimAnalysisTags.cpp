@@ -0,0 +1,212 @@
+﻿#include "AnimAnalysisTags.h"
+
+#include "AnimAnalysisMetadata.h"
+#include "AnimationBlueprintLibrary.h"
+#include "Animation/AnimSequence.h"
+#include "Misc/SecureHash.h"
+#include "UObject/UObjectHash.h"
+
+const FName FAnimAnalysisTags::AnalysisHashTag(TEXT("AnimCurveTool_AnalysisHash"));
+const FName FAnimAnalysisTags::FootstepCountTag(TEXT("AnimCurveTool_FootstepCount"));
+const FName FAnimAnalysisTags::KeyBoneTag(TEXT("AnimCurveTool_KeyBone"));
+const FName FAnimAnalysisTags::CyclePeriodTag(TEXT("AnimCurveTool_CyclePeriod"));
+const FName FAnimAnalysisTags::HasFootstepsCurveTag(TEXT("AnimCurveTool_HasFootstepsCurve"));
+const FName FAnimAnalysisTags::CheckedTag(TEXT("AnimCurveTool_Checked"));
+const FName FAnimAnalysisTags::CheckHashTag(TEXT("AnimCurveTool_CheckHash"));
+const FName FAnimAnalysisTags::RawDataHashTag(TEXT("AnimCurveTool_RawDataHash"));
+const FName FAnimAnalysisTags::SingleFrameTag(TEXT("AnimCurveTool_SingleFrame"));
+const FName FAnimAnalysisTags::CameraRootAtOriginTag(TEXT("AnimCurveTool_CameraRootAtOrigin"));
+
+FDelegateHandle FAnimAnalysisTags::ExtraTagsHandle;
+FDelegateHandle FAnimAnalysisTags::PreSaveHandle;
+TMap<TWeakObjectPtr<const UAnimSequence>, FString> FAnimAnalysisTags::SavedRawDataHashes;
+
+namespace
+{
+    bool GetBoolTag(const FAssetData& AssetData, FName Tag, bool& OutValue)
+    {
+        FString Value;
+        if (!AssetData.GetTagValue(Tag, Value))
+        {
+            return false;
+        }
+        OutValue = Value.ToBool();
+        return true;
+    }
+
+    FString BoolToTag(bool bValue)
+    {
+        return bValue ? TEXT("True") : TEXT("False");
+    }
+}
+
+void FAnimAnalysisTags::Register()
+{
+    ExtraTagsHandle = UObject::FAssetRegistryTag::OnGetExtraObjectTags.AddStatic(
+        &FAnimAnalysisTags::OnGetExtraObjectTags);
+    PreSaveHandle = UPackage::PreSavePackageEvent.AddStatic(&FAnimAnalysisTags::OnPreSavePackage);
+}
+
+void FAnimAnalysisTags::Unregister()
+{
+    UObject::FAssetRegistryTag::OnGetExtraObjectTags.Remove(ExtraTagsHandle);
+    UPackage::PreSavePackageEvent.Remove(PreSaveHandle);
+    SavedRawDataHashes.Empty();
+}
+
+void FAnimAnalysisTags::HashRawData(UAnimSequence* Seq, FSHA1& Sha)
+{
+    auto UpdateWithArray = [&Sha](auto const& Array)
+    {
+        if (Array.Num())
+        {
+            Sha.Update(reinterpret_cast<const uint8*>(Array.GetData()), Array.Num() * Array.GetTypeSize());
+        }
+    };
+
+    for (auto const& TrackName : Seq->GetAnimationTrackNames())
+    {
+        Sha.UpdateWithString(*TrackName.ToString(), TrackName.GetStringLength());
+    }
+    for (auto const& Track : Seq->GetRawAnimationData())
+    {
+        UpdateWithArray(Track.PosKeys);
+        UpdateWithArray(Track.RotKeys);
+        UpdateWithArray(Track.ScaleKeys);
+    }
+    const int32 NumFrames = Seq->GetRawNumberOfFrames();
+    Sha.Update(reinterpret_cast<const uint8*>(&NumFrames), sizeof(NumFrames));
+    Sha.Update(reinterpret_cast<const uint8*>(&Seq->SequenceLength), sizeof(Seq->SequenceLength));
+}
+
+FString FAnimAnalysisTags::ComputeRawDataHash(UAnimSequence* Seq)
+{
+    FSHA1 Sha;
+    HashRawData(Seq, Sha);
+    Sha.Final();
+
+    uint8 Digest[FSHA1::DigestSize];
+    Sha.GetHash(Digest);
+    return BytesToHex(Digest, FSHA1::DigestSize);
+}
+
+UAnimAnalysisMetadata* FAnimAnalysisTags::FindMetadata(const UAnimSequence* Seq)
+{
+    // GetAssetUserDataOfClass is not const, it only reads though
+    return Cast<UAnimAnalysisMetadata>(
+        const_cast<UAnimSequence*>(Seq)->GetAssetUserDataOfClass(UAnimAnalysisMetadata::StaticClass()));
+}
+
+UAnimAnalysisMetadata* FAnimAnalysisTags::FindOrAddMetadata(UAnimSequence* Seq)
+{
+    auto Metadata = FindMetadata(Seq);
+    if (!Metadata)
+    {
+        Metadata = NewObject<UAnimAnalysisMetadata>(Seq, NAME_None, RF_Transactional);
+        Seq->AddAssetUserData(Metadata);
+    }
+    return Metadata;
+}
+
+void FAnimAnalysisTags::StampCheck(UAnimSequence* Seq, bool bSingleFrame, bool bCameraRootAtOrigin)
+{
+    const FString CheckHash = ComputeRawDataHash(Seq);
+    auto Metadata = FindMetadata(Seq);
+    if (Metadata && Metadata->bChecked && Metadata->CheckHash == CheckHash && Metadata->bSingleFrame == bSingleFrame
+        && Metadata->bCameraRootAtOrigin == bCameraRootAtOrigin)
+    {
+        return;
+    }
+    Metadata = FindOrAddMetadata(Seq);
+    Metadata->Modify();
+    Metadata->bChecked = true;
+    Metadata->CheckHash = CheckHash;
+    Metadata->bSingleFrame = bSingleFrame;
+    Metadata->bCameraRootAtOrigin = bCameraRootAtOrigin;
+    Seq->MarkPackageDirty();
+}
+
+void FAnimAnalysisTags::OnGetExtraObjectTags(const UObject* Object, TArray<UObject::FAssetRegistryTag>& OutTags)
+{
+    auto Seq = Cast<const UAnimSequence>(Object);
+    auto Metadata = Seq ? FindMetadata(Seq) : nullptr;
+    if (!Metadata)
+    {
+        return;
+    }
+
+    using FTag = UObject::FAssetRegistryTag;
+    OutTags.Emplace(AnalysisHashTag, Metadata->AnalysisHash, FTag::TT_Hidden);
+    OutTags.Emplace(FootstepCountTag, LexToString(Metadata->FootstepCount), FTag::TT_Numerical);
+    OutTags.Emplace(KeyBoneTag, Metadata->KeyBone, FTag::TT_Alphabetical);
+    OutTags.Emplace(CyclePeriodTag, LexToString(Metadata->CyclePeriod), FTag::TT_Numerical);
+    OutTags.Emplace(HasFootstepsCurveTag, BoolToTag(UAnimationBlueprintLibrary::DoesCurveExist(
+                        const_cast<UAnimSequence*>(Seq), TEXT("Footsteps_Curve"), ERawCurveTrackTypes::RCT_Float)),
+                    FTag::TT_Alphabetical);
+    OutTags.Emplace(CheckedTag, BoolToTag(Metadata->bChecked), FTag::TT_Hidden);
+    if (Metadata->bChecked)
+    {
+        OutTags.Emplace(CheckHashTag, Metadata->CheckHash, FTag::TT_Hidden);
+        if (auto RawDataHash = SavedRawDataHashes.Find(Seq))
+        {
+            OutTags.Emplace(RawDataHashTag, *RawDataHash, FTag::TT_Hidden);
+        }
+        OutTags.Emplace(SingleFrameTag, BoolToTag(Metadata->bSingleFrame), FTag::TT_Alphabetical);
+        OutTags.Emplace(CameraRootAtOriginTag, BoolToTag(Metadata->bCameraRootAtOrigin), FTag::TT_Alphabetical);
+    }
+}
+
+void FAnimAnalysisTags::OnPreSavePackage(UPackage* Package)
+{
+    ForEachObjectWithPackage(Package, [](UObject* Object)
+    {
+        auto Seq = Cast<UAnimSequence>(Object);
+        auto Metadata = Seq ? FindMetadata(Seq) : nullptr;
+        if (Metadata && Metadata->bChecked)
+        {
+            SavedRawDataHashes.Add(Seq, ComputeRawDataHash(Seq));
+        }
+        return true;
+    }, false);
+}
+
+bool FAnimAnalysisTags::Read(const FAssetData& AssetData, FAnimAnalysisTagValues& OutValues)
+{
+    // Sequences only checked have no hash
+    const bool bAnalysed = AssetData.GetTagValue(AnalysisHashTag, OutValues.AnalysisHash)
+        && !OutValues.AnalysisHash.IsEmpty();
+    GetBoolTag(AssetData, CheckedTag, OutValues.bChecked);
+    if (!bAnalysed && !OutValues.bChecked)
+    {
+        return false;
+    }
+    AssetData.GetTagValue(FootstepCountTag, OutValues.FootstepCount);
+    AssetData.GetTagValue(KeyBoneTag, OutValues.KeyBone);
+    AssetData.GetTagValue(CyclePeriodTag, OutValues.CyclePeriod);
+    GetBoolTag(AssetData, HasFootstepsCurveTag, OutValues.bHasFootstepsCurve);
+    AssetData.GetTagValue(CheckHashTag, OutValues.CheckHash);
+    AssetData.GetTagValue(RawDataHashTag, OutValues.RawDataHash);
+    GetBoolTag(AssetData, SingleFrameTag, OutValues.bSingleFrame);
+    GetBoolTag(AssetData, CameraRootAtOriginTag, OutValues.bCameraRootAtOrigin);
+    return true;
+}
+
+bool FAnimAnalysisTags::TryGetCheckResult(const FAssetData& AssetData, bool bCheckCameraRootAtOrigin,
+                                          bool bCheckSingleFrameAnim, bool& bOutPassed)
+{
+    FAnimAnalysisTagValues Values;
+    if (!Read(AssetData, Values) || !Values.bChecked || Values.CheckHash.IsEmpty()
+        || Values.CheckHash != Values.RawDataHash)
+    {
+        return false;
+    }
+    // Tags describe the last save, unsaved edits are checked from the loaded sequence
+    auto Package = FindObject<UPackage>(nullptr, *AssetData.PackageName.ToString());
+    if (Package && Package->IsDirty())
+    {
+        return false;
+    }
+    bOutPassed = (!bCheckCameraRootAtOrigin || Values.bCameraRootAtOrigin)
+        && (!bCheckSingleFrameAnim || !Values.bSingleFrame);
+    return true;
+}
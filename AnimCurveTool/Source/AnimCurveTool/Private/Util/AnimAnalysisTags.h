@@ -0,0 +1,77 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetData.h"
+
+class FSHA1;
+class UAnimSequence;
+class UAnimAnalysisMetadata;
+
+// Analysis results as read back from the asset registry
+struct FAnimAnalysisTagValues
+{
+    FString AnalysisHash;
+    int32 FootstepCount = 0;
+    FString KeyBone;
+    float CyclePeriod = 0.0f;
+    bool bHasFootstepsCurve = false;
+
+    bool bChecked = false;
+    // Raw data hash the check ran on, and the one of the last save. A verdict is only valid if they match.
+    FString CheckHash;
+    FString RawDataHash;
+    bool bSingleFrame = false;
+    bool bCameraRootAtOrigin = true;
+};
+
+/*
+ * Publishes UAnimAnalysisMetadata, plus whether Footsteps_Curve exists, as asset registry tags when a
+ * sequence is saved. Tags are as fresh as the last save after a commit, queries that need more fall
+ * back to loading. The raw data hash of checked sequences is computed before each save, so a check
+ * verdict is dropped once the tracks change under it.
+ */
+class FAnimAnalysisTags
+{
+public:
+    static const FName AnalysisHashTag;
+    static const FName FootstepCountTag;
+    static const FName KeyBoneTag;
+    static const FName CyclePeriodTag;
+    static const FName HasFootstepsCurveTag;
+    static const FName CheckedTag;
+    static const FName CheckHashTag;
+    static const FName RawDataHashTag;
+    static const FName SingleFrameTag;
+    static const FName CameraRootAtOriginTag;
+
+    static void Register();
+    static void Unregister();
+
+    static UAnimAnalysisMetadata* FindMetadata(const UAnimSequence* Seq);
+    static UAnimAnalysisMetadata* FindOrAddMetadata(UAnimSequence* Seq);
+
+    // Bone tracks, frame count and length, what both footstep marking and Check Animation read
+    static void HashRawData(UAnimSequence* Seq, FSHA1& Sha);
+    static FString ComputeRawDataHash(UAnimSequence* Seq);
+
+    // Stamps Check Animation results, only dirties the package when they changed. Only called when the
+    // run is asked to persist them, a check alone does not modify sequences.
+    static void StampCheck(UAnimSequence* Seq, bool bSingleFrame, bool bCameraRootAtOrigin);
+
+    // False when the sequence was never analysed by this tool
+    static bool Read(const FAssetData& AssetData, FAnimAnalysisTagValues& OutValues);
+
+    // Check Animation verdict from the tags alone, false when the sequence was never checked, its raw data
+    // changed since, or it has unsaved edits
+    static bool TryGetCheckResult(const FAssetData& AssetData, bool bCheckCameraRootAtOrigin,
+                                  bool bCheckSingleFrameAnim, bool& bOutPassed);
+
+private:
+    static void OnGetExtraObjectTags(const UObject* Object, TArray<UObject::FAssetRegistryTag>& OutTags);
+    static void OnPreSavePackage(UPackage* Package);
+
+    static FDelegateHandle ExtraTagsHandle;
+    static FDelegateHandle PreSaveHandle;
+    // Raw data hash of checked sequences as of their last save, the tag query itself stays cheap
+    static TMap<TWeakObjectPtr<const UAnimSequence>, FString> SavedRawDataHashes;
+};
@@ -0,0 +1,117 @@
+﻿#include "AnimBatchJournal.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimBatchJournal, Log, All);
+
+FAnimBatchJournal::FAnimBatchJournal(const FString& InJournalPath, const FString& InRunHash, bool bResume)
+    : JournalPath(FPaths::ConvertRelativePathToFull(InJournalPath))
+    , RunHash(InRunHash)
+{
+    if (bResume)
+    {
+        Load();
+    }
+
+    // Rewritten from the accepted records, so a torn tail never prefixes the next record
+    Writer.Reset(IFileManager::Get().CreateFileWriter(*JournalPath, FILEWRITE_AllowRead));
+    if (!Writer)
+    {
+        UE_LOG(LogAnimBatchJournal, Warning, TEXT("Fail to open journal %s, progress will not be resumable"),
+               *JournalPath);
+        return;
+    }
+    FString Lines = FString::Printf(TEXT("RUN\t%s\n"), *RunHash);
+    for (auto const& Record : CommittedRecords)
+    {
+        Lines += FString::Printf(TEXT("%s\t%s\n"), Record.Value ? TEXT("OK") : TEXT("ERR"), *Record.Key);
+    }
+    FTCHARToUTF8 Utf8Lines(*Lines);
+    Writer->Serialize(const_cast<ANSICHAR*>(Utf8Lines.Get()), Utf8Lines.Length());
+    Writer->Flush();
+}
+
+void FAnimBatchJournal::Load()
+{
+    FString Content;
+    if (!FFileHelper::LoadFileToString(Content, *JournalPath))
+    {
+        return;
+    }
+    // Only newline terminated records were written completely, a torn last line after a crash is dropped
+    int32 LastNewline = INDEX_NONE;
+    Content.FindLastChar(TEXT('\n'), LastNewline);
+    Content.LeftInline(LastNewline + 1, false);
+
+    TArray<FString> Lines;
+    Content.ParseIntoArrayLines(Lines);
+    FString Status, Value;
+    if (Lines.Num() == 0 || !Lines[0].Split(TEXT("\t"), &Status, &Value) || Status != TEXT("RUN")
+        || Value != RunHash)
+    {
+        UE_LOG(LogAnimBatchJournal, Warning, TEXT("%s belongs to another list or other options, start over"),
+               *JournalPath);
+        return;
+    }
+    for (int32 i = 1; i < Lines.Num(); ++i)
+    {
+        FString SequencePath;
+        if (Lines[i].Split(TEXT("\t"), &Status, &SequencePath) && (Status == TEXT("OK") || Status == TEXT("ERR")))
+        {
+            CommittedRecords.Add(SequencePath, Status == TEXT("OK"));
+        }
+    }
+    UE_LOG(LogAnimBatchJournal, Log, TEXT("Resume from %s, %d sequences already committed"), *JournalPath,
+           CommittedRecords.Num());
+}
+
+FAnimBatchJournal::~FAnimBatchJournal()
+{
+    // Pending records belong to packages that may not be saved, drop them
+    Writer.Reset();
+}
+
+FString FAnimBatchJournal::MakeJournalPath(const FString& JournalDir, const FString& OperationName)
+{
+    return JournalDir / OperationName + TEXT(".journal");
+}
+
+void FAnimBatchJournal::Record(const FString& SequencePath, bool bSucceeded)
+{
+    PendingRecords.Emplace(SequencePath, bSucceeded);
+}
+
+void FAnimBatchJournal::Flush()
+{
+    if (PendingRecords.Num() == 0)
+    {
+        return;
+    }
+
+    FString Lines;
+    for (auto const& Record : PendingRecords)
+    {
+        Lines += Record.Value ? TEXT("OK\t") : TEXT("ERR\t");
+        Lines += Record.Key;
+        Lines += TEXT("\n");
+        CommittedRecords.Add(Record.Key, Record.Value);
+    }
+    PendingRecords.Reset();
+
+    if (Writer)
+    {
+        FTCHARToUTF8 Utf8Lines(*Lines);
+        Writer->Serialize(const_cast<ANSICHAR*>(Utf8Lines.Get()), Utf8Lines.Length());
+        Writer->Flush();
+    }
+}
+
+void FAnimBatchJournal::Finish()
+{
+    Flush();
+    Writer.Reset();
+    IFileManager::Get().Delete(*JournalPath, false, true, true);
+    CommittedRecords.Reset();
+}
@@ -0,0 +1,52 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+ * Append-only per-sequence completion log of a batch run, one "OK|ERR <tab> SequencePath" line per record
+ * after a "RUN <tab> RunHash" header. Records stay pending until Flush(), call it only after the window's
+ * packages are saved, so that a restarted run skips exactly the sequences whose results are on disk.
+ * A journal written for another list or other options is not resumed.
+ */
+class FAnimBatchJournal
+{
+public:
+    // RunHash identifies the list and options of the run, see FAnimBatchUtils::ComputeRunHash
+    FAnimBatchJournal(const FString& InJournalPath, const FString& InRunHash, bool bResume);
+
+    ~FAnimBatchJournal();
+
+    static FString MakeJournalPath(const FString& JournalDir, const FString& OperationName);
+
+    bool IsCommitted(const FString& SequencePath) const
+    {
+        return CommittedRecords.Contains(SequencePath);
+    }
+
+    bool IsCommittedError(const FString& SequencePath) const
+    {
+        const bool* bSucceeded = CommittedRecords.Find(SequencePath);
+        return bSucceeded && !*bSucceeded;
+    }
+
+    int32 NumCommitted() const { return CommittedRecords.Num(); }
+
+    void Record(const FString& SequencePath, bool bSucceeded);
+
+    void Flush();
+
+    // The window these records belong to was not saved, they are redone after a restart.
+    void DiscardPending() { PendingRecords.Reset(); }
+
+    // The run went through the whole list, the next one starts from scratch.
+    void Finish();
+
+private:
+    void Load();
+
+    FString JournalPath;
+    FString RunHash;
+    TMap<FString, bool> CommittedRecords;
+    TArray<TPair<FString, bool>> PendingRecords;
+    TUniquePtr<FArchive> Writer;
+};
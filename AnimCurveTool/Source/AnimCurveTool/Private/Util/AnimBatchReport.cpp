@@ -0,0 +1,298 @@
+﻿#include "AnimBatchReport.h"
+
+#include "AnimCurveToolStats.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimBatchReport, Log, All);
+
+DEFINE_STAT(STAT_AnimCurveTool_Load);
+DEFINE_STAT(STAT_AnimCurveTool_PoseExtraction);
+DEFINE_STAT(STAT_AnimCurveTool_CurveBuild);
+DEFINE_STAT(STAT_AnimCurveTool_FootstepDetection);
+DEFINE_STAT(STAT_AnimCurveTool_NotifyInsertion);
+DEFINE_STAT(STAT_AnimCurveTool_CurveExport);
+DEFINE_STAT(STAT_AnimCurveTool_CurveOptimize);
+DEFINE_STAT(STAT_AnimCurveTool_Save);
+DEFINE_STAT(STAT_AnimCurveTool_Sequences);
+DEFINE_STAT(STAT_AnimCurveTool_Frames);
+DEFINE_STAT(STAT_AnimCurveTool_Bones);
+DEFINE_STAT(STAT_AnimCurveTool_CacheHits);
+DEFINE_STAT(STAT_AnimCurveTool_BytesWritten);
+DEFINE_STAT(STAT_AnimCurveTool_CurveFindings);
+DEFINE_STAT(STAT_AnimCurveTool_CurvesRemoved);
+DEFINE_STAT(STAT_AnimCurveTool_CurveKeysRemoved);
+DEFINE_STAT(STAT_AnimCurveTool_CurveBytesSaved);
+DEFINE_STAT(STAT_AnimCurveTool_FrameRanges);
+
+namespace
+{
+    constexpr int32 NumStages = static_cast<int32>(EAnimBatchStage::Num);
+    constexpr int32 NumCounters = static_cast<int32>(EAnimBatchCounter::Num);
+
+    thread_local FAnimBatchReport* CurrentReport = nullptr;
+    thread_local FString CurrentSequencePath;
+    thread_local FAnimBatchReport::FStageScope* CurrentStage = nullptr;
+
+    typedef TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>> FPrettyJsonStringWriterFactory;
+    typedef TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>> FPrettyJsonStringWriter;
+
+    // Nearest-rank percentile of sorted values
+    double Percentile(const TArray<double>& SortedValues, double P)
+    {
+        if (SortedValues.Num() == 0)
+        {
+            return 0.0;
+        }
+        const int32 Rank = FMath::CeilToInt(P * SortedValues.Num()) - 1;
+        return SortedValues[FMath::Clamp(Rank, 0, SortedValues.Num() - 1)];
+    }
+
+    TSharedRef<FJsonObject> MakeDistribution(TArray<double>& Values)
+    {
+        Values.Sort();
+        double Total = 0.0;
+        for (auto Value : Values)
+        {
+            Total += Value;
+        }
+        auto JsonObj = MakeShared<FJsonObject>();
+        JsonObj->SetNumberField(TEXT("Count"), Values.Num());
+        JsonObj->SetNumberField(TEXT("Total"), Total);
+        JsonObj->SetNumberField(TEXT("P50"), Percentile(Values, 0.5));
+        JsonObj->SetNumberField(TEXT("P90"), Percentile(Values, 0.9));
+        JsonObj->SetNumberField(TEXT("P99"), Percentile(Values, 0.99));
+        JsonObj->SetNumberField(TEXT("Max"), Values.Num() ? Values.Last() : 0.0);
+        return JsonObj;
+    }
+}
+
+FAnimBatchReport::FAnimBatchReport(FString InRunName)
+    : RunName(MoveTemp(InRunName))
+    , StartTime(FPlatformTime::Seconds())
+{
+}
+
+FAnimBatchReport::FSequenceScope::FSequenceScope(FAnimBatchReport* Report, FString SequencePath)
+    : PrevReport(CurrentReport)
+    , PrevSequencePath(MoveTemp(CurrentSequencePath))
+{
+    CurrentReport = Report;
+    CurrentSequencePath = MoveTemp(SequencePath);
+}
+
+FAnimBatchReport::FSequenceScope::~FSequenceScope()
+{
+    CurrentReport = PrevReport;
+    CurrentSequencePath = MoveTemp(PrevSequencePath);
+}
+
+FAnimBatchReport::FStageScope::FStageScope(EAnimBatchStage InStage)
+    : Stage(InStage)
+    , StartTime(FPlatformTime::Seconds())
+    , Parent(CurrentStage)
+{
+    CurrentStage = this;
+}
+
+FAnimBatchReport::FStageScope::~FStageScope()
+{
+    const double Elapsed = FPlatformTime::Seconds() - StartTime;
+    CurrentStage = Parent;
+    if (Parent)
+    {
+        Parent->ChildSeconds += Elapsed;
+    }
+    if (CurrentReport)
+    {
+        CurrentReport->AddStageTime(CurrentSequencePath, Stage, Elapsed - ChildSeconds);
+    }
+}
+
+FAnimBatchReport* FAnimBatchReport::GetCurrent()
+{
+    return CurrentReport;
+}
+
+void FAnimBatchReport::Count(EAnimBatchCounter Counter, int64 Amount)
+{
+    if (CurrentReport)
+    {
+        CurrentReport->AddCount(Counter, Amount);
+    }
+}
+
+int64 FAnimBatchReport::GetPackagesFileSize(const TArray<UPackage*>& Packages)
+{
+    int64 Bytes = 0;
+    for (auto Package : Packages)
+    {
+        const auto Filename = FPackageName::LongPackageNameToFilename(Package->GetName(),
+                                                                      FPackageName::GetAssetPackageExtension());
+        Bytes += FMath::Max<int64>(IFileManager::Get().FileSize(*Filename), 0);
+    }
+    return Bytes;
+}
+
+const TCHAR* FAnimBatchReport::LexToString(EAnimBatchStage Stage)
+{
+    switch (Stage)
+    {
+    case EAnimBatchStage::Load: return TEXT("Load");
+    case EAnimBatchStage::PoseExtraction: return TEXT("PoseExtraction");
+    case EAnimBatchStage::CurveBuild: return TEXT("CurveBuild");
+    case EAnimBatchStage::FootstepDetection: return TEXT("FootstepDetection");
+    case EAnimBatchStage::NotifyInsertion: return TEXT("NotifyInsertion");
+    case EAnimBatchStage::CurveExport: return TEXT("CurveExport");
+    case EAnimBatchStage::CurveOptimize: return TEXT("CurveOptimize");
+    case EAnimBatchStage::Save: return TEXT("Save");
+    default: return TEXT("Unknown");
+    }
+}
+
+const TCHAR* FAnimBatchReport::LexToString(EAnimBatchCounter Counter)
+{
+    switch (Counter)
+    {
+    case EAnimBatchCounter::Sequences: return TEXT("Sequences");
+    case EAnimBatchCounter::Frames: return TEXT("Frames");
+    case EAnimBatchCounter::Bones: return TEXT("Bones");
+    case EAnimBatchCounter::CacheHits: return TEXT("CacheHits");
+    case EAnimBatchCounter::BytesWritten: return TEXT("BytesWritten");
+    case EAnimBatchCounter::CurveFindings: return TEXT("CurveFindings");
+    case EAnimBatchCounter::CurvesRemoved: return TEXT("CurvesRemoved");
+    case EAnimBatchCounter::CurveKeysRemoved: return TEXT("CurveKeysRemoved");
+    case EAnimBatchCounter::CurveBytesSaved: return TEXT("CurveBytesSaved");
+    case EAnimBatchCounter::FrameRanges: return TEXT("FrameRanges");
+    default: return TEXT("Unknown");
+    }
+}
+
+double FAnimBatchReport::FSequenceTimes::Total() const
+{
+    double Total = 0.0;
+    for (auto Seconds : Stages)
+    {
+        Total += Seconds;
+    }
+    return Total;
+}
+
+void FAnimBatchReport::AddStageTime(const FString& SequencePath, EAnimBatchStage Stage, double Seconds)
+{
+    FScopeLock ScopeLock(&Lock);
+    auto& Times = SequencePath.IsEmpty() ? Unattributed : Sequences.FindOrAdd(SequencePath);
+    Times.Stages[static_cast<int32>(Stage)] += Seconds;
+}
+
+void FAnimBatchReport::AddCount(EAnimBatchCounter Counter, int64 Amount)
+{
+    FScopeLock ScopeLock(&Lock);
+    Counters[static_cast<int32>(Counter)] += Amount;
+}
+
+FString FAnimBatchReport::GetDefaultDirectory()
+{
+    return FPaths::ProjectSavedDir() / TEXT("AnimCurveTool") / TEXT("Reports");
+}
+
+bool FAnimBatchReport::Write(const FString& Directory, int32 NumSlowest /* = 20 */) const
+{
+    FScopeLock ScopeLock(&Lock);
+    const auto BasePath = FPaths::ConvertRelativePathToFull(
+        Directory / FString::Printf(TEXT("%s_%s"), *RunName, *FDateTime::Now().ToString()));
+
+    auto JsonObj = MakeShared<FJsonObject>();
+    JsonObj->SetStringField(TEXT("Run"), RunName);
+    JsonObj->SetNumberField(TEXT("WallSeconds"), FPlatformTime::Seconds() - StartTime);
+
+    auto CountersObj = MakeShared<FJsonObject>();
+    for (int32 i = 0; i < NumCounters; ++i)
+    {
+        CountersObj->SetNumberField(LexToString(static_cast<EAnimBatchCounter>(i)), Counters[i]);
+    }
+    JsonObj->SetObjectField(TEXT("Counters"), CountersObj);
+
+    // Percentiles over the sequences that went through a stage
+    auto StagesObj = MakeShared<FJsonObject>();
+    for (int32 i = 0; i < NumStages; ++i)
+    {
+        TArray<double> Values;
+        for (auto const& Pair : Sequences)
+        {
+            if (Pair.Value.Stages[i] > 0.0)
+            {
+                Values.Add(Pair.Value.Stages[i]);
+            }
+        }
+        auto StageObj = MakeDistribution(Values);
+        StageObj->SetNumberField(TEXT("Unattributed"), Unattributed.Stages[i]);
+        StagesObj->SetObjectField(LexToString(static_cast<EAnimBatchStage>(i)), StageObj);
+    }
+    JsonObj->SetObjectField(TEXT("Stages"), StagesObj);
+
+    TArray<TPair<double, const FString*>> Totals;
+    TArray<double> TotalValues;
+    for (auto const& Pair : Sequences)
+    {
+        Totals.Emplace(Pair.Value.Total(), &Pair.Key);
+        TotalValues.Add(Pair.Value.Total());
+    }
+    JsonObj->SetObjectField(TEXT("Sequence"), MakeDistribution(TotalValues));
+
+    Totals.Sort([](TPair<double, const FString*> const& A, TPair<double, const FString*> const& B)
+    {
+        return A.Key > B.Key;
+    });
+    TArray<TSharedPtr<FJsonValue>> SlowestValues;
+    for (int32 i = 0; i < FMath::Min(NumSlowest, Totals.Num()); ++i)
+    {
+        auto SequenceObj = MakeShared<FJsonObject>();
+        SequenceObj->SetStringField(TEXT("Path"), *Totals[i].Value);
+        SequenceObj->SetNumberField(TEXT("Seconds"), Totals[i].Key);
+        auto const& Times = Sequences[*Totals[i].Value];
+        for (int32 Stage = 0; Stage < NumStages; ++Stage)
+        {
+            SequenceObj->SetNumberField(LexToString(static_cast<EAnimBatchStage>(Stage)), Times.Stages[Stage]);
+        }
+        SlowestValues.Push(MakeShared<FJsonValueObject>(SequenceObj));
+    }
+    JsonObj->SetArrayField(TEXT("Slowest"), SlowestValues);
+
+    FString JsonString;
+    TSharedRef<FPrettyJsonStringWriter> Writer = FPrettyJsonStringWriterFactory::Create(&JsonString);
+    if (!FJsonSerializer::Serialize(JsonObj, Writer) ||
+        !FFileHelper::SaveStringToFile(JsonString, *(BasePath + TEXT(".json"))))
+    {
+        UE_LOG(LogAnimBatchReport, Error, TEXT("Fail to write report %s.json"), *BasePath);
+        return false;
+    }
+
+    FString CsvString = TEXT("Sequence,Total");
+    for (int32 i = 0; i < NumStages; ++i)
+    {
+        CsvString += FString::Printf(TEXT(",%s"), LexToString(static_cast<EAnimBatchStage>(i)));
+    }
+    CsvString += LINE_TERMINATOR;
+    for (auto const& Pair : Sequences)
+    {
+        CsvString += FString::Printf(TEXT("\"%s\",%.6f"), *Pair.Key, Pair.Value.Total());
+        for (int32 i = 0; i < NumStages; ++i)
+        {
+            CsvString += FString::Printf(TEXT(",%.6f"), Pair.Value.Stages[i]);
+        }
+        CsvString += LINE_TERMINATOR;
+    }
+    if (!FFileHelper::SaveStringToFile(CsvString, *(BasePath + TEXT(".csv"))))
+    {
+        UE_LOG(LogAnimBatchReport, Error, TEXT("Fail to write report %s.csv"), *BasePath);
+        return false;
+    }
+
+    UE_LOG(LogAnimBatchReport, Display, TEXT("Performance report written to %s.json"), *BasePath);
+    return true;
+}
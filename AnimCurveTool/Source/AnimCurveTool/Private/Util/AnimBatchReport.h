@@ -0,0 +1,108 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+// Stages a sequence goes through, every FAnimCurveUtils entry point is timed as one of them.
+enum class EAnimBatchStage : uint8
+{
+    Load,
+    PoseExtraction,
+    CurveBuild,
+    FootstepDetection,
+    NotifyInsertion,
+    CurveExport,
+    CurveOptimize,
+    Save,
+    Num
+};
+
+enum class EAnimBatchCounter : uint8
+{
+    Sequences,
+    Frames,
+    Bones,
+    CacheHits,
+    BytesWritten,
+    CurveFindings,
+    CurvesRemoved,
+    CurveKeysRemoved,
+    CurveBytesSaved,
+    FrameRanges,
+    Num
+};
+
+/*
+ * Per-run timings of a batch. Stage scopes and counters on any thread are attributed to the report and
+ * sequence bound to that thread by an FSequenceScope, stage times are exclusive of nested stages so the
+ * stages of a sequence add up to its wall time. Without a bound report the scopes only feed the stats.
+ */
+class FAnimBatchReport
+{
+public:
+    explicit FAnimBatchReport(FString InRunName);
+
+    // Binds the calling thread to a report and sequence, an empty path records time no sequence owns.
+    class FSequenceScope
+    {
+    public:
+        FSequenceScope(FAnimBatchReport* Report, FString SequencePath);
+
+        ~FSequenceScope();
+
+    private:
+        FAnimBatchReport* PrevReport;
+        FString PrevSequencePath;
+    };
+
+    class FStageScope
+    {
+    public:
+        explicit FStageScope(EAnimBatchStage InStage);
+
+        ~FStageScope();
+
+    private:
+        EAnimBatchStage Stage;
+        double StartTime;
+        double ChildSeconds = 0.0;
+        FStageScope* Parent;
+    };
+
+    static FAnimBatchReport* GetCurrent();
+
+    static void Count(EAnimBatchCounter Counter, int64 Amount);
+
+    // On-disk size of saved packages, for the BytesWritten counter.
+    static int64 GetPackagesFileSize(const TArray<UPackage*>& Packages);
+
+    static const TCHAR* LexToString(EAnimBatchStage Stage);
+
+    static const TCHAR* LexToString(EAnimBatchCounter Counter);
+
+    void AddStageTime(const FString& SequencePath, EAnimBatchStage Stage, double Seconds);
+
+    void AddCount(EAnimBatchCounter Counter, int64 Amount);
+
+    // Writes <Dir>/<RunName>_<Timestamp>.json with per-stage totals and percentiles, counters and the
+    // NumSlowest slowest sequences, and a .csv next to it with the stage times of every sequence.
+    bool Write(const FString& Directory, int32 NumSlowest = 20) const;
+
+    static FString GetDefaultDirectory();
+
+private:
+    struct FSequenceTimes
+    {
+        double Stages[static_cast<int32>(EAnimBatchStage::Num)] = {};
+
+        double Total() const;
+    };
+
+    FString RunName;
+    double StartTime;
+
+    mutable FCriticalSection Lock;
+    TMap<FString, FSequenceTimes> Sequences;
+    // Stage time no sequence owns, such as window saves
+    FSequenceTimes Unattributed;
+    int64 Counters[static_cast<int32>(EAnimBatchCounter::Num)] = {};
+};
@@ -0,0 +1,269 @@
+﻿#include "AnimBatchTask.h"
+
+#include "AnimCurveToolStats.h"
+#include "AnimCurveUtils.h"
+#include "Animation/AnimSequence.h"
+#include "Async/Async.h"
+#include "UObject/UObjectGlobals.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimBatchTask, Log, All);
+
+FAnimBatchTask::FAnimBatchTask(EAnimBatchOperation InOperation, TArray<FString> InSequencePaths,
+                               FAnimBatchOptions InOptions, TUniquePtr<FAnimBatchJournal> InJournal,
+                               int32 InSaveWindowSize, int32 InMaxInFlight,
+                               TSharedRef<FAnimGameThreadExecutor> InExecutor)
+    : RunName(FAnimBatchUtils::LexToString(InOperation))
+    , Analyze([InOperation, InOptions](UAnimSequence* Seq)
+    {
+        return FAnimBatchUtils::AnalyzeOperation(InOperation, Seq, InOptions);
+    })
+    , SequencePaths(MoveTemp(InSequencePaths))
+    , Options(MoveTemp(InOptions))
+    , Journal(MoveTemp(InJournal))
+    , SaveWindow(Journal.Get(), InSaveWindowSize)
+    , Report(RunName)
+    , Executor(InExecutor)
+    , WorkersIdleEvent(MakeShared<FEventRef, ESPMode::ThreadSafe>(EEventMode::ManualReset))
+    , MaxInFlight(FMath::Clamp(FPlatformMisc::NumberOfWorkerThreadsToSpawn() * 2, 1, FMath::Max(InMaxInFlight, 1)))
+{
+}
+
+FAnimBatchTask::FAnimBatchTask(FString InRunName, FAnalyzeFunction InAnalyze, TArray<FString> InSequencePaths,
+                               int32 InMaxInFlight, TSharedRef<FAnimGameThreadExecutor> InExecutor)
+    : RunName(MoveTemp(InRunName))
+    , Analyze(MoveTemp(InAnalyze))
+    , SequencePaths(MoveTemp(InSequencePaths))
+    , SaveWindow(nullptr, 0)
+    , Report(RunName)
+    , Executor(InExecutor)
+    , WorkersIdleEvent(MakeShared<FEventRef, ESPMode::ThreadSafe>(EEventMode::ManualReset))
+    , MaxInFlight(FMath::Clamp(FPlatformMisc::NumberOfWorkerThreadsToSpawn() * 2, 1, FMath::Max(InMaxInFlight, 1)))
+{
+}
+
+FAnimBatchTask::~FAnimBatchTask()
+{
+    // Queued commits capture this and must never run
+    Executor->Shutdown();
+    FCoreUObjectDelegates::OnObjectModified.Remove(ObjectModifiedHandle);
+    // Workers read sequences this object keeps alive. The event is reset before each wait, a trigger left
+    // over from an earlier idle moment would otherwise release every wait while a worker still runs.
+    while (NumRunningWorkers.GetValue() > 0)
+    {
+        (*WorkersIdleEvent)->Reset();
+        // The last worker may have finished, and triggered, right before the reset
+        if (NumRunningWorkers.GetValue() == 0)
+        {
+            break;
+        }
+        if (!(*WorkersIdleEvent)->Wait(FTimespan::FromSeconds(5.0)))
+        {
+            UE_LOG(LogAnimBatchTask, Warning, TEXT("Waiting for %d analysis workers to finish"),
+                   NumRunningWorkers.GetValue());
+        }
+    }
+}
+
+void FAnimBatchTask::Start()
+{
+    check(IsInGameThread());
+    StartTime = FPlatformTime::Seconds();
+    bRunning = true;
+    ObjectModifiedHandle = FCoreUObjectDelegates::OnObjectModified.AddSP(this, &FAnimBatchTask::OnObjectModified);
+    Executor->Start();
+    for (int32 i = 0; i < MaxInFlight; ++i)
+    {
+        ScheduleLoad();
+    }
+}
+
+void FAnimBatchTask::Cancel()
+{
+    bCancelled = true;
+}
+
+double FAnimBatchTask::GetThroughput() const
+{
+    const double Elapsed = FPlatformTime::Seconds() - StartTime;
+    return Elapsed > 0.0 ? NumProcessed / Elapsed : 0.0;
+}
+
+double FAnimBatchTask::GetEstimatedSecondsLeft() const
+{
+    const double Throughput = GetThroughput();
+    return Throughput > 0.0 ? (GetNumTotal() - NumFinished) / Throughput : 0.0;
+}
+
+void FAnimBatchTask::AddReferencedObjects(FReferenceCollector& Collector)
+{
+    for (auto& Pair : InFlightSequences)
+    {
+        Collector.AddReferencedObject(Pair.Value);
+    }
+}
+
+void FAnimBatchTask::ScheduleLoad()
+{
+    Executor->Enqueue([this]() { LoadNext(); });
+}
+
+void FAnimBatchTask::LoadNext()
+{
+    if (bCancelled || NextIndex >= SequencePaths.Num())
+    {
+        TryFinish();
+        return;
+    }
+
+    const int32 Index = NextIndex++;
+    auto const& Path = SequencePaths[Index];
+    FAnimBatchReport::FSequenceScope SequenceScope(&Report, Path);
+    if (Journal && Journal->IsCommitted(Path))
+    {
+        ANIMCURVETOOL_COUNT(CacheHits, 1);
+        const bool bSucceeded = !Journal->IsCommittedError(Path);
+        (bSucceeded ? Result.ProcessedSequences : Result.ErrorSequences).Add(Path);
+        ++NumFinished;
+        OnItemFinished.ExecuteIfBound(Path, bSucceeded, 0.0);
+        ScheduleLoad();
+        return;
+    }
+
+    const double LoadStart = FPlatformTime::Seconds();
+    UAnimSequence* Seq = nullptr;
+    {
+        ANIMCURVETOOL_STAGE_SCOPE(Load);
+        Seq = LoadObject<UAnimSequence>(nullptr, *Path);
+    }
+    if (!Seq)
+    {
+        UE_LOG(LogAnimBatchTask, Warning, TEXT("Load Failed from %s"), *Path);
+        SaveWindow.Add(Path, nullptr, false);
+        FinishItem(Index, false, FPlatformTime::Seconds() - LoadStart);
+        ScheduleLoad();
+        return;
+    }
+
+    InFlightSequences.Add(Index, Seq);
+    NumRunningWorkers.Increment();
+    // Short sequences run one per worker, a long one splits its frames across the pool while the
+    // other workers keep going. Further long ones meanwhile stay on their own worker.
+    const bool bFrameParallel = Options.FrameParallelMinFrames > 0
+        && Seq->GetNumberOfFrames() >= Options.FrameParallelMinFrames && NumFrameParallelWorkers.GetValue() == 0;
+    if (bFrameParallel)
+    {
+        NumFrameParallelWorkers.Increment();
+    }
+    const double LoadSeconds = FPlatformTime::Seconds() - LoadStart;
+    Async(EAsyncExecution::ThreadPool, [this, Index, Seq, LoadSeconds, bFrameParallel,
+                                        WorkersIdle = WorkersIdleEvent]()
+    {
+        FAnimBatchReport::FSequenceScope SequenceScope(&Report, SequencePaths[Index]);
+        FAnimCurveUtils::FFrameParallelScope FrameParallelScope(bFrameParallel ? Options.FrameParallelMinFrames : 0);
+        const double AnalysisStart = FPlatformTime::Seconds();
+        const bool bDropped = bCancelled;
+        TFunction<bool()> Commit;
+        if (!bDropped)
+        {
+            Commit = Analyze(Seq);
+        }
+        const double Seconds = LoadSeconds + FPlatformTime::Seconds() - AnalysisStart;
+        if (bFrameParallel)
+        {
+            NumFrameParallelWorkers.Decrement();
+        }
+        Executor->Enqueue([this, Index, Commit = MoveTemp(Commit), Seconds, bDropped]()
+        {
+            CommitItem(Index, Commit, Seconds, bDropped);
+        });
+        // Last access to this task, it may be destroyed right after
+        if (NumRunningWorkers.Decrement() == 0)
+        {
+            (*WorkersIdle)->Trigger();
+        }
+    });
+}
+
+void FAnimBatchTask::CommitItem(int32 Index, TFunction<bool()> const& Commit, double Seconds, bool bDropped)
+{
+    auto Seq = InFlightSequences.FindAndRemoveChecked(Index);
+    if (ModifiedSequences.Remove(Index) && !bDropped)
+    {
+        // Not journaled, a rerun analyses the edited sequence
+        UE_LOG(LogAnimBatchTask, Warning, TEXT("%s was modified during analysis, its results are discarded"),
+               *SequencePaths[Index]);
+        FinishItem(Index, false, Seconds);
+    }
+    else if (!bDropped)
+    {
+        const double CommitStart = FPlatformTime::Seconds();
+        bool bSucceeded = false;
+        {
+            FAnimBatchReport::FSequenceScope SequenceScope(&Report, SequencePaths[Index]);
+            TGuardValue<bool> CommittingGuard(bCommitting, true);
+            bSucceeded = Commit && Commit();
+        }
+        FAnimBatchReport::FSequenceScope WindowScope(&Report, FString());
+        SaveWindow.Add(SequencePaths[Index], Seq, bSucceeded);
+        FinishItem(Index, bSucceeded, Seconds + FPlatformTime::Seconds() - CommitStart);
+    }
+    // Dropped items are not journaled, a resumed run picks them up
+
+    ScheduleLoad();
+}
+
+void FAnimBatchTask::OnObjectModified(UObject* Object)
+{
+    if (bCommitting || !Object || !IsInGameThread())
+    {
+        return;
+    }
+    const auto Package = Object->GetOutermost();
+    for (auto const& Pair : InFlightSequences)
+    {
+        if (Pair.Value->GetOutermost() == Package)
+        {
+            ModifiedSequences.Add(Pair.Key);
+        }
+    }
+}
+
+void FAnimBatchTask::FinishItem(int32 Index, bool bSucceeded, double Seconds)
+{
+    auto const& Path = SequencePaths[Index];
+    (bSucceeded ? Result.ProcessedSequences : Result.ErrorSequences).Add(Path);
+    ++NumFinished;
+    ++NumProcessed;
+    INC_DWORD_STAT(STAT_AnimCurveTool_Sequences);
+    Report.AddCount(EAnimBatchCounter::Sequences, 1);
+    OnItemFinished.ExecuteIfBound(Path, bSucceeded, Seconds);
+}
+
+void FAnimBatchTask::TryFinish()
+{
+    if (bRunning && (bCancelled || NextIndex >= SequencePaths.Num()) && InFlightSequences.Num() == 0)
+    {
+        Finish();
+    }
+}
+
+void FAnimBatchTask::Finish()
+{
+    bRunning = false;
+    FCoreUObjectDelegates::OnObjectModified.Remove(ObjectModifiedHandle);
+    {
+        FAnimBatchReport::FSequenceScope WindowScope(&Report, FString());
+        SaveWindow.Commit();
+    }
+    if (Journal && !bCancelled)
+    {
+        Journal->Finish();
+    }
+    Executor->Shutdown();
+
+    UE_LOG(LogAnimBatchTask, Log, TEXT("%s %s: %d/%d finished, %d errors, %.1f sequences/s"),
+           *RunName, bCancelled ? TEXT("cancelled") : TEXT("done"), NumFinished,
+           GetNumTotal(), Result.ErrorSequences.Num(), GetThroughput());
+    Report.Write(FAnimBatchReport::GetDefaultDirectory());
+    OnFinished.ExecuteIfBound();
+}
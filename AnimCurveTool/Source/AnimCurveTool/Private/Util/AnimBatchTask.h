@@ -0,0 +1,116 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimBatchJournal.h"
+#include "AnimBatchReport.h"
+#include "AnimBatchUtils.h"
+#include "AnimGameThreadExecutor.h"
+#include "HAL/Event.h"
+#include "UObject/GCObject.h"
+
+/*
+ * Runs one batch operation without blocking the editor. Sequences are loaded and committed through the
+ * time-sliced game thread executor, the read-only analysis of each sequence runs on the thread pool.
+ * Cancelling keeps the journal, so a cancelled run resumes like a crashed one.
+ */
+class FAnimBatchTask : public TSharedFromThis<FAnimBatchTask>, public FGCObject
+{
+public:
+    DECLARE_DELEGATE_ThreeParams(FOnItemFinished, const FString& /* SequencePath */, bool /* bSucceeded */,
+                                 double /* Seconds */);
+    DECLARE_DELEGATE(FOnFinished);
+
+    // Worker thread half of an item, like FAnimBatchUtils::AnalyzeOperation
+    typedef TFunction<TFunction<bool()>(UAnimSequence*)> FAnalyzeFunction;
+
+    FAnimBatchTask(EAnimBatchOperation InOperation, TArray<FString> InSequencePaths, FAnimBatchOptions InOptions,
+                   TUniquePtr<FAnimBatchJournal> InJournal, int32 InSaveWindowSize, int32 InMaxInFlight,
+                   TSharedRef<FAnimGameThreadExecutor> InExecutor);
+
+    // Read-only runs such as the audits, nothing is journaled or saved. Commits collect the results.
+    FAnimBatchTask(FString InRunName, FAnalyzeFunction InAnalyze, TArray<FString> InSequencePaths,
+                   int32 InMaxInFlight, TSharedRef<FAnimGameThreadExecutor> InExecutor);
+
+    virtual ~FAnimBatchTask();
+
+    void Start();
+
+    void Cancel();
+
+    bool IsRunning() const { return bRunning; }
+
+    bool IsCancelled() const { return bCancelled; }
+
+    FString const& GetRunName() const { return RunName; }
+
+    int32 GetNumTotal() const { return SequencePaths.Num(); }
+
+    int32 GetNumFinished() const { return NumFinished; }
+
+    // Sequences per second processed by this run, journal skips excluded
+    double GetThroughput() const;
+
+    double GetEstimatedSecondsLeft() const;
+
+    // Analysed sequences waiting for their game thread commit
+    int32 GetNumPendingCommits() const { return Executor->GetNumPending(); }
+
+    FAnimBatchResult const& GetResult() const { return Result; }
+
+    // Called on the game thread as soon as a sequence is committed
+    FOnItemFinished OnItemFinished;
+
+    FOnFinished OnFinished;
+
+    virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+
+    virtual FString GetReferencerName() const override { return TEXT("FAnimBatchTask"); }
+
+private:
+    void ScheduleLoad();
+
+    void LoadNext();
+
+    void CommitItem(int32 Index, TFunction<bool()> const& Commit, double Seconds, bool bDropped);
+
+    // Edits made to an in-flight sequence while it is analysed would be overwritten by its commit
+    void OnObjectModified(UObject* Object);
+
+    void TryFinish();
+
+    void FinishItem(int32 Index, bool bSucceeded, double Seconds);
+
+    void Finish();
+
+    FString RunName;
+    FAnalyzeFunction Analyze;
+    TArray<FString> SequencePaths;
+    FAnimBatchOptions Options;
+    TUniquePtr<FAnimBatchJournal> Journal;
+    FAnimBatchSaveWindow SaveWindow;
+    FAnimBatchResult Result;
+    FAnimBatchReport Report;
+
+    TSharedRef<FAnimGameThreadExecutor> Executor;
+
+    // Sequences between load and commit, kept alive for the worker threads. At most MaxInFlight, a load
+    // is only scheduled when a commit frees its slot, which bounds the results waiting in memory.
+    TMap<int32, UAnimSequence*> InFlightSequences;
+    FThreadSafeCounter NumRunningWorkers;
+    // Shared with the workers, which trigger it after their last access to this task. Only the destructor
+    // waits on it and resets it first.
+    TSharedRef<FEventRef, ESPMode::ThreadSafe> WorkersIdleEvent;
+    TSet<int32> ModifiedSequences;
+    FDelegateHandle ObjectModifiedHandle;
+    bool bCommitting = false;
+    // Long sequences currently extracted frame-parallel, at most one so they do not fight over the pool
+    FThreadSafeCounter NumFrameParallelWorkers;
+    int32 MaxInFlight;
+
+    int32 NextIndex = 0;
+    int32 NumFinished = 0;
+    int32 NumProcessed = 0;
+    double StartTime = 0.0;
+    FThreadSafeBool bCancelled = false;
+    bool bRunning = false;
+};
@@ -0,0 +1,578 @@
+﻿#include "AnimBatchUtils.h"
+
+#include "AnimAnalysisTags.h"
+#include "AnimBatchJournal.h"
+#include "AnimCurveOptimizer.h"
+#include "AnimCurveToolStats.h"
+#include "AnimCurveUtils.h"
+#include "AnimFootstepAutoMarker.h"
+#include "AnimValidation.h"
+#include "AssetRegistryModule.h"
+#include "Dom/JsonObject.h"
+#include "FileHelpers.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "UI/AnimToolSettings.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimBatchUtil, Log, All);
+
+namespace
+{
+    const TCHAR* SequencesField = TEXT("AnimSequences");
+    const TCHAR* ProcessedField = TEXT("Processed");
+    const TCHAR* ErrorsField = TEXT("Errors");
+    const TCHAR* RunHashField = TEXT("RunHash");
+    const TCHAR* NumShardsField = TEXT("NumShards");
+
+    typedef TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>> FPrettyJsonStringWriterFactory;
+    typedef TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>> FPrettyJsonStringWriter;
+
+    TSharedPtr<FJsonObject> LoadJsonObject(const FString& JsonPath)
+    {
+        FString FileContents;
+        if (!FFileHelper::LoadFileToString(FileContents, *JsonPath))
+        {
+            return nullptr;
+        }
+
+        TSharedPtr<FJsonObject> JsonObj;
+        TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(FileContents);
+        if (!FJsonSerializer::Deserialize(Reader, JsonObj) || !JsonObj.IsValid())
+        {
+            return nullptr;
+        }
+        return JsonObj;
+    }
+
+    bool SaveJsonObject(const FString& JsonPath, TSharedRef<FJsonObject> const& JsonObj)
+    {
+        FString OutputString;
+        TSharedRef<FPrettyJsonStringWriter> Writer = FPrettyJsonStringWriterFactory::Create(&OutputString);
+        if (!FJsonSerializer::Serialize(JsonObj, Writer))
+        {
+            return false;
+        }
+        return FFileHelper::SaveStringToFile(OutputString, *FPaths::ConvertRelativePathToFull(JsonPath),
+                                             FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(),
+                                             FILEWRITE_None);
+    }
+
+    TArray<TSharedPtr<FJsonValue>> ToJsonArray(const TArray<FString>& Strings)
+    {
+        TArray<TSharedPtr<FJsonValue>> Values;
+        Values.Reserve(Strings.Num());
+        for (auto const& String : Strings)
+        {
+            Values.Push(MakeShared<FJsonValueString>(String));
+        }
+        return Values;
+    }
+
+    void FromJsonArray(TSharedPtr<FJsonObject> const& JsonObj, const TCHAR* Field, TArray<FString>& OutStrings)
+    {
+        const TArray<TSharedPtr<FJsonValue>>* Values = nullptr;
+        if (JsonObj->TryGetArrayField(Field, Values))
+        {
+            for (auto const& Value : *Values)
+            {
+                OutStrings.Add(Value->AsString());
+            }
+        }
+    }
+}
+
+const TCHAR* FAnimBatchUtils::LexToString(EAnimBatchOperation Operation)
+{
+    switch (Operation)
+    {
+    case EAnimBatchOperation::MarkFootsteps: return TEXT("MarkFootsteps");
+    case EAnimBatchOperation::ExtractCurves: return TEXT("ExtractCurves");
+    case EAnimBatchOperation::CheckAnimation: return TEXT("CheckAnimation");
+    case EAnimBatchOperation::OptimizeCurves: return TEXT("OptimizeCurves");
+    default: return TEXT("Unknown");
+    }
+}
+
+bool FAnimBatchUtils::LexFromString(EAnimBatchOperation& OutOperation, const TCHAR* Name)
+{
+    const EAnimBatchOperation Operations[] =
+    {
+        EAnimBatchOperation::MarkFootsteps,
+        EAnimBatchOperation::ExtractCurves,
+        EAnimBatchOperation::CheckAnimation,
+        EAnimBatchOperation::OptimizeCurves,
+    };
+    for (auto Operation : Operations)
+    {
+        if (FCString::Stricmp(Name, LexToString(Operation)) == 0)
+        {
+            OutOperation = Operation;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FAnimBatchUtils::LoadSequenceList(const FString& JsonPath, TArray<FString>& OutSequencePaths)
+{
+    const auto JsonObj = LoadJsonObject(JsonPath);
+    if (!JsonObj.IsValid())
+    {
+        return false;
+    }
+    FromJsonArray(JsonObj, SequencesField, OutSequencePaths);
+    return true;
+}
+
+bool FAnimBatchUtils::SaveSequenceList(const FString& JsonPath, const TArray<FString>& SequencePaths)
+{
+    TSharedRef<FJsonObject> JsonObj = MakeShared<FJsonObject>();
+    JsonObj->SetArrayField(SequencesField, ToJsonArray(SequencePaths));
+    return SaveJsonObject(JsonPath, JsonObj);
+}
+
+bool FAnimBatchUtils::LoadBatchResult(const FString& JsonPath, FAnimBatchResult& OutResult)
+{
+    const auto JsonObj = LoadJsonObject(JsonPath);
+    if (!JsonObj.IsValid())
+    {
+        return false;
+    }
+    FromJsonArray(JsonObj, ProcessedField, OutResult.ProcessedSequences);
+    FromJsonArray(JsonObj, ErrorsField, OutResult.ErrorSequences);
+    return true;
+}
+
+bool FAnimBatchUtils::SaveBatchResult(const FString& JsonPath, FAnimBatchResult const& Result)
+{
+    TSharedRef<FJsonObject> JsonObj = MakeShared<FJsonObject>();
+    JsonObj->SetArrayField(ProcessedField, ToJsonArray(Result.ProcessedSequences));
+    JsonObj->SetArrayField(ErrorsField, ToJsonArray(Result.ErrorSequences));
+    // Errors are also written in the Generate Json format, so they can be loaded back into the tool.
+    JsonObj->SetArrayField(SequencesField, ToJsonArray(Result.ErrorSequences));
+    return SaveJsonObject(JsonPath, JsonObj);
+}
+
+FString FAnimBatchUtils::ComputeRunHash(EAnimBatchOperation Operation, const TArray<FString>& SequencePaths,
+                                       FAnimBatchOptions const& Options)
+{
+    // Scheduling options like FrameParallelMinFrames do not change the results and stay out
+    FString Settings = FString::Printf(
+        TEXT("%s|%s|%d|%d|%s|%s|%u|%d|%d|%d|%g|%d|%d|%d"), LexToString(Operation),
+        *FString::Join(Options.KeyBones, TEXT(",")), static_cast<int32>(Options.FootstepOutput), Options.bDebug,
+        *Options.TargetBoneName, *Options.ExportDirectory, Options.SaveFlags, Options.bCheckCameraRootAtOrigin,
+        Options.bCheckSingleFrameAnim, Options.bStampCheckResults, Options.CurveTolerance, Options.bStripDebugCurves, Options.bReduceCurveKeys,
+        Options.bRemoveDuplicateCurves);
+
+    FSHA1 Sha;
+    Sha.UpdateWithString(*Settings, Settings.Len());
+    for (auto const& Path : SequencePaths)
+    {
+        Sha.UpdateWithString(*Path, Path.Len());
+    }
+    Sha.Final();
+
+    uint8 Digest[FSHA1::DigestSize];
+    Sha.GetHash(Digest);
+    return BytesToHex(Digest, FSHA1::DigestSize);
+}
+
+int64 FAnimBatchUtils::EstimateSequenceCost(const FAssetData& AssetData)
+{
+    // Neither frame count nor bone count is a registry tag of a stock AnimSequence, but raw tracks
+    // dominate the package, so its size on disk grows with frames x animated bones.
+    FString Filename;
+    if (FPackageName::DoesPackageExist(AssetData.PackageName.ToString(), nullptr, &Filename))
+    {
+        return FMath::Max<int64>(IFileManager::Get().FileSize(*Filename), 1);
+    }
+    return 1;
+}
+
+void FAnimBatchUtils::SplitIntoShards(const TArray<FString>& SequencePaths, int32 NumShards,
+                                      TArray<FAnimBatchShard>& OutShards)
+{
+    FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(
+        "AssetRegistry");
+
+    TArray<TPair<int64, FString>> CostedPaths;
+    CostedPaths.Reserve(SequencePaths.Num());
+    for (auto const& Path : SequencePaths)
+    {
+        // Generate Json lists package names, the registry is keyed by object path
+        const auto ObjectPath = UAnimSequenceSelection::MakeSequencePath(Path);
+        const auto AssetData = AssetRegistryModule.Get().GetAssetByObjectPath(*ObjectPath.ToString());
+        CostedPaths.Emplace(AssetData.IsValid() ? EstimateSequenceCost(AssetData) : 1, Path);
+    }
+    CostedPaths.Sort([](auto const& A, auto const& B) { return A.Key > B.Key; });
+
+    OutShards.Reset();
+    OutShards.SetNum(FMath::Clamp(NumShards, 1, FMath::Max(SequencePaths.Num(), 1)));
+    for (auto const& CostedPath : CostedPaths)
+    {
+        // Always feed the currently cheapest shard
+        int32 Cheapest = 0;
+        for (int i = 1; i < OutShards.Num(); ++i)
+        {
+            if (OutShards[i].EstimatedCost < OutShards[Cheapest].EstimatedCost)
+            {
+                Cheapest = i;
+            }
+        }
+        OutShards[Cheapest].SequencePaths.Add(CostedPath.Value);
+        OutShards[Cheapest].EstimatedCost += CostedPath.Key;
+    }
+}
+
+FAnimBatchOptions FAnimBatchOptions::FromSettings()
+{
+    check(IsInGameThread());
+    FAnimBatchOptions Options;
+
+    const auto FootstepSetting = UFootstepSettings::Get();
+    Options.KeyBones = FootstepSetting->TrackBoneNames;
+    Options.FootstepOutput = FootstepSetting->FootstepOutput;
+    Options.bDebug = FootstepSetting->IsEnableDebug;
+
+    const auto AnimCurveSetting = UAnimCurveSettings::Get();
+    Options.TargetBoneName = AnimCurveSetting->TargetBoneName;
+    Options.ExportDirectory = AnimCurveSetting->ExportDirectoryPath.Path;
+    Options.SaveFlags = 0;
+    Options.SaveFlags |= AnimCurveSetting->IsExtractPositionXYZ ? 0xf0 : 0x00;
+    Options.SaveFlags |= AnimCurveSetting->IsExtractRotationXYZ ? 0x0f : 0x00;
+    Options.CurveTolerance = AnimCurveSetting->CurveOptimizeTolerance;
+    Options.bStripDebugCurves = AnimCurveSetting->bStripDebugCurves;
+    Options.bReduceCurveKeys = AnimCurveSetting->bReduceCurveKeys;
+    Options.bRemoveDuplicateCurves = AnimCurveSetting->bRemoveDuplicateCurves;
+
+    const auto CheckSetting = UAnimCheckSettings::Get();
+    Options.bCheckCameraRootAtOrigin = CheckSetting->bCheckIfCameraRootAtOrigin;
+    Options.bCheckSingleFrameAnim = CheckSetting->bCheckIfSingleFrameAnim;
+    Options.bStampCheckResults = CheckSetting->bStampCheckResults;
+
+    Options.FrameParallelMinFrames = UAnimBatchSettings::Get()->FrameParallelMinFrames;
+    return Options;
+}
+
+bool FAnimBatchUtils::RunOperation(EAnimBatchOperation Operation, UAnimSequence* Seq,
+                                   FAnimBatchOptions const& Options)
+{
+    const auto Commit = AnalyzeOperation(Operation, Seq, Options);
+    return Commit && Commit();
+}
+
+TFunction<bool()> FAnimBatchUtils::AnalyzeOperation(EAnimBatchOperation Operation, UAnimSequence* Seq,
+                                                    FAnimBatchOptions const& Options)
+{
+    switch (Operation)
+    {
+    case EAnimBatchOperation::MarkFootsteps:
+        {
+            FAnimCurveUtils::FFootstepAnalysis Analysis;
+            if (!FAnimCurveUtils::AnalyzeFootstepsFor1PAnimation(Seq, Options.KeyBones, Analysis, Options.bDebug))
+            {
+                UE_LOG(LogAnimBatchUtil, Log, TEXT("[%s] may not be suitable for footstep recognition."),
+                       *Seq->GetName());
+                if (Analysis.DebugCurves.Num() == 0)
+                {
+                    return nullptr;
+                }
+            }
+            const EAnimFootstepOutput Output = Options.FootstepOutput;
+            FString AnalysisHash = FAnimFootstepAutoMarker::ComputeAnalysisHash(Seq, Options.KeyBones, Output,
+                                                                                Options.bDebug);
+            return [Seq, Output, AnalysisHash = MoveTemp(AnalysisHash), Analysis = MoveTemp(Analysis)]()
+            {
+                FAnimCurveUtils::ApplyFootsteps(Seq, Analysis, Output);
+                FAnimFootstepAutoMarker::Stamp(Seq, AnalysisHash, Analysis);
+                return Analysis.Markers.Num() > 0;
+            };
+        }
+    case EAnimBatchOperation::ExtractCurves:
+        {
+            FVectorCurve PosCurve, RotCurve;
+            if (Options.SaveFlags && !FAnimCurveUtils::BuildBoneCurves(Seq, Options.TargetBoneName, PosCurve, RotCurve))
+            {
+                UE_LOG(LogAnimBatchUtil, Warning, TEXT("[%s->%s]: Error ocurrs when save bone curves!"),
+                       *Seq->GetName(), *Options.TargetBoneName);
+                return nullptr;
+            }
+            return [Seq, Options, PosCurve = MoveTemp(PosCurve), RotCurve = MoveTemp(RotCurve)]()
+            {
+                return FAnimCurveUtils::SaveBonesCurves(Seq, Options.TargetBoneName, Options.ExportDirectory,
+                                                        Options.SaveFlags, PosCurve, RotCurve);
+            };
+        }
+    case EAnimBatchOperation::CheckAnimation:
+        {
+            // Every rule runs, so the registry stamp answers any later combination of options
+            FAnimValidationResult Validation;
+            FAnimValidationEngine::GetDefault().Validate(Seq, Validation);
+            const bool bCameraRootAtOrigin = Validation.HasPassed(FAnimValidationEngine::CameraRootAtOriginRule);
+            const bool bSingleFrame = !Validation.HasPassed(FAnimValidationEngine::SingleFrameRule);
+            const bool bPassed = (!Options.bCheckCameraRootAtOrigin || bCameraRootAtOrigin)
+                && (!Options.bCheckSingleFrameAnim || !bSingleFrame);
+            const bool bStamp = Options.bStampCheckResults;
+            return [Seq, bPassed, bSingleFrame, bCameraRootAtOrigin, bStamp]()
+            {
+                if (bStamp)
+                {
+                    FAnimAnalysisTags::StampCheck(Seq, bSingleFrame, bCameraRootAtOrigin);
+                }
+                return bPassed;
+            };
+        }
+    case EAnimBatchOperation::OptimizeCurves:
+        {
+            FAnimCurveOptimizeOptions OptimizeOptions;
+            OptimizeOptions.Tolerance = Options.CurveTolerance;
+            OptimizeOptions.bStripDebugCurves = Options.bStripDebugCurves;
+            OptimizeOptions.bReduceKeys = Options.bReduceCurveKeys;
+            OptimizeOptions.bRemoveDuplicates = Options.bRemoveDuplicateCurves;
+            TArray<FAnimCurveEdit> Edits;
+            FAnimCurveOptimizer::Analyze(Seq, OptimizeOptions, Edits);
+            return [Seq, Edits = MoveTemp(Edits)]()
+            {
+                FAnimCurveOptimizer::Apply(Seq, Edits);
+                return true;
+            };
+        }
+    default:
+        return nullptr;
+    }
+}
+
+void FAnimBatchUtils::RunBatch(EAnimBatchOperation Operation, const TArray<FString>& SequencePaths,
+                               FAnimBatchOptions const& Options, FAnimBatchJournal* Journal,
+                               int32 SaveWindowSize, FAnimBatchResult& OutResult,
+                               FAnimBatchReport* Report /* = nullptr */)
+{
+    FAnimBatchReport::FSequenceScope RunScope(Report, FString());
+    // Sequences run one after another here, so a long one may take every core
+    FAnimCurveUtils::FFrameParallelScope FrameParallelScope(Options.FrameParallelMinFrames);
+    FAnimBatchSaveWindow SaveWindow(Journal, SaveWindowSize);
+    for (auto const& Path : SequencePaths)
+    {
+        if (Journal && Journal->IsCommitted(Path))
+        {
+            ANIMCURVETOOL_COUNT(CacheHits, 1);
+            (Journal->IsCommittedError(Path) ? OutResult.ErrorSequences : OutResult.ProcessedSequences).Add(Path);
+            continue;
+        }
+
+        UAnimSequence* Seq = nullptr;
+        bool bSucceeded = false;
+        {
+            FAnimBatchReport::FSequenceScope SequenceScope(Report, Path);
+            {
+                ANIMCURVETOOL_STAGE_SCOPE(Load);
+                Seq = LoadObject<UAnimSequence>(nullptr, *Path);
+            }
+            bSucceeded = Seq && RunOperation(Operation, Seq, Options);
+            ANIMCURVETOOL_COUNT(Sequences, 1);
+        }
+        if (!Seq)
+        {
+            UE_LOG(LogAnimBatchUtil, Warning, TEXT("Load Failed from %s"), *Path);
+        }
+        (bSucceeded ? OutResult.ProcessedSequences : OutResult.ErrorSequences).Add(Path);
+        SaveWindow.Add(Path, Seq, bSucceeded);
+    }
+    SaveWindow.Commit();
+}
+
+void FAnimBatchSaveWindow::Add(const FString& SequencePath, UAnimSequence* Seq, bool bSucceeded)
+{
+    if (Journal)
+    {
+        Journal->Record(SequencePath, bSucceeded);
+    }
+    // Skeletons shared by several workers are not saved, missing curve names are re-added on load.
+    if (Seq && Seq->GetOutermost()->IsDirty())
+    {
+        WindowPackages.AddUnique(Seq->GetOutermost());
+    }
+    if (SaveWindowSize > 0 && ++WindowCount >= SaveWindowSize)
+    {
+        Commit();
+    }
+}
+
+void FAnimBatchSaveWindow::Commit()
+{
+    // A window save belongs to no single sequence
+    FAnimBatchReport::FSequenceScope WindowScope(FAnimBatchReport::GetCurrent(), FString());
+    ANIMCURVETOOL_STAGE_SCOPE(Save);
+    if (SaveWindowSize > 0 && WindowPackages.Num() &&
+        !UEditorLoadingAndSavingUtils::SavePackages(WindowPackages, true))
+    {
+        UE_LOG(LogAnimBatchUtil, Error, TEXT("Fail to save %d modified packages"), WindowPackages.Num());
+        if (Journal)
+        {
+            Journal->DiscardPending();
+        }
+    }
+    else
+    {
+        if (SaveWindowSize > 0)
+        {
+            ANIMCURVETOOL_COUNT(BytesWritten, FAnimBatchReport::GetPackagesFileSize(WindowPackages));
+        }
+        if (Journal)
+        {
+            Journal->Flush();
+        }
+    }
+    WindowPackages.Reset();
+    WindowCount = 0;
+
+    if (IsRunningCommandlet())
+    {
+        CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+    }
+}
+
+bool FAnimBatchUtils::RunShardedWorkers(EAnimBatchOperation Operation, const TArray<FString>& SequencePaths,
+                                        FAnimBatchOptions const& Options, int32 NumWorkers, bool bResume,
+                                        const FString& ExtraWorkerParams, FAnimBatchResult& OutResult)
+{
+    const auto ShardDir = FPaths::ConvertRelativePathToFull(
+        FPaths::ProjectIntermediateDir() / TEXT("AnimCurveTool") / TEXT("Shards"));
+    const auto PlanPath = ShardDir / TEXT("Shards.json");
+    const auto Executable = FPlatformProcess::ExecutablePath();
+
+    // Shard costs are package sizes, which the workers' saves change, so a rerun could not rebuild the same
+    // shards. The assignment of an unfinished run is reused instead, the worker journals only match it.
+    const auto PlanHash = FString::Printf(TEXT("%s|%d"), *ComputeRunHash(Operation, SequencePaths, Options),
+                                          NumWorkers);
+    TArray<FAnimBatchShard> Shards;
+    bool bReusePlan = false;
+    const auto PlanObj = bResume ? LoadJsonObject(PlanPath) : nullptr;
+    if (PlanObj.IsValid() && PlanObj->GetStringField(RunHashField) == PlanHash)
+    {
+        Shards.SetNum(static_cast<int32>(PlanObj->GetNumberField(NumShardsField)));
+        bReusePlan = Shards.Num() > 0;
+        for (int i = 0; i < Shards.Num() && bReusePlan; ++i)
+        {
+            bReusePlan = LoadSequenceList(ShardDir / FString::Printf(TEXT("Shard_%d.json"), i),
+                                          Shards[i].SequencePaths);
+        }
+    }
+    if (bReusePlan)
+    {
+        UE_LOG(LogAnimBatchUtil, Log, TEXT("Resume the %d shards of %s"), Shards.Num(), *PlanPath);
+    }
+    else
+    {
+        IFileManager::Get().Delete(*PlanPath, false, true, true);
+        SplitIntoShards(SequencePaths, NumWorkers, Shards);
+    }
+
+    // The plan is only written once every shard list is, a partial one is never reused
+    TBitArray<> ListsWritten(true, Shards.Num());
+    if (!bReusePlan)
+    {
+        for (int i = 0; i < Shards.Num(); ++i)
+        {
+            const auto ListPath = ShardDir / FString::Printf(TEXT("Shard_%d.json"), i);
+            ListsWritten[i] = SaveSequenceList(ListPath, Shards[i].SequencePaths);
+            if (!ListsWritten[i])
+            {
+                UE_LOG(LogAnimBatchUtil, Error, TEXT("Fail to write shard list %s"), *ListPath);
+            }
+        }
+        TSharedRef<FJsonObject> Plan = MakeShared<FJsonObject>();
+        Plan->SetStringField(RunHashField, PlanHash);
+        Plan->SetNumberField(NumShardsField, Shards.Num());
+        if (ListsWritten.Find(false) != INDEX_NONE || !SaveJsonObject(PlanPath, Plan))
+        {
+            UE_LOG(LogAnimBatchUtil, Warning, TEXT("Fail to write %s, an interrupted run will start over"),
+                   *PlanPath);
+        }
+    }
+
+    struct FWorker
+    {
+        FProcHandle Handle;
+        FString ResultPath;
+        int32 Shard;
+    };
+    TArray<FWorker> Workers;
+    for (int i = 0; i < Shards.Num(); ++i)
+    {
+        const auto ListPath = ShardDir / FString::Printf(TEXT("Shard_%d.json"), i);
+        const auto ResultPath = ShardDir / FString::Printf(TEXT("Shard_%d_Result.json"), i);
+        const auto JournalPath = ShardDir / FString::Printf(TEXT("Shard_%d.journal"), i);
+        if (bReusePlan && IFileManager::Get().FileExists(*ResultPath))
+        {
+            // Written last by a worker that went through its whole shard
+            UE_LOG(LogAnimBatchUtil, Log, TEXT("Shard %d already completed"), i);
+            Workers.Add({FProcHandle(), ResultPath, i});
+            continue;
+        }
+        IFileManager::Get().Delete(*ResultPath, false, true, true);
+        if (!ListsWritten[i])
+        {
+            // Reported as errors, so the result can be loaded back and rerun
+            OutResult.ErrorSequences.Append(Shards[i].SequencePaths);
+            continue;
+        }
+
+        const auto Params = FString::Printf(
+            TEXT("\"%s\" -run=AnimCurveTool -Op=%s -List=\"%s\" -Result=\"%s\" -Journal=\"%s\" %s -unattended -nopause -nosplash"),
+            *FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath()), LexToString(Operation), *ListPath,
+            *ResultPath, *JournalPath, *ExtraWorkerParams);
+        auto Handle = FPlatformProcess::CreateProc(Executable, *Params, false, true, true, nullptr, 0, nullptr,
+                                                   nullptr);
+        if (!Handle.IsValid())
+        {
+            UE_LOG(LogAnimBatchUtil, Error, TEXT("Fail to launch worker for shard %d"), i);
+            OutResult.ErrorSequences.Append(Shards[i].SequencePaths);
+            continue;
+        }
+        UE_LOG(LogAnimBatchUtil, Log, TEXT("Shard %d: %d sequences, estimated cost %lld"), i,
+               Shards[i].SequencePaths.Num(), Shards[i].EstimatedCost);
+        Workers.Add({Handle, ResultPath, i});
+    }
+
+    bool bAllSucceeded = Workers.Num() == Shards.Num();
+    for (auto& Worker : Workers)
+    {
+        int32 ReturnCode = 0;
+        if (Worker.Handle.IsValid())
+        {
+            FPlatformProcess::WaitForProc(Worker.Handle);
+            FPlatformProcess::GetProcReturnCode(Worker.Handle, &ReturnCode);
+            FPlatformProcess::CloseProc(Worker.Handle);
+        }
+
+        FAnimBatchResult WorkerResult;
+        const bool bHasResult = LoadBatchResult(Worker.ResultPath, WorkerResult);
+        if (ReturnCode != 0 || !bHasResult)
+        {
+            UE_LOG(LogAnimBatchUtil, Error, TEXT("Worker failed (code %d), missing result %s"), ReturnCode,
+                   *Worker.ResultPath);
+            bAllSucceeded = false;
+        }
+        if (!bHasResult)
+        {
+            // A crashed worker still journaled its progress, rerunning the same list and options resumes it
+            WorkerResult.ErrorSequences = Shards[Worker.Shard].SequencePaths;
+        }
+        OutResult.Append(WorkerResult);
+    }
+    if (bAllSucceeded)
+    {
+        // The whole list went through, the next run shards from scratch
+        IFileManager::Get().Delete(*PlanPath, false, true, true);
+        for (auto const& Worker : Workers)
+        {
+            IFileManager::Get().Delete(*Worker.ResultPath, false, true, true);
+        }
+    }
+    return bAllSucceeded;
+}
@@ -0,0 +1,138 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetData.h"
+#include "UI/AnimToolSettings.h"
+
+class UAnimSequence;
+class FAnimBatchJournal;
+class FAnimBatchReport;
+
+// Operations the batch runners (editor widget and commandlet workers) can apply per sequence.
+enum class EAnimBatchOperation : uint8
+{
+    MarkFootsteps,
+    ExtractCurves,
+    CheckAnimation,
+    OptimizeCurves,
+};
+
+// Snapshot of the tool settings an operation needs, taken on the game thread before a run starts
+// so that worker threads never read the settings objects the details views are editing.
+struct FAnimBatchOptions
+{
+    TArray<FString> KeyBones;
+    EAnimFootstepOutput FootstepOutput = EAnimFootstepOutput::Curve;
+    bool bDebug = false;
+
+    FString TargetBoneName;
+    FString ExportDirectory;
+    uint32 SaveFlags = 0xff;
+
+    bool bCheckCameraRootAtOrigin = true;
+    bool bCheckSingleFrameAnim = true;
+    // Check Animation only stores its verdicts on the sequences when asked, storing dirties them
+    bool bStampCheckResults = false;
+
+    float CurveTolerance = 1e-3f;
+    bool bStripDebugCurves = true;
+    bool bReduceCurveKeys = true;
+    bool bRemoveDuplicateCurves = false;
+
+    // Sequences with at least this many frames are extracted frame-parallel, 0 disables
+    int32 FrameParallelMinFrames = 10000;
+
+    static FAnimBatchOptions FromSettings();
+};
+
+struct FAnimBatchShard
+{
+    TArray<FString> SequencePaths;
+    int64 EstimatedCost = 0;
+};
+
+struct FAnimBatchResult
+{
+    TArray<FString> ProcessedSequences;
+    TArray<FString> ErrorSequences;
+
+    void Append(FAnimBatchResult const& Other)
+    {
+        ProcessedSequences.Append(Other.ProcessedSequences);
+        ErrorSequences.Append(Other.ErrorSequences);
+    }
+};
+
+// Stateless Util Set for library-wide batch runs
+class FAnimBatchUtils
+{
+public:
+    static const TCHAR* LexToString(EAnimBatchOperation Operation);
+
+    static bool LexFromString(EAnimBatchOperation& OutOperation, const TCHAR* Name);
+
+    // Read/write the {"AnimSequences": [...]} list format produced by Generate Json.
+    static bool LoadSequenceList(const FString& JsonPath, TArray<FString>& OutSequencePaths);
+
+    static bool SaveSequenceList(const FString& JsonPath, const TArray<FString>& SequencePaths);
+
+    static bool LoadBatchResult(const FString& JsonPath, FAnimBatchResult& OutResult);
+
+    static bool SaveBatchResult(const FString& JsonPath, FAnimBatchResult const& Result);
+
+    // Identifies a run for its journal, changes with the operation, the list or any option that
+    // changes the results.
+    static FString ComputeRunHash(EAnimBatchOperation Operation, const TArray<FString>& SequencePaths,
+                                  FAnimBatchOptions const& Options);
+
+    // Relative cost of processing one sequence, proportional to frame count x animated bones.
+    static int64 EstimateSequenceCost(const FAssetData& AssetData);
+
+    // Greedy longest-processing-time split, shards end up with near equal total cost.
+    static void SplitIntoShards(const TArray<FString>& SequencePaths, int32 NumShards,
+                                TArray<FAnimBatchShard>& OutShards);
+
+    // Apply one operation to one sequence, return false if it fails.
+    static bool RunOperation(EAnimBatchOperation Operation, UAnimSequence* Seq, FAnimBatchOptions const& Options);
+
+    // Read-only half of RunOperation, safe on worker threads. Returns the game thread half, which
+    // writes the results and returns whether the sequence succeeded, or an unbound function on failure.
+    static TFunction<bool()> AnalyzeOperation(EAnimBatchOperation Operation, UAnimSequence* Seq,
+                                              FAnimBatchOptions const& Options);
+
+    // Run an operation over a list, skipping sequences committed in the journal. With SaveWindowSize > 0
+    // modified packages are saved every SaveWindowSize sequences, then the journal records are flushed.
+    // Stage timings and counters go to Report when given.
+    static void RunBatch(EAnimBatchOperation Operation, const TArray<FString>& SequencePaths,
+                         FAnimBatchOptions const& Options, FAnimBatchJournal* Journal, int32 SaveWindowSize,
+                         FAnimBatchResult& OutResult, FAnimBatchReport* Report = nullptr);
+
+    // Coordinator: shard the list, run one worker editor process per shard and merge their results.
+    // The shard assignment is kept until the whole list completes. A rerun with the same list, options and
+    // worker count reuses it, so every worker resumes from its own journal and finished shards are not run
+    // again. bResume false starts every shard over.
+    static bool RunShardedWorkers(EAnimBatchOperation Operation, const TArray<FString>& SequencePaths,
+                                  FAnimBatchOptions const& Options, int32 NumWorkers, bool bResume,
+                                  const FString& ExtraWorkerParams, FAnimBatchResult& OutResult);
+};
+
+// Collects the packages modified by a run, saves them every SaveWindowSize sequences and only then
+// commits the matching journal records. SaveWindowSize <= 0 leaves packages dirty for the user.
+class FAnimBatchSaveWindow
+{
+public:
+    FAnimBatchSaveWindow(FAnimBatchJournal* InJournal, int32 InSaveWindowSize)
+        : Journal(InJournal), SaveWindowSize(InSaveWindowSize)
+    {
+    }
+
+    void Add(const FString& SequencePath, UAnimSequence* Seq, bool bSucceeded);
+
+    void Commit();
+
+private:
+    FAnimBatchJournal* Journal;
+    int32 SaveWindowSize;
+    int32 WindowCount = 0;
+    TArray<UPackage*> WindowPackages;
+};
@@ -0,0 +1,213 @@
+﻿#include "AnimCompressionAudit.h"
+
+#include "AnimCurveToolStats.h"
+#include "Animation/AnimSequence.h"
+#include "Async/ParallelFor.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimCompressionAudit, Log, All);
+
+namespace
+{
+    constexpr int32 SequencesPerChunk = 64;
+
+    // Skeleton bone index -> track index, INDEX_NONE for bones without a track
+    TArray<int32> MapBonesToTracks(TArray<FTrackToSkeletonMap> const& TrackMap, int32 NumBones)
+    {
+        TArray<int32> BoneToTrack;
+        BoneToTrack.Init(INDEX_NONE, NumBones);
+        for (int32 TrackIndex = 0; TrackIndex < TrackMap.Num(); ++TrackIndex)
+        {
+            const int32 BoneIndex = TrackMap[TrackIndex].BoneTreeIndex;
+            if (BoneToTrack.IsValidIndex(BoneIndex))
+            {
+                BoneToTrack[BoneIndex] = TrackIndex;
+            }
+        }
+        return BoneToTrack;
+    }
+}
+
+bool FAnimCompressionAudit::Evaluate(UAnimSequence* Seq, TArray<FString> const& BoneNames,
+                                     FAnimCompressionError& OutError)
+{
+    ANIMCURVETOOL_STAGE_SCOPE(PoseExtraction);
+    OutError.SequencePath = Seq->GetPathName();
+    auto Skeleton = Seq->GetSkeleton();
+    if (!Skeleton || !Seq->IsCompressedDataValid())
+    {
+        UE_LOG(LogAnimCompressionAudit, Warning, TEXT("[%s] has no skeleton or no compressed data"), *Seq->GetName());
+        return false;
+    }
+
+    auto const& RefSkeleton = Skeleton->GetReferenceSkeleton();
+    const int32 NumBones = RefSkeleton.GetRawBoneNum();
+
+    // Every ancestor of an audited bone is evaluated once per frame, parents come first in the skeleton
+    TArray<int32> AuditedBones;
+    TBitArray<> bRequired(false, NumBones);
+    for (auto const& BoneName : BoneNames)
+    {
+        int32 BoneIndex = RefSkeleton.FindRawBoneIndex(*BoneName);
+        if (BoneIndex == INDEX_NONE)
+        {
+            continue;
+        }
+        AuditedBones.Add(BoneIndex);
+        for (; BoneIndex != INDEX_NONE; BoneIndex = RefSkeleton.GetRawParentIndex(BoneIndex))
+        {
+            bRequired[BoneIndex] = true;
+        }
+    }
+    if (AuditedBones.Num() == 0)
+    {
+        return false;
+    }
+
+    const auto RawBoneToTrack = MapBonesToTracks(Seq->GetRawTrackToSkeletonMapTable(), NumBones);
+    const auto CompressedBoneToTrack = MapBonesToTracks(Seq->CompressedData.CompressedTrackToSkeletonMapTable,
+                                                        NumBones);
+    auto const& RefPose = RefSkeleton.GetRawRefBonePose();
+
+    TArray<FTransform> RawPose, CompressedPose;
+    RawPose.SetNum(NumBones);
+    CompressedPose.SetNum(NumBones);
+    double SquaredErrorSum = 0.0;
+    double SquaredRotationErrorSum = 0.0;
+    int32 NumSamples = 0;
+
+    const int32 NumFrames = Seq->GetRawNumberOfFrames();
+    for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+    {
+        const float Time = Seq->GetTimeAtFrame(Frame);
+        for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+        {
+            if (!bRequired[BoneIndex])
+            {
+                continue;
+            }
+            FTransform RawLocal = RefPose[BoneIndex], CompressedLocal = RefPose[BoneIndex];
+            if (RawBoneToTrack[BoneIndex] != INDEX_NONE)
+            {
+                Seq->GetBoneTransform(RawLocal, RawBoneToTrack[BoneIndex], Time, true);
+            }
+            if (CompressedBoneToTrack[BoneIndex] != INDEX_NONE)
+            {
+                Seq->GetBoneTransform(CompressedLocal, CompressedBoneToTrack[BoneIndex], Time, false);
+            }
+            const int32 ParentIndex = RefSkeleton.GetRawParentIndex(BoneIndex);
+            RawPose[BoneIndex] = ParentIndex == INDEX_NONE ? RawLocal : RawLocal * RawPose[ParentIndex];
+            CompressedPose[BoneIndex] = ParentIndex == INDEX_NONE
+                                            ? CompressedLocal
+                                            : CompressedLocal * CompressedPose[ParentIndex];
+        }
+
+        for (auto BoneIndex : AuditedBones)
+        {
+            const float PositionError = FVector::Dist(RawPose[BoneIndex].GetLocation(),
+                                                      CompressedPose[BoneIndex].GetLocation());
+            const float RotationError = FMath::RadiansToDegrees(
+                RawPose[BoneIndex].GetRotation().AngularDistance(CompressedPose[BoneIndex].GetRotation()));
+            SquaredErrorSum += PositionError * PositionError;
+            SquaredRotationErrorSum += RotationError * RotationError;
+            ++NumSamples;
+            if (PositionError > OutError.MaxPositionError)
+            {
+                OutError.MaxPositionError = PositionError;
+                OutError.WorstBone = RefSkeleton.GetBoneName(BoneIndex).ToString();
+                OutError.WorstFrame = Frame;
+            }
+            OutError.MaxRotationError = FMath::Max(OutError.MaxRotationError, RotationError);
+        }
+    }
+    ANIMCURVETOOL_COUNT(Frames, NumFrames);
+    ANIMCURVETOOL_COUNT(Bones, AuditedBones.Num());
+
+    OutError.RmsPositionError = NumSamples ? FMath::Sqrt(SquaredErrorSum / NumSamples) : 0.0f;
+    OutError.RmsRotationError = NumSamples ? FMath::Sqrt(SquaredRotationErrorSum / NumSamples) : 0.0f;
+    OutError.bEvaluated = true;
+    return true;
+}
+
+void FAnimCompressionAudit::Run(TArray<FString> const& SequencePaths, TArray<FString> const& BoneNames,
+                                TArray<FAnimCompressionError>& OutErrors)
+{
+    check(IsInGameThread());
+    for (int32 ChunkStart = 0; ChunkStart < SequencePaths.Num(); ChunkStart += SequencesPerChunk)
+    {
+        const int32 ChunkSize = FMath::Min(SequencesPerChunk, SequencePaths.Num() - ChunkStart);
+        TArray<UAnimSequence*> Chunk;
+        {
+            ANIMCURVETOOL_STAGE_SCOPE(Load);
+            for (int32 i = 0; i < ChunkSize; ++i)
+            {
+                auto const& Path = SequencePaths[ChunkStart + i];
+                auto Seq = LoadObject<UAnimSequence>(nullptr, *Path);
+                if (!Seq)
+                {
+                    UE_LOG(LogAnimCompressionAudit, Warning, TEXT("Load Failed from %s"), *Path);
+                }
+                Chunk.Add(Seq);
+            }
+        }
+
+        const int32 FirstError = OutErrors.AddDefaulted(ChunkSize);
+        ParallelFor(ChunkSize, [&](int32 i)
+        {
+            OutErrors[FirstError + i].SequencePath = SequencePaths[ChunkStart + i];
+            if (Chunk[i])
+            {
+                Evaluate(Chunk[i], BoneNames, OutErrors[FirstError + i]);
+            }
+        });
+        ANIMCURVETOOL_COUNT(Sequences, ChunkSize);
+
+        if (IsRunningCommandlet())
+        {
+            CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+        }
+    }
+}
+
+int32 FAnimCompressionAudit::WriteReport(const FString& Directory, TArray<FAnimCompressionError> const& Errors,
+                                         float ThresholdCm, float ThresholdDegrees)
+{
+    const auto CsvPath = FPaths::ConvertRelativePathToFull(
+        Directory / FString::Printf(TEXT("CompressionAudit_%s.csv"), *FDateTime::Now().ToString()));
+
+    TArray<const FAnimCompressionError*> Sorted;
+    for (auto const& Error : Errors)
+    {
+        Sorted.Add(&Error);
+    }
+    Sorted.Sort([](FAnimCompressionError const& A, FAnimCompressionError const& B)
+    {
+        return A.MaxPositionError > B.MaxPositionError;
+    });
+
+    int32 NumOverThreshold = 0;
+    FString CsvString = TEXT("Sequence,MaxPositionError,RmsPositionError,MaxRotationError,RmsRotationError,")
+        TEXT("WorstBone,WorstFrame,Headroom,RotationHeadroom,Evaluated") LINE_TERMINATOR;
+    for (auto Error : Sorted)
+    {
+        NumOverThreshold += Error->IsOverThreshold(ThresholdCm, ThresholdDegrees);
+        CsvString += FString::Printf(TEXT("\"%s\",%.4f,%.4f,%.4f,%.4f,%s,%d,%.4f,%.4f,%s") LINE_TERMINATOR,
+                                     *Error->SequencePath, Error->MaxPositionError, Error->RmsPositionError,
+                                     Error->MaxRotationError, Error->RmsRotationError, *Error->WorstBone,
+                                     Error->WorstFrame, ThresholdCm - Error->MaxPositionError,
+                                     ThresholdDegrees - Error->MaxRotationError,
+                                     Error->bEvaluated ? TEXT("true") : TEXT("false"));
+    }
+    if (!FFileHelper::SaveStringToFile(CsvString, *CsvPath))
+    {
+        UE_LOG(LogAnimCompressionAudit, Error, TEXT("Fail to write compression audit %s"), *CsvPath);
+        return NumOverThreshold;
+    }
+    ANIMCURVETOOL_COUNT(BytesWritten, CsvString.Len());
+
+    UE_LOG(LogAnimCompressionAudit, Display,
+           TEXT("Compression audit of %d sequences, %d over %.3f cm or %.3f degrees, written to %s"),
+           Errors.Num(), NumOverThreshold, ThresholdCm, ThresholdDegrees, *CsvPath);
+    return NumOverThreshold;
+}
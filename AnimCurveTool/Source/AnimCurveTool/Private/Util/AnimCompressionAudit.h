@@ -0,0 +1,44 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+class UAnimSequence;
+
+struct FAnimCompressionError
+{
+    FString SequencePath;
+    FString WorstBone;
+    int32 WorstFrame = INDEX_NONE;
+    // Component space, cm and degrees
+    float MaxPositionError = 0.0f;
+    float RmsPositionError = 0.0f;
+    float MaxRotationError = 0.0f;
+    float RmsRotationError = 0.0f;
+    bool bEvaluated = false;
+
+    bool IsOverThreshold(float ThresholdCm, float ThresholdDegrees) const
+    {
+        return bEvaluated && (MaxPositionError > ThresholdCm || MaxRotationError > ThresholdDegrees);
+    }
+};
+
+/*
+ * Compares the raw tracks, which every other tool reads, with the compressed data the game plays.
+ * Selected bones are evaluated in component space at every frame from both, so sequences with error
+ * headroom can take more aggressive compression settings.
+ */
+class FAnimCompressionAudit
+{
+public:
+    // Read-only, safe on worker threads for a loaded sequence. False if there is nothing to compare.
+    static bool Evaluate(UAnimSequence* Seq, TArray<FString> const& BoneNames, FAnimCompressionError& OutError);
+
+    // Sequences are loaded on the game thread a chunk at a time, each chunk is evaluated in parallel.
+    static void Run(TArray<FString> const& SequencePaths, TArray<FString> const& BoneNames,
+                    TArray<FAnimCompressionError>& OutErrors);
+
+    // Writes <Dir>/CompressionAudit_<Timestamp>.csv, worst sequence first, with the headroom left below
+    // ThresholdCm and ThresholdDegrees. Returns the number of sequences over either threshold.
+    static int32 WriteReport(const FString& Directory, TArray<FAnimCompressionError> const& Errors,
+                             float ThresholdCm, float ThresholdDegrees);
+};
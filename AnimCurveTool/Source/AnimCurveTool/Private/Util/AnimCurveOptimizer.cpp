@@ -0,0 +1,244 @@
+﻿#include "AnimCurveOptimizer.h"
+
+#include "AnimationBlueprintLibrary.h"
+#include "AnimCurveToolStats.h"
+#include "Animation/AnimSequence.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimCurveOptimizer, Log, All);
+
+namespace
+{
+    // Keeps the greedy key reduction linear on long baked runs
+    constexpr int32 MaxSkippedKeys = 256;
+
+    bool IsWithinTolerance(FRichCurve const& Original, FRichCurve const& Candidate, TArray<float> const& SampleTimes,
+                           float Tolerance)
+    {
+        for (auto Time : SampleTimes)
+        {
+            if (FMath::Abs(Original.Eval(Time) - Candidate.Eval(Time)) > Tolerance)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    FRichCurve MakeCurve(TArray<FRichCurveKey> const& Keys)
+    {
+        FRichCurve Curve;
+        Curve.SetKeys(Keys);
+        Curve.AutoSetTangents();
+        return Curve;
+    }
+
+    // Drop keys that lie on the line between the last kept key and the next one. The kept keys are linear,
+    // auto tangents through fewer keys could overshoot between the frames the reduction was checked at.
+    TArray<FRichCurveKey> ReduceKeys(TArray<FRichCurveKey> const& Keys, float Tolerance)
+    {
+        TArray<FRichCurveKey> Kept;
+        Kept.Add(Keys[0]);
+        int32 Anchor = 0;
+        for (int32 i = 1; i < Keys.Num() - 1; ++i)
+        {
+            auto const& Next = Keys[i + 1];
+            bool bOnLine = i - Anchor <= MaxSkippedKeys;
+            for (int32 j = Anchor + 1; bOnLine && j <= i; ++j)
+            {
+                const float Alpha = (Keys[j].Time - Keys[Anchor].Time) / (Next.Time - Keys[Anchor].Time);
+                bOnLine = FMath::Abs(FMath::Lerp(Keys[Anchor].Value, Next.Value, Alpha) - Keys[j].Value) <= Tolerance;
+            }
+            if (!bOnLine)
+            {
+                Kept.Add(Keys[i]);
+                Anchor = i;
+            }
+        }
+        Kept.Add(Keys.Last());
+        for (auto& Key : Kept)
+        {
+            Key.InterpMode = RCIM_Linear;
+        }
+        return Kept;
+    }
+
+    bool HasSameKeys(FRichCurve const& A, FRichCurve const& B, float Tolerance)
+    {
+        if (A.GetNumKeys() != B.GetNumKeys())
+        {
+            return false;
+        }
+        auto const& KeysA = A.GetConstRefOfKeys();
+        auto const& KeysB = B.GetConstRefOfKeys();
+        for (int32 i = 0; i < KeysA.Num(); ++i)
+        {
+            if (!FMath::IsNearlyEqual(KeysA[i].Time, KeysB[i].Time, KINDA_SMALL_NUMBER) ||
+                !FMath::IsNearlyEqual(KeysA[i].Value, KeysB[i].Value, Tolerance))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+bool FAnimCurveOptimizer::IsDebugCurveName(const FString& CurveName)
+{
+    return CurveName.EndsWith(TEXT("_PosX_Curve")) || CurveName.EndsWith(TEXT("_PosZ_Curve")) ||
+        CurveName.EndsWith(TEXT("_RotY_Curve"));
+}
+
+const TCHAR* FAnimCurveOptimizer::LexToString(EAnimCurveFinding Finding)
+{
+    switch (Finding)
+    {
+    case EAnimCurveFinding::DebugCurve: return TEXT("DebugCurve");
+    case EAnimCurveFinding::Constant: return TEXT("Constant");
+    case EAnimCurveFinding::NearLinear: return TEXT("NearLinear");
+    case EAnimCurveFinding::RedundantKeys: return TEXT("RedundantKeys");
+    case EAnimCurveFinding::Duplicate: return TEXT("Duplicate");
+    default: return TEXT("Unknown");
+    }
+}
+
+void FAnimCurveOptimizer::Analyze(UAnimSequence* Seq, FAnimCurveOptimizeOptions const& Options,
+                                  TArray<FAnimCurveEdit>& OutEdits)
+{
+    ANIMCURVETOOL_STAGE_SCOPE(CurveOptimize);
+    // Sequences are sampled between frames too, so the half frames catch what a curve does between keys
+    TArray<float> SampleTimes;
+    const int32 NumFrames = Seq->GetRawNumberOfFrames();
+    for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+    {
+        SampleTimes.Add(Seq->GetTimeAtFrame(Frame));
+        if (Frame + 1 < NumFrames)
+        {
+            SampleTimes.Add(0.5f * (Seq->GetTimeAtFrame(Frame) + Seq->GetTimeAtFrame(Frame + 1)));
+        }
+    }
+
+    auto const& FloatCurves = Seq->RawCurveData.FloatCurves;
+    for (int32 CurveIndex = 0; CurveIndex < FloatCurves.Num(); ++CurveIndex)
+    {
+        auto const& Curve = FloatCurves[CurveIndex].FloatCurve;
+        const FName CurveName = FloatCurves[CurveIndex].Name.DisplayName;
+        const int32 NumKeys = Curve.GetNumKeys();
+
+        FAnimCurveEdit Edit;
+        Edit.CurveName = CurveName;
+        Edit.KeysBefore = NumKeys;
+
+        if (Options.bStripDebugCurves && IsDebugCurveName(CurveName.ToString()))
+        {
+            Edit.Finding = EAnimCurveFinding::DebugCurve;
+            Edit.bRemove = true;
+            OutEdits.Add(MoveTemp(Edit));
+            continue;
+        }
+
+        bool bDuplicate = false;
+        for (int32 Other = 0; Other < CurveIndex && !bDuplicate; ++Other)
+        {
+            bDuplicate = HasSameKeys(FloatCurves[Other].FloatCurve, Curve, Options.Tolerance);
+            if (bDuplicate)
+            {
+                Edit.Finding = EAnimCurveFinding::Duplicate;
+                Edit.DuplicateOf = FloatCurves[Other].Name.DisplayName;
+                Edit.bRemove = Options.bRemoveDuplicates;
+                Edit.KeysAfter = Edit.bRemove ? 0 : NumKeys;
+            }
+        }
+        if (bDuplicate)
+        {
+            OutEdits.Add(MoveTemp(Edit));
+            continue;
+        }
+
+        if (!Options.bReduceKeys || NumKeys <= 1)
+        {
+            continue;
+        }
+
+        // Cheapest candidate first, each one has to reproduce the curve at every sample
+        auto const& Keys = Curve.GetConstRefOfKeys();
+        TArray<FRichCurveKey> Candidate = {Keys[0]};
+        Edit.Finding = EAnimCurveFinding::Constant;
+        Edit.NewCurve = MakeCurve(Candidate);
+        if (!IsWithinTolerance(Curve, Edit.NewCurve, SampleTimes, Options.Tolerance))
+        {
+            Candidate = {Keys[0], Keys.Last()};
+            Candidate[0].InterpMode = RCIM_Linear;
+            Candidate[1].InterpMode = RCIM_Linear;
+            Edit.Finding = EAnimCurveFinding::NearLinear;
+            Edit.NewCurve = MakeCurve(Candidate);
+        }
+        if (NumKeys > 2 && !IsWithinTolerance(Curve, Edit.NewCurve, SampleTimes, Options.Tolerance))
+        {
+            Edit.Finding = EAnimCurveFinding::RedundantKeys;
+            Edit.NewCurve = MakeCurve(ReduceKeys(Keys, Options.Tolerance));
+        }
+        Edit.KeysAfter = Edit.NewCurve.GetNumKeys();
+        if (Edit.KeysAfter < NumKeys && IsWithinTolerance(Curve, Edit.NewCurve, SampleTimes, Options.Tolerance))
+        {
+            OutEdits.Add(MoveTemp(Edit));
+        }
+    }
+}
+
+void FAnimCurveOptimizer::Apply(UAnimSequence* Seq, TArray<FAnimCurveEdit> const& Edits)
+{
+    ANIMCURVETOOL_STAGE_SCOPE(CurveOptimize);
+    if (Edits.Num() == 0)
+    {
+        return;
+    }
+
+    // Reported duplicates are findings too, the sequence is only touched when something changes
+    const bool bModifies = Edits.ContainsByPredicate([](FAnimCurveEdit const& Edit)
+    {
+        return Edit.bRemove || Edit.KeysAfter < Edit.KeysBefore;
+    });
+    int32 NumRemoved = 0, KeysRemoved = 0;
+    if (bModifies)
+    {
+        Seq->Modify(true);
+        for (auto const& Edit : Edits)
+        {
+            if (Edit.bRemove)
+            {
+                // One evaluation less per frame of every instance playing the sequence
+                UAnimationBlueprintLibrary::RemoveCurve(Seq, Edit.CurveName, false);
+                ++NumRemoved;
+                KeysRemoved += Edit.KeysBefore;
+                continue;
+            }
+            for (auto& FloatCurve : Seq->RawCurveData.FloatCurves)
+            {
+                if (FloatCurve.Name.DisplayName == Edit.CurveName && Edit.KeysAfter < Edit.KeysBefore)
+                {
+                    FloatCurve.FloatCurve = Edit.NewCurve;
+                    KeysRemoved += Edit.KeysBefore - Edit.KeysAfter;
+                }
+            }
+        }
+        Seq->MarkRawDataAsModified();
+        Seq->PostEditChange();
+        Seq->MarkPackageDirty();
+    }
+
+    // Raw curve keys only, the compressed curve stream shrinks by its own codec
+    const int64 BytesSaved = static_cast<int64>(KeysRemoved) * sizeof(FRichCurveKey);
+    ANIMCURVETOOL_COUNT(CurveFindings, Edits.Num());
+    ANIMCURVETOOL_COUNT(CurvesRemoved, NumRemoved);
+    ANIMCURVETOOL_COUNT(CurveKeysRemoved, KeysRemoved);
+    ANIMCURVETOOL_COUNT(CurveBytesSaved, BytesSaved);
+    UE_LOG(LogAnimCurveOptimizer, Log, TEXT("[%s] %d findings, %d curves removed, %d keys removed, ~%lld raw bytes saved"),
+           *Seq->GetName(), Edits.Num(), NumRemoved, KeysRemoved, BytesSaved);
+    for (auto const& Edit : Edits)
+    {
+        UE_LOG(LogAnimCurveOptimizer, Verbose, TEXT("[%s->%s] %s%s %d -> %d keys %s"), *Seq->GetName(),
+               *Edit.CurveName.ToString(), LexToString(Edit.Finding),
+               Edit.DuplicateOf.IsNone() ? TEXT("") : *FString::Printf(TEXT(" of %s"), *Edit.DuplicateOf.ToString()),
+               Edit.KeysBefore, Edit.KeysAfter, Edit.bRemove ? TEXT("(removed)") : TEXT(""));
+    }
+}
@@ -0,0 +1,54 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Curves/RichCurve.h"
+
+class UAnimSequence;
+
+enum class EAnimCurveFinding : uint8
+{
+    // <Bone>_PosX_Curve, _PosZ_Curve and _RotY_Curve written by footstep marking in debug mode
+    DebugCurve,
+    Constant,
+    NearLinear,
+    RedundantKeys,
+    Duplicate,
+};
+
+struct FAnimCurveEdit
+{
+    FName CurveName;
+    EAnimCurveFinding Finding = EAnimCurveFinding::Constant;
+    bool bRemove = false;
+    // Replacement keys when the curve is kept
+    FRichCurve NewCurve;
+    int32 KeysBefore = 0;
+    int32 KeysAfter = 0;
+    FName DuplicateOf;
+};
+
+struct FAnimCurveOptimizeOptions
+{
+    // Largest value change allowed at any frame or half frame
+    float Tolerance = 1e-3f;
+    bool bStripDebugCurves = true;
+    bool bReduceKeys = true;
+    // Gameplay reads curves by name, so duplicates are only reported unless asked for
+    bool bRemoveDuplicates = false;
+};
+
+// Finds float curves in RawCurveData that cost memory and per-frame evaluation for nothing.
+class FAnimCurveOptimizer
+{
+public:
+    static bool IsDebugCurveName(const FString& CurveName);
+
+    // Read-only, safe on worker threads. Every reduction is checked against the original at all frames and
+    // half frames, reduced keys interpolate linearly so nothing overshoots between them.
+    static void Analyze(UAnimSequence* Seq, FAnimCurveOptimizeOptions const& Options, TArray<FAnimCurveEdit>& OutEdits);
+
+    // Game thread
+    static void Apply(UAnimSequence* Seq, TArray<FAnimCurveEdit> const& Edits);
+
+    static const TCHAR* LexToString(EAnimCurveFinding Finding);
+};
@@ -0,0 +1,42 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimBatchReport.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+
+// "stat AnimCurveTool" in the editor, AnimCurveTool_* scopes in Unreal Insights
+DECLARE_STATS_GROUP(TEXT("AnimCurveTool"), STATGROUP_AnimCurveTool, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load"), STAT_AnimCurveTool_Load, STATGROUP_AnimCurveTool, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Pose Extraction"), STAT_AnimCurveTool_PoseExtraction, STATGROUP_AnimCurveTool, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Curve Build"), STAT_AnimCurveTool_CurveBuild, STATGROUP_AnimCurveTool, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Footstep Detection"), STAT_AnimCurveTool_FootstepDetection, STATGROUP_AnimCurveTool, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Notify Insertion"), STAT_AnimCurveTool_NotifyInsertion, STATGROUP_AnimCurveTool, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Curve Export"), STAT_AnimCurveTool_CurveExport, STATGROUP_AnimCurveTool, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Curve Optimize"), STAT_AnimCurveTool_CurveOptimize, STATGROUP_AnimCurveTool, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Save"), STAT_AnimCurveTool_Save, STATGROUP_AnimCurveTool, );
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Sequences"), STAT_AnimCurveTool_Sequences, STATGROUP_AnimCurveTool, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Frames"), STAT_AnimCurveTool_Frames, STATGROUP_AnimCurveTool, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Bones"), STAT_AnimCurveTool_Bones, STATGROUP_AnimCurveTool, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Cache Hits"), STAT_AnimCurveTool_CacheHits, STATGROUP_AnimCurveTool, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Bytes Written"), STAT_AnimCurveTool_BytesWritten, STATGROUP_AnimCurveTool, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Curve Findings"), STAT_AnimCurveTool_CurveFindings, STATGROUP_AnimCurveTool, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Curves Removed"), STAT_AnimCurveTool_CurvesRemoved, STATGROUP_AnimCurveTool, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Curve Keys Removed"), STAT_AnimCurveTool_CurveKeysRemoved, STATGROUP_AnimCurveTool, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Curve Bytes Saved"), STAT_AnimCurveTool_CurveBytesSaved, STATGROUP_AnimCurveTool, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Frame Ranges"), STAT_AnimCurveTool_FrameRanges, STATGROUP_AnimCurveTool, );
+
+// Times the enclosing block as one stage in the stats group, in Insights and in the bound run report
+#define ANIMCURVETOOL_STAGE_SCOPE(Stage) \
+    SCOPE_CYCLE_COUNTER(STAT_AnimCurveTool_##Stage); \
+    TRACE_CPUPROFILER_EVENT_SCOPE(AnimCurveTool_##Stage); \
+    FAnimBatchReport::FStageScope PREPROCESSOR_JOIN(AnimCurveToolStage_, __LINE__)(EAnimBatchStage::Stage)
+
+#define ANIMCURVETOOL_COUNT(Counter, Amount) \
+    do \
+    { \
+        INC_DWORD_STAT_BY(STAT_AnimCurveTool_##Counter, Amount); \
+        FAnimBatchReport::Count(EAnimBatchCounter::Counter, Amount); \
+    } while (0)
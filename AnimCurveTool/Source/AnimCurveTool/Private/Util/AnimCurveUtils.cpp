@@ -1,23 +1,77 @@
 ﻿#include "AnimCurveUtils.h"
 
 #include "AnimationBlueprintLibrary.h"
+#include "AnimFootstepTable.h"
+#include "AnimCurveToolStats.h"
 #include "AssetRegistryModule.h"
 #include "EngineUtils.h"
 #include "FileHelpers.h"
 #include "PackageTools.h"
 #include "Animation/AnimNotifies/AnimNotify.h"
 #include "Animation/AnimNotifies/AnimNotify_PlaySound.h"
+#include "Async/ParallelFor.h"
 #include "Kismet2/BlueprintEditorUtils.h"
 
 
 DEFINE_LOG_CATEGORY_STATIC(LogAnimCurveUtil, Log, All);
 
+namespace
+{
+    thread_local int32 FrameParallelMinFrames = 0;
 
-void FAnimCurveUtils::GetAnimAssets(FString const& BaseDir, TArray<UAnimSequence*>& OutArray)
+    const TCHAR* FootstepCurveName = TEXT("Footsteps_Curve");
+    const FName FootstepSyncTrackName(TEXT("Footstep_Sync"));
+    const FName FootstepTrackName(TEXT("Footstep_Track"));
+
+    // Whatever an earlier run of another mode left would report the steps twice, or stale ones
+    void RemoveFootstepOutput(UAnimSequence* Seq, EAnimFootstepOutput Output)
+    {
+        switch (Output)
+        {
+        case EAnimFootstepOutput::Curve:
+            if (UAnimationBlueprintLibrary::DoesCurveExist(Seq, FootstepCurveName, ERawCurveTrackTypes::RCT_Float))
+            {
+                UAnimationBlueprintLibrary::RemoveCurve(Seq, FootstepCurveName, false);
+            }
+            break;
+        case EAnimFootstepOutput::SyncMarkers:
+            if (UAnimationBlueprintLibrary::IsValidAnimNotifyTrackName(Seq, FootstepSyncTrackName))
+            {
+                UAnimationBlueprintLibrary::RemoveAnimationNotifyTrack(Seq, FootstepSyncTrackName);
+            }
+            break;
+        case EAnimFootstepOutput::Notifies:
+            if (UAnimationBlueprintLibrary::IsValidAnimNotifyTrackName(Seq, FootstepTrackName))
+            {
+                UAnimationBlueprintLibrary::RemoveAnimationNotifyTrack(Seq, FootstepTrackName);
+            }
+            break;
+        }
+    }
+}
+
+FAnimCurveUtils::FFrameParallelScope::FFrameParallelScope(int32 MinFrames)
+    : PrevMinFrames(FrameParallelMinFrames)
+{
+    FrameParallelMinFrames = MinFrames;
+}
+
+FAnimCurveUtils::FFrameParallelScope::~FFrameParallelScope()
+{
+    FrameParallelMinFrames = PrevMinFrames;
+}
+
+bool FAnimCurveUtils::IsFrameParallel(int32 NumFrames)
+{
+    return FrameParallelMinFrames > 0 && NumFrames >= FrameParallelMinFrames
+        && NumFrames > FramesPerParallelRange;
+}
+
+
+void FAnimCurveUtils::GetAnimAssetData(FString const& BaseDir, TArray<FAssetData>& OutAssetData)
 {
     FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(
         "AssetRegistry");
-    TArray<FAssetData> AssetData;
 
     FARFilter Filter;
     FString PackagePath, FailReason;
@@ -31,7 +85,13 @@ void FAnimCurveUtils::GetAnimAssets(FString const& BaseDir, TArray<UAnimSequence
     Filter.ClassNames.Add(UAnimSequence::StaticClass()->GetFName());
     Filter.bRecursivePaths = true;
 
-    AssetRegistryModule.Get().GetAssets(Filter, AssetData);
+    AssetRegistryModule.Get().GetAssets(Filter, OutAssetData);
+}
+
+void FAnimCurveUtils::GetAnimAssets(FString const& BaseDir, TArray<UAnimSequence*>& OutArray)
+{
+    TArray<FAssetData> AssetData;
+    GetAnimAssetData(BaseDir, AssetData);
     for (int i = 0; i < AssetData.Num(); i++)
     {
         OutArray.Add(Cast<UAnimSequence>(AssetData[i].GetAsset()));
@@ -67,20 +127,48 @@ bool FAnimCurveUtils::SaveBonesCurves(UAnimSequence* AnimSequence, FString const
     if (!SaveFlags) return true;
 
     FVectorCurve PosCurve, RotCurve;
+    if (!BuildBoneCurves(AnimSequence, BoneName, PosCurve, RotCurve))
+    {
+        return false;
+    }
+    return SaveBonesCurves(AnimSequence, BoneName, SaveDir, SaveFlags, PosCurve, RotCurve);
+}
 
-    TArray<FVector> PosKeys;
-    TArray<FQuat> RotKeys;
-    if (!GetBoneKeysByNameHelper(AnimSequence, BoneName, PosKeys, RotKeys, true))
+bool FAnimCurveUtils::BuildBoneCurves(UAnimSequence* AnimSequence, FString const& BoneName,
+                                      FVectorCurve& PosCurve, FVectorCurve& RotCurve)
+{
+    ANIMCURVETOOL_STAGE_SCOPE(CurveBuild);
+    FAnimPoseStream Stream(AnimSequence);
+    FBoneCurveBuilder Builder(Stream, BoneName);
+    if (!Builder.IsValid())
     {
         UE_LOG(LogAnimCurveUtil, Error, TEXT("[%s->%s]: Bone not Exists!"), *AnimSequence->GetName(), *BoneName);
         return false;
     }
+    Stream.Run();
+
+    PosCurve = MoveTemp(Builder.PosCurve);
+    RotCurve = MoveTemp(Builder.RotCurve);
+    return true;
+}
 
-    for (int i = 0; i < AnimSequence->GetRawNumberOfFrames(); ++i)
+FAnimCurveUtils::FBoneCurveBuilder::FBoneCurveBuilder(FAnimPoseStream& Stream, FString const& BoneName)
+    : Slot(Stream.AddBone(*BoneName))
+{
+    if (IsValid())
+    {
+        Stream.AddConsumer(*this);
+    }
+}
+
+void FAnimCurveUtils::FBoneCurveBuilder::Consume(FAnimPoseStream const& Stream, FAnimPoseChunk const& Chunk)
+{
+    auto const& Poses = Chunk.BonePoses[Slot];
+    for (int i = 0; i < Chunk.NumFrames; ++i)
     {
-        const auto Time = AnimSequence->GetTimeAtFrame(i);
-        const auto Translation = PosKeys[i];
-        const auto EulerAngle = RotKeys[i].Euler();
+        const auto Time = Stream.GetSequence()->GetTimeAtFrame(Chunk.FirstFrame + i);
+        const auto Translation = Poses[i].GetLocation();
+        const auto EulerAngle = Poses[i].GetRotation().Euler();
 
         PosCurve.FloatCurves[0].UpdateOrAddKey(Time, Translation.X);
         PosCurve.FloatCurves[1].UpdateOrAddKey(Time, Translation.Y);
@@ -90,9 +178,15 @@ bool FAnimCurveUtils::SaveBonesCurves(UAnimSequence* AnimSequence, FString const
         RotCurve.FloatCurves[1].UpdateOrAddKey(Time, EulerAngle.Y, true);
         RotCurve.FloatCurves[2].UpdateOrAddKey(Time, EulerAngle.Z, true);
     }
-    // MarkFootstepsFor1PAnimation(AnimSequence);
-    // Save Packages
+}
+
+bool FAnimCurveUtils::SaveBonesCurves(UAnimSequence* AnimSequence, FString const& BoneName, const FString& SaveDir,
+                                      uint32 SaveFlags, FVectorCurve const& PosCurve, FVectorCurve const& RotCurve)
+{
+    if (!SaveFlags) return true;
+    ANIMCURVETOOL_STAGE_SCOPE(CurveExport);
 
+    // Save Packages
     TArray<UPackage*> Packages;
     const auto AnimName = AnimSequence->GetName();
     const auto RawPackagePath = SaveDir / AnimName;
@@ -123,23 +217,38 @@ bool FAnimCurveUtils::SaveBonesCurves(UAnimSequence* AnimSequence, FString const
         Packages.Add(RotCurve_Asset->GetOutermost());
     }
 
-    return UEditorLoadingAndSavingUtils::SavePackages(Packages, true);
+    ANIMCURVETOOL_STAGE_SCOPE(Save);
+    if (!UEditorLoadingAndSavingUtils::SavePackages(Packages, true))
+    {
+        return false;
+    }
+    ANIMCURVETOOL_COUNT(BytesWritten, FAnimBatchReport::GetPackagesFileSize(Packages));
+    return true;
 }
 
 
 bool FAnimCurveUtils::LoadAnimSequencesByReference(const TArray<FString>& AnimSequencePaths,
                                                    TArray<UAnimSequence*>& OutSequences)
 {
+    ANIMCURVETOOL_STAGE_SCOPE(Load);
+    // Hashed dedupe, AddUnique is quadratic over a large list
+    TSet<UAnimSequence*> Loaded(OutSequences);
+    OutSequences.Reserve(OutSequences.Num() + AnimSequencePaths.Num());
     for (auto& Path : AnimSequencePaths)
     {
         auto Seq = LoadObject<UAnimSequence>(nullptr, *Path);
         if (Seq)
         {
-            OutSequences.AddUnique(Seq);
+            bool bAlreadyLoaded = false;
+            Loaded.Add(Seq, &bAlreadyLoaded);
+            if (!bAlreadyLoaded)
+            {
+                OutSequences.Add(Seq);
+            }
         }
         else
         {
-            UE_LOG(LogAnimCurveUtil, Log, TEXT("Load Failed from %s: %s"), *Seq->GetName(), *Path);
+            UE_LOG(LogAnimCurveUtil, Log, TEXT("Load Failed from %s"), *Path);
         }
     }
     return true;
@@ -167,6 +276,7 @@ bool FAnimCurveUtils::GetBoneKeysByNameHelper(
     UAnimSequence* Seq, FString const& BoneName, TArray<FVector>& OutPosKey,
     TArray<FQuat>& OutRotKey, bool bConvertCS /* = false */)
 {
+    ANIMCURVETOOL_STAGE_SCOPE(PoseExtraction);
     auto Skeleton = Seq->GetSkeleton();
     auto RefSkeleton = Skeleton->GetReferenceSkeleton();
     auto BoneIndex = RefSkeleton.FindRawBoneIndex(*BoneName);
@@ -189,19 +299,40 @@ bool FAnimCurveUtils::GetBoneKeysByNameHelper(
     }
     while (bConvertCS && BoneIndex);
 
-    TArray<FTransform> Poses;
-    for (int i = 0; i < Seq->GetNumberOfFrames(); ++i)
+    // Frames are independent and only read the raw tracks, each range writes its own slots
+    auto ExtractRange = [&](int32 FirstFrame, int32 LastFrame)
     {
-        UAnimationBlueprintLibrary::GetBonePosesForFrame(Seq, BoneTraces, i, false, Poses);
-        FTransform FinalTransform = FTransform::Identity;
-        for (int j = 0; j < BoneTraces.Num(); ++j)
+        TArray<FTransform> Poses;
+        for (int i = FirstFrame; i < LastFrame; ++i)
         {
-            FinalTransform = FinalTransform * Poses[j];
+            UAnimationBlueprintLibrary::GetBonePosesForFrame(Seq, BoneTraces, i, false, Poses);
+            FTransform FinalTransform = FTransform::Identity;
+            for (int j = 0; j < BoneTraces.Num(); ++j)
+            {
+                FinalTransform = FinalTransform * Poses[j];
+            }
+
+            OutPosKey[i] = FinalTransform.GetLocation();
+            OutRotKey[i] = FinalTransform.GetRotation();
         }
+    };
 
-        OutPosKey[i] = FinalTransform.GetLocation();
-        OutRotKey[i] = FinalTransform.GetRotation();
+    if (IsFrameParallel(NbrOfFrames))
+    {
+        const int32 NumRanges = FMath::DivideAndRoundUp(NbrOfFrames, FramesPerParallelRange);
+        ParallelFor(NumRanges, [&](int32 Range)
+        {
+            const int32 FirstFrame = Range * FramesPerParallelRange;
+            ExtractRange(FirstFrame, FMath::Min(FirstFrame + FramesPerParallelRange, NbrOfFrames));
+        });
+        ANIMCURVETOOL_COUNT(FrameRanges, NumRanges);
+    }
+    else
+    {
+        ExtractRange(0, NbrOfFrames);
     }
+    ANIMCURVETOOL_COUNT(Frames, NbrOfFrames);
+    ANIMCURVETOOL_COUNT(Bones, BoneTraces.Num());
 
     return true;
 }
@@ -222,19 +353,53 @@ float FAnimCurveUtils::CalcStdDevOfMarkers(TArray<FFootstepMarker> const& Marker
 }
 
 bool FAnimCurveUtils::MarkFootstepsFor1PAnimation(
-    UAnimSequence* Seq, TArray<FString> KeyBones, bool bUseCurve /* = true */, bool bDebug /* = false */)
+    UAnimSequence* Seq, TArray<FString> KeyBones, EAnimFootstepOutput Output /* = Curve */,
+    bool bDebug /* = false */)
+{
+    FFootstepAnalysis Analysis;
+    const bool bFound = AnalyzeFootstepsFor1PAnimation(Seq, KeyBones, Analysis, bDebug);
+    if (bFound || Analysis.DebugCurves.Num())
+    {
+        ApplyFootsteps(Seq, Analysis, Output);
+    }
+    return bFound;
+}
+
+bool FAnimCurveUtils::AnalyzeFootstepsFor1PAnimation(
+    UAnimSequence* Seq, TArray<FString> const& KeyBones, FFootstepAnalysis& OutAnalysis, bool bDebug /* = false */)
 {
+    ANIMCURVETOOL_STAGE_SCOPE(FootstepDetection);
     // TArray<TArray<FFootstepMarker>> MarkersBuffer;
     float MinPenalty = 1e9;
-    TArray<FFootstepMarker> BestMarkers;
+    TArray<FFootstepMarker>& BestMarkers = OutAnalysis.Markers;
     const auto TotalFrames = Seq->GetNumberOfFrames();
-    FString BestKeyBone;
 
+    // Every key bone is detected in the same pass, shared parent bones are decoded once
+    FAnimPoseStream Stream(Seq);
+    TArray<TUniquePtr<FLocalMinimaDetector>> Detectors;
     for (auto const& KeyBone : KeyBones)
     {
+        Detectors.Add(MakeUnique<FLocalMinimaDetector>(Stream, KeyBone, bDebug));
+    }
+    Stream.Run();
+
+    for (int32 KeyBoneIndex = 0; KeyBoneIndex < KeyBones.Num(); ++KeyBoneIndex)
+    {
+        auto const& KeyBone = KeyBones[KeyBoneIndex];
+        auto& Detector = *Detectors[KeyBoneIndex];
+        if (!Detector.IsValid())
+        {
+            UE_LOG(LogAnimCurveUtil, Warning, TEXT("[%s] BoneName (%s) not exist, or Curves can not be extracted"),
+                   *Seq->GetName(), *KeyBone);
+            continue;
+        }
+        if (bDebug)
+        {
+            OutAnalysis.DebugCurves.Add(MoveTemp(Detector.DebugCurves));
+        }
+
         float Penalty = 0;
-        TArray<FFootstepMarker> Markers;
-        CaptureLocalMinimaMarksByBoneName(Seq, KeyBone, Markers, bDebug);
+        TArray<FFootstepMarker> Markers = MoveTemp(Detector.Markers);
         if (Markers.Num() == 0)
         {
             // no markers
@@ -252,7 +417,7 @@ bool FAnimCurveUtils::MarkFootstepsFor1PAnimation(
         if (Penalty < MinPenalty)
         {
             MinPenalty = Penalty;
-            BestKeyBone = KeyBone;
+            OutAnalysis.KeyBone = KeyBone;
             Swap(BestMarkers, Markers);
         }
     }
@@ -293,10 +458,43 @@ bool FAnimCurveUtils::MarkFootstepsFor1PAnimation(
         Marker.Frame += Offset;
         if(Marker.Frame < 0) Marker.Frame += TotalFrames - 1;
     }
+    return true;
+}
+
+void FAnimCurveUtils::ApplyFootsteps(UAnimSequence* Seq, FFootstepAnalysis const& Analysis,
+                                     EAnimFootstepOutput Output /* = Curve */)
+{
+    ANIMCURVETOOL_STAGE_SCOPE(NotifyInsertion);
+    for (auto const& DebugCurves : Analysis.DebugCurves)
+    {
+        auto PosXCurve = DebugCurves.PosXCurve;
+        auto PosZCurve = DebugCurves.PosZCurve;
+        auto RotYCurve = DebugCurves.RotYCurve;
+        SetVariableCurveHelper(Seq, FString::Printf(TEXT("%s_PosX_Curve"), *DebugCurves.BoneName), PosXCurve);
+        SetVariableCurveHelper(Seq, FString::Printf(TEXT("%s_PosZ_Curve"), *DebugCurves.BoneName), PosZCurve);
+        SetVariableCurveHelper(Seq, FString::Printf(TEXT("%s_RotY_Curve"), *DebugCurves.BoneName), RotYCurve);
+    }
+
+    auto const& BestMarkers = Analysis.Markers;
+    for (auto OtherOutput : {EAnimFootstepOutput::Curve, EAnimFootstepOutput::Notifies,
+                             EAnimFootstepOutput::SyncMarkers})
+    {
+        // Nothing detected, no mode keeps steps
+        if (OtherOutput != Output || BestMarkers.Num() == 0)
+        {
+            RemoveFootstepOutput(Seq, OtherOutput);
+        }
+    }
+    if (BestMarkers.Num() == 0)
+    {
+        Seq->RemoveUserDataOfClass(UAnimFootstepTable::StaticClass());
+        Seq->MarkPackageDirty();
+        return;
+    }
 
     // Seq->Modify();
     // Normal cases;
-    if(bUseCurve)
+    if (Output == EAnimFootstepOutput::Curve)
     {
         FFloatCurve FootstepsCurve;
         auto CurrStep = -1; // LocalMinims[I].Orientation
@@ -306,10 +504,22 @@ bool FAnimCurveUtils::MarkFootstepsFor1PAnimation(
             FootstepsCurve.UpdateOrAddKey(-CurrStep, Seq->GetTimeAtFrame(Footstep.Frame) + 0.001);
             CurrStep = -CurrStep;
         }
-        SetVariableCurveHelper(Seq, "Footsteps_Curve", FootstepsCurve);
-    } else
+        SetVariableCurveHelper(Seq, FootstepCurveName, FootstepsCurve);
+    }
+    else if (Output == EAnimFootstepOutput::SyncMarkers)
+    {
+        // Same alternation as the curve, the first detected step is the left foot
+        UAnimationBlueprintLibrary::RemoveAnimationNotifyTrack(Seq, FootstepSyncTrackName);
+        UAnimationBlueprintLibrary::AddAnimationNotifyTrack(Seq, FootstepSyncTrackName);
+        for (int32 i = 0; i < BestMarkers.Num(); ++i)
+        {
+            UAnimationBlueprintLibrary::AddAnimationSyncMarker(
+                Seq, i % 2 == 0 ? FName(TEXT("L")) : FName(TEXT("R")),
+                Seq->GetTimeAtFrame(BestMarkers[i].Frame), FootstepSyncTrackName);
+        }
+    }
+    else
     {
-        FName FootstepTrackName(TEXT("Footstep_Track"));
         FName FootstepNotifyName(TEXT("Footstep_Event"));
         UAnimationBlueprintLibrary::RemoveAnimationNotifyTrack(Seq, FootstepTrackName);
         UAnimationBlueprintLibrary::AddAnimationNotifyTrack(Seq, FootstepTrackName);
@@ -324,9 +534,28 @@ bool FAnimCurveUtils::MarkFootstepsFor1PAnimation(
             CreateNewNotify(Seq, FootstepTrackName, FootstepNotifyName, Seq->GetTimeAtFrame(Footstep.Frame));
         }
     }
+
+    // Runtime lookup table for UAnimFootstepComponent, feet alternate like the curve keys
+    auto Table = Cast<UAnimFootstepTable>(Seq->GetAssetUserDataOfClass(UAnimFootstepTable::StaticClass()));
+    if (!Table)
+    {
+        Table = NewObject<UAnimFootstepTable>(Seq, NAME_None, RF_Transactional);
+        Seq->AddAssetUserData(Table);
+    }
+    else
+    {
+        Table->Modify();
+    }
+    TArray<float> StepTimes;
+    TArray<EAnimFoot> Feet;
+    for (int32 i = 0; i < BestMarkers.Num(); ++i)
+    {
+        StepTimes.Add(Seq->GetTimeAtFrame(BestMarkers[i].Frame));
+        Feet.Add(i % 2 == 0 ? EAnimFoot::Left : EAnimFoot::Right);
+    }
+    Table->Bake(Seq->SequenceLength, StepTimes, Feet);
     Seq->PostEditChange();
     Seq->MarkPackageDirty();
-    return true;
 }
 
 void FAnimCurveUtils::CreateNewNotify(UAnimSequence* Seq, FName TrackName, FName NotifyName, float StartTime)
@@ -346,99 +575,154 @@ void FAnimCurveUtils::CreateNewNotify(UAnimSequence* Seq, FName TrackName, FName
     Seq->MarkPackageDirty();
 }
 
-
 void FAnimCurveUtils::CaptureLocalMinimaMarksByBoneName(UAnimSequence* Seq, FString const& BoneName,
                                                         TArray<FFootstepMarker>& FootstepMarkers, bool bDebug)
 {
-    FFloatCurve PosXCurve, PosZCurve, RotYCurve;
-    // Get KeyBone translation and rotation keys
-    TArray<FVector> PosKeys;
-    TArray<FQuat> RotKeys;
-    if (!GetBoneKeysByNameHelper(Seq, BoneName, PosKeys, RotKeys, true))
+    FBoneDebugCurves DebugCurves;
+    if (AnalyzeLocalMinimaMarksByBoneName(Seq, BoneName, FootstepMarkers, bDebug ? &DebugCurves : nullptr) && bDebug)
+    {
+        SetVariableCurveHelper(Seq, FString::Printf(TEXT("%s_PosX_Curve"), *BoneName), DebugCurves.PosXCurve);
+        SetVariableCurveHelper(Seq, FString::Printf(TEXT("%s_PosZ_Curve"), *BoneName), DebugCurves.PosZCurve);
+        SetVariableCurveHelper(Seq, FString::Printf(TEXT("%s_RotY_Curve"), *BoneName), DebugCurves.RotYCurve);
+    }
+}
+
+bool FAnimCurveUtils::AnalyzeLocalMinimaMarksByBoneName(UAnimSequence* Seq, FString const& BoneName,
+                                                        TArray<FFootstepMarker>& FootstepMarkers,
+                                                        FBoneDebugCurves* OutDebugCurves)
+{
+    ANIMCURVETOOL_STAGE_SCOPE(FootstepDetection);
+    FAnimPoseStream Stream(Seq);
+    FLocalMinimaDetector Detector(Stream, BoneName, OutDebugCurves != nullptr);
+    if (!Detector.IsValid())
     {
         UE_LOG(LogAnimCurveUtil, Warning, TEXT("[%s] BoneName (%s) not exist, or Curves can not be extracted"),
                *Seq->GetName(), *BoneName);
-        return;
+        return false;
     }
-    // Total Nums of the Key
-    // Strategy: Capture the local Z minimal point in LeftHand
-    auto N = PosKeys.Num();
-    auto M = RotKeys.Num();
-    auto FrameCount = Seq->GetNumberOfFrames();
+    Stream.Run();
 
-    FVector RotAvg(0.0f), PosAvg(0.0f);
+    FootstepMarkers.Append(MoveTemp(Detector.Markers));
+    if (OutDebugCurves)
+    {
+        *OutDebugCurves = MoveTemp(Detector.DebugCurves);
+    }
 
-    TArray<FVector> PosCache, RotCache;
-    uint32 x = 0, PosIncrement = N == 1 ? 0 : 1;
-    uint32 y = 0, RotIncrement = M == 1 ? 0 : 1;
-    for (int i = 0; i < FrameCount; ++i)
+    /*if (FootstepMarkers.Num() > 2)
+    {
+        UE_LOG(LogAnimCurveUtil, Warning,
+               TEXT("[%s->%s] mark footstep could fail when target Curves.Pos.Z contains more than 2 local minimas"),
+               *Seq->GetName(), *BoneName);
+    }
+    else if (FootstepMarkers.Num() == 1)
     {
-        auto Time = Seq->GetTimeAtFrame(i);
+        UE_LOG(LogAnimCurveUtil, Warning, TEXT("[%s->%s] has only one footstep mark, please check it manually."),
+               *Seq->GetName(), *BoneName);
+    }*/
+    return true;
+}
 
-        FVector CurrPos = PosKeys[x];
-        FVector CurrRot = RotKeys[y].Euler();
+FAnimCurveUtils::FLocalMinimaDetector::FLocalMinimaDetector(FAnimPoseStream& Stream, FString const& InBoneName,
+                                                            bool bInDebug)
+    : BoneName(InBoneName)
+    , Slot(Stream.AddBone(*InBoneName))
+    , bDebug(bInDebug)
+{
+    if (IsValid())
+    {
+        Stream.AddConsumer(*this);
+    }
+}
+
+void FAnimCurveUtils::FLocalMinimaDetector::Consume(FAnimPoseStream const& Stream, FAnimPoseChunk const& Chunk)
+{
+    // Strategy: Capture the local Z minimal point in LeftHand
+    // Ignore end frame, cause frame_start == frame_end
+    const int32 EndFrame = Stream.GetNumFrames() - 1;
+    auto const& Poses = Chunk.BonePoses[Slot];
+    for (int i = 0; i < Chunk.NumFrames; ++i)
+    {
+        const int32 Frame = Chunk.FirstFrame + i;
+        FVector Pos = Poses[i].GetLocation();
+        const FVector Rot = Poses[i].GetRotation().Euler();
 
         // Coordinates Transform
-        Swap(CurrPos.Y, CurrPos.Z);
-        CurrPos.Z = -CurrPos.Z;
+        Swap(Pos.Y, Pos.Z);
+        Pos.Z = -Pos.Z;
 
-        x += PosIncrement;
-        y += RotIncrement;
+        PosAvg += Pos;
+        RotAvg += Rot;
+        if (bDebug)
+        {
+            const auto Time = Stream.GetSequence()->GetTimeAtFrame(Frame);
+            DebugCurves.PosXCurve.FloatCurve.UpdateOrAddKey(Time, Pos.X);
+            DebugCurves.PosZCurve.FloatCurve.UpdateOrAddKey(Time, Pos.Z);
+            DebugCurves.RotYCurve.FloatCurve.UpdateOrAddKey(Time, Rot.Y, true);
+        }
 
-        PosCache.Add(CurrPos);
-        RotCache.Add(CurrRot);
-        PosAvg += CurrPos;
-        RotAvg += CurrRot;
+        if (Frame < EndFrame)
+        {
+            Push(Pos);
+        }
+    }
+}
 
-        PosXCurve.FloatCurve.UpdateOrAddKey(Time, CurrPos.X);
-        PosZCurve.FloatCurve.UpdateOrAddKey(Time, CurrPos.Z);
-        RotYCurve.FloatCurve.UpdateOrAddKey(Time, CurrRot.Y, true);
+void FAnimCurveUtils::FLocalMinimaDetector::Push(FVector const& Pos)
+{
+    // Frame NumPushed - 1 is tested once its next frame arrives, frame 0 waits for the last one
+    if (NumPushed == 0)
+    {
+        FirstPos = Pos;
+    }
+    else if (NumPushed == 1)
+    {
+        SecondPos = Pos;
+    }
+    else if (IsLocalMinimum(PrevPos, CurrPos, Pos))
+    {
+        Markers.Push(MakeMarker(PrevPos, CurrPos, NumPushed - 1));
     }
+    PrevPos = CurrPos;
+    CurrPos = Pos;
+    ++NumPushed;
+}
 
+void FAnimCurveUtils::FLocalMinimaDetector::Finish(FAnimPoseStream const& Stream)
+{
     if (bDebug)
     {
-        RotAvg /= Seq->GetNumberOfFrames();
-        PosAvg /= Seq->GetNumberOfFrames();
-        UE_LOG(LogAnimCurveUtil, Log, TEXT("key counts Pos: %d, Rot: %d"), N, M);
+        const int32 NumFrames = Stream.GetNumFrames();
+        RotAvg /= NumFrames;
+        PosAvg /= NumFrames;
+        UE_LOG(LogAnimCurveUtil, Log, TEXT("key counts Pos: %d, Rot: %d"), NumFrames, NumFrames);
         UE_LOG(LogAnimCurveUtil, Log, TEXT("Position Average: %f, Rotation Average: %f"),
                PosAvg.X, RotAvg.Y);
+        DebugCurves.BoneName = BoneName;
     }
 
-    FVector PrevPos, NextPos, CurrPos;
-    FVector PrevRot, NextRot, CurrRot;
-    constexpr float Eps = 1e-6;
-    // Ignore end frame, cause frame_start == frame_end
-    PosCache.Pop(), RotCache.Pop();
-    N = PosCache.Num(), M = RotCache.Num();
-
-    for (int i = 0; i < N; ++i)
+    // The loop wraps, the last frame is followed by the first
+    if (NumPushed >= 2)
     {
-        PrevPos = PosCache[(i - 1 + N) % N];
-        CurrPos = PosCache[i];
-        NextPos = PosCache[(i + 1) % N];
-
-        if (CurrPos.Z + Eps <= PrevPos.Z && CurrPos.Z + Eps <= NextPos.Z)
+        if (IsLocalMinimum(PrevPos, CurrPos, FirstPos))
+        {
+            Markers.Push(MakeMarker(PrevPos, CurrPos, NumPushed - 1));
+        }
+        if (IsLocalMinimum(CurrPos, FirstPos, SecondPos))
         {
-            FootstepMarkers.Push(FFootstepMarker{CurrPos.Z, (PrevPos.X > CurrPos.X) * 2 - 1, i});
+            Markers.Insert(MakeMarker(CurrPos, FirstPos, 0), 0);
         }
     }
+}
 
-    if (bDebug)
-    {
-        SetVariableCurveHelper(Seq, FString::Printf(TEXT("%s_PosX_Curve"), *BoneName), PosXCurve);
-        SetVariableCurveHelper(Seq, FString::Printf(TEXT("%s_PosZ_Curve"), *BoneName), PosZCurve);
-        SetVariableCurveHelper(Seq, FString::Printf(TEXT("%s_RotY_Curve"), *BoneName), RotYCurve);
-    }
+bool FAnimCurveUtils::FLocalMinimaDetector::IsLocalMinimum(FVector const& Prev, FVector const& Curr,
+                                                           FVector const& Next)
+{
+    constexpr float Eps = 1e-6;
+    return Curr.Z + Eps <= Prev.Z && Curr.Z + Eps <= Next.Z;
+}
 
-    /*if (FootstepMarkers.Num() > 2)
-    {
-        UE_LOG(LogAnimCurveUtil, Warning,
-               TEXT("[%s->%s] mark footstep could fail when target Curves.Pos.Z contains more than 2 local minimas"),
-               *Seq->GetName(), *BoneName);
-    }
-    else if (FootstepMarkers.Num() == 1)
-    {
-        UE_LOG(LogAnimCurveUtil, Warning, TEXT("[%s->%s] has only one footstep mark, please check it manually."),
-               *Seq->GetName(), *BoneName);
-    }*/
+FAnimCurveUtils::FFootstepMarker FAnimCurveUtils::FLocalMinimaDetector::MakeMarker(
+    FVector const& Prev, FVector const& Curr, int32 Frame)
+{
+    return FFootstepMarker{Curr.Z, (Prev.X > Curr.X) * 2 - 1, Frame};
 }
@@ -4,6 +4,8 @@
 #include "AssetRegistryModule.h"
 #include "Animation/AnimSequence.h"
 #include "Curves/CurveVector.h"
+#include "AnimPoseStream.h"
+#include "UI/AnimToolSettings.h"
 
 // Stateless Util Set
 class FAnimCurveUtils
@@ -16,13 +18,104 @@ public:
         int Orientation; // -1: left, 1: right
         int Frame;
     };
+
+    struct FBoneDebugCurves
+    {
+        FString BoneName;
+        FFloatCurve PosXCurve;
+        FFloatCurve PosZCurve;
+        FFloatCurve RotYCurve;
+    };
+
+    struct FFootstepAnalysis
+    {
+        FString KeyBone;
+        TArray<FFootstepMarker> Markers;
+        TArray<FBoneDebugCurves> DebugCurves;
+    };
+
+    // Keys one bone's component space position and euler rotation as the stream passes, see BuildBoneCurves
+    class FBoneCurveBuilder : public IAnimPoseConsumer
+    {
+    public:
+        FBoneCurveBuilder(FAnimPoseStream& Stream, FString const& BoneName);
+
+        bool IsValid() const { return Slot != INDEX_NONE; }
+
+        virtual void Consume(FAnimPoseStream const& Stream, FAnimPoseChunk const& Chunk) override;
+
+        FVectorCurve PosCurve;
+        FVectorCurve RotCurve;
+
+    private:
+        int32 Slot;
+    };
+
+    // Local minima of one bone's height over a looping sequence, holding only the last two frames and the
+    // first two needed to wrap around. See AnalyzeLocalMinimaMarksByBoneName.
+    class FLocalMinimaDetector : public IAnimPoseConsumer
+    {
+    public:
+        FLocalMinimaDetector(FAnimPoseStream& Stream, FString const& InBoneName, bool bInDebug);
+
+        bool IsValid() const { return Slot != INDEX_NONE; }
+
+        virtual void Consume(FAnimPoseStream const& Stream, FAnimPoseChunk const& Chunk) override;
+
+        virtual void Finish(FAnimPoseStream const& Stream) override;
+
+        TArray<FFootstepMarker> Markers;
+        // Only keyed with bDebug
+        FBoneDebugCurves DebugCurves;
+
+    private:
+        void Push(FVector const& Pos);
+
+        static bool IsLocalMinimum(FVector const& Prev, FVector const& Curr, FVector const& Next);
+
+        static FFootstepMarker MakeMarker(FVector const& Prev, FVector const& Curr, int32 Frame);
+
+        FString BoneName;
+        int32 Slot;
+        bool bDebug;
+
+        int32 NumPushed = 0;
+        FVector FirstPos = FVector::ZeroVector;
+        FVector SecondPos = FVector::ZeroVector;
+        FVector PrevPos = FVector::ZeroVector;
+        FVector CurrPos = FVector::ZeroVector;
+        FVector PosAvg = FVector::ZeroVector;
+        FVector RotAvg = FVector::ZeroVector;
+    };
     
     static void GetAnimAssets(FString const& BaseDir, TArray<UAnimSequence*>& OutArray);
 
+    // Same search as GetAnimAssets without loading anything
+    static void GetAnimAssetData(FString const& BaseDir, TArray<FAssetData>& OutAssetData);
+
     static bool SetVariableCurveHelper(UAnimSequence* Seq, const FString& CurveName, FFloatCurve& InFloatCurve);
 
     static UCurveVector* CreateCurveVectorAsset(const FString& PackagePath, const FString& CurveName);
 
+    // Binds the calling thread to split extraction of sequences with at least MinFrames frames into frame
+    // ranges run in parallel, 0 keeps every sequence serial. Batch runners pick this per sequence.
+    class FFrameParallelScope
+    {
+    public:
+        explicit FFrameParallelScope(int32 MinFrames);
+
+        ~FFrameParallelScope();
+
+    private:
+        int32 PrevMinFrames;
+    };
+
+    // Frames each parallel task extracts, large enough to amortise the per-frame pose setup
+    static constexpr int32 FramesPerParallelRange = 512;
+
+    static bool IsFrameParallel(int32 NumFrames);
+
+    // Holds every frame at once, the analysis passes stream through FAnimPoseStream instead.
     static bool GetBoneKeysByNameHelper(UAnimSequence* Seq, FString const& BoneName, TArray<FVector>& OutPosKey,
                                         TArray<FQuat>& OutRotKey, bool bConvertCS = false);
 
@@ -30,16 +123,38 @@ public:
     
     // Give optional bone names for capture, return best matches.
     static bool MarkFootstepsFor1PAnimation(UAnimSequence* Seq, TArray<FString> KeyBones = {"LeftHand", "RightHand"},
-                                            bool bUseCurve = true, bool bDebug = false);
+                                            EAnimFootstepOutput Output = EAnimFootstepOutput::Curve,
+                                            bool bDebug = false);
+
+    // Read-only half of MarkFootstepsFor1PAnimation, safe on worker threads.
+    static bool AnalyzeFootstepsFor1PAnimation(UAnimSequence* Seq, TArray<FString> const& KeyBones,
+                                               FFootstepAnalysis& OutAnalysis, bool bDebug = false);
+
+    // Game thread half of MarkFootstepsFor1PAnimation, write the analysed markers into the sequence.
+    static void ApplyFootsteps(UAnimSequence* Seq, FFootstepAnalysis const& Analysis,
+                               EAnimFootstepOutput Output = EAnimFootstepOutput::Curve);
 
     // Give bone name for capture, return possible marks.
     static void CaptureLocalMinimaMarksByBoneName(UAnimSequence* Seq, FString const& BoneNames,
                                                TArray<FFootstepMarker>& Markers, bool bDebug = false);
+
+    // Read-only capture, debug curves are returned instead of written when OutDebugCurves is given.
+    static bool AnalyzeLocalMinimaMarksByBoneName(UAnimSequence* Seq, FString const& BoneName,
+                                                  TArray<FFootstepMarker>& Markers, FBoneDebugCurves* OutDebugCurves);
  
     // SaveFlags 0b_____________0000__________0000
     //              translation.xyzw rotation.xyzw
     static bool SaveBonesCurves(UAnimSequence* AnimSequence, FString const& BoneName, const FString& SavePath, uint32 SaveFlags = 0xff);
 
+    // Read-only half of SaveBonesCurves, safe on worker threads. Streams the sequence, add an
+    // FBoneCurveBuilder to a shared FAnimPoseStream to build the curves in another consumer's pass.
+    static bool BuildBoneCurves(UAnimSequence* AnimSequence, FString const& BoneName, FVectorCurve& OutPosCurve,
+                                FVectorCurve& OutRotCurve);
+
+    // Game thread half of SaveBonesCurves, create and save the curve assets.
+    static bool SaveBonesCurves(UAnimSequence* AnimSequence, FString const& BoneName, const FString& SavePath,
+                                uint32 SaveFlags, FVectorCurve const& PosCurve, FVectorCurve const& RotCurve);
+
     static bool LoadAnimSequencesByReference(const TArray<FString>& AnimSequencePaths,
                                              TArray<UAnimSequence*>& OutSequences);
 
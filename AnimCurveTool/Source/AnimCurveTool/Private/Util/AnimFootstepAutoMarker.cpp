@@ -0,0 +1,231 @@
+﻿#include "AnimFootstepAutoMarker.h"
+
+#include "AnimAnalysisMetadata.h"
+#include "AnimAnalysisTags.h"
+#include "Editor.h"
+#include "FileHelpers.h"
+#include "PackageAutoSaver.h"
+#include "UnrealEdGlobals.h"
+#include "Containers/Ticker.h"
+#include "Editor/UnrealEdEngine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/SecureHash.h"
+#include "Subsystems/ImportSubsystem.h"
+#include "UObject/UObjectHash.h"
+
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimFootstepAutoMarker, Log, All);
+
+FDelegateHandle FAnimFootstepAutoMarker::PostEngineInitHandle;
+FDelegateHandle FAnimFootstepAutoMarker::PostImportHandle;
+FDelegateHandle FAnimFootstepAutoMarker::ReimportHandle;
+FDelegateHandle FAnimFootstepAutoMarker::PreSaveHandle;
+FDelegateHandle FAnimFootstepAutoMarker::DeferredMarkHandle;
+TArray<TWeakObjectPtr<UAnimSequence>> FAnimFootstepAutoMarker::PendingSequences;
+bool FAnimFootstepAutoMarker::bIsMarking = false;
+
+void FAnimFootstepAutoMarker::Register()
+{
+    // The import subsystem only exists once GEditor does
+    if (GEditor)
+    {
+        OnPostEngineInit();
+    }
+    else
+    {
+        PostEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddStatic(&FAnimFootstepAutoMarker::OnPostEngineInit);
+    }
+    PreSaveHandle = UPackage::PreSavePackageEvent.AddStatic(&FAnimFootstepAutoMarker::OnPreSavePackage);
+}
+
+void FAnimFootstepAutoMarker::Unregister()
+{
+    FCoreDelegates::OnPostEngineInit.Remove(PostEngineInitHandle);
+    UPackage::PreSavePackageEvent.Remove(PreSaveHandle);
+    if (DeferredMarkHandle.IsValid())
+    {
+        FTicker::GetCoreTicker().RemoveTicker(DeferredMarkHandle);
+        DeferredMarkHandle.Reset();
+    }
+    PendingSequences.Empty();
+    if (GEditor)
+    {
+        if (auto ImportSubsystem = GEditor->GetEditorSubsystem<UImportSubsystem>())
+        {
+            ImportSubsystem->OnAssetPostImport.Remove(PostImportHandle);
+            ImportSubsystem->OnAssetReimport.Remove(ReimportHandle);
+        }
+    }
+}
+
+void FAnimFootstepAutoMarker::OnPostEngineInit()
+{
+    if (auto ImportSubsystem = GEditor ? GEditor->GetEditorSubsystem<UImportSubsystem>() : nullptr)
+    {
+        PostImportHandle = ImportSubsystem->OnAssetPostImport.AddStatic(&FAnimFootstepAutoMarker::OnAssetPostImport);
+        ReimportHandle = ImportSubsystem->OnAssetReimport.AddStatic(&FAnimFootstepAutoMarker::OnAssetReimport);
+    }
+}
+
+void FAnimFootstepAutoMarker::OnAssetPostImport(UFactory* Factory, UObject* Object)
+{
+    auto Seq = Cast<UAnimSequence>(Object);
+    if (Seq && UFootstepSettings::Get()->bAutoMarkOnImport)
+    {
+        MarkIfStale(Seq);
+    }
+}
+
+void FAnimFootstepAutoMarker::OnAssetReimport(UObject* Object)
+{
+    OnAssetPostImport(nullptr, Object);
+}
+
+void FAnimFootstepAutoMarker::OnPreSavePackage(UPackage* Package)
+{
+    // Commandlets (our own batch runs, cooking) mark explicitly or not at all
+    const auto FootstepSetting = UFootstepSettings::Get();
+    if (bIsMarking || IsRunningCommandlet() || !FootstepSetting->bAutoMarkOnSave)
+    {
+        return;
+    }
+    // Autosaves write elsewhere, the real save marks the sequence
+    if (GUnrealEd && GUnrealEd->GetPackageAutoSaver().IsAutoSaving())
+    {
+        return;
+    }
+    // The package is being written, only remember what is stale
+    ForEachObjectWithPackage(Package, [](UObject* Object)
+    {
+        FString AnalysisHash;
+        auto Seq = Cast<UAnimSequence>(Object);
+        if (Seq && IsStale(Seq, AnalysisHash))
+        {
+            PendingSequences.AddUnique(Seq);
+        }
+        return true;
+    }, false);
+    if (PendingSequences.Num() && !DeferredMarkHandle.IsValid())
+    {
+        DeferredMarkHandle = FTicker::GetCoreTicker().AddTicker(
+            FTickerDelegate::CreateStatic(&FAnimFootstepAutoMarker::OnDeferredMark));
+    }
+}
+
+bool FAnimFootstepAutoMarker::OnDeferredMark(float DeltaTime)
+{
+    DeferredMarkHandle.Reset();
+    TArray<UPackage*> Packages;
+    for (auto const& WeakSeq : PendingSequences)
+    {
+        auto Seq = WeakSeq.Get();
+        if (Seq && MarkIfStale(Seq))
+        {
+            Packages.AddUnique(Seq->GetOutermost());
+        }
+    }
+    PendingSequences.Reset();
+
+    // The stamps match now, so this save queues nothing. Every output mode may add curve, notify or marker
+    // names to the skeleton, which is shared and left dirty for the user like any other edit.
+    if (Packages.Num() && !UEditorLoadingAndSavingUtils::SavePackages(Packages, true))
+    {
+        UE_LOG(LogAnimFootstepAutoMarker, Warning, TEXT("Fail to save %d automatically marked packages"),
+               Packages.Num());
+    }
+    return false;
+}
+
+bool FAnimFootstepAutoMarker::MatchesRuleFilters(UAnimSequence* Seq)
+{
+    const auto JsonSetting = UAnimJsonSettings::Get();
+    if (!JsonSetting->bEnableNameConventionFilter)
+    {
+        return true;
+    }
+    const FString Name = Seq->GetName();
+    for (auto const& Filter : JsonSetting->AnimRuleFilters)
+    {
+        if (!Filter.Matches(Name))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+FString FAnimFootstepAutoMarker::ComputeAnalysisHash(UAnimSequence* Seq, TArray<FString> const& KeyBones,
+                                                     EAnimFootstepOutput Output, bool bDebug)
+{
+    FSHA1 Sha;
+    FAnimAnalysisTags::HashRawData(Seq, Sha);
+
+    // Debug mode adds the debug curves, switching it has to re-mark
+    const FString Settings = FString::Join(KeyBones, TEXT(",")) + LexToString(static_cast<int32>(Output)) +
+        LexToString(bDebug);
+    Sha.UpdateWithString(*Settings, Settings.Len());
+    Sha.Final();
+
+    uint8 Digest[FSHA1::DigestSize];
+    Sha.GetHash(Digest);
+    return BytesToHex(Digest, FSHA1::DigestSize);
+}
+
+void FAnimFootstepAutoMarker::Stamp(UAnimSequence* Seq, FString const& AnalysisHash,
+                                    FAnimCurveUtils::FFootstepAnalysis const& Analysis)
+{
+    auto Metadata = FAnimAnalysisTags::FindOrAddMetadata(Seq);
+    Metadata->AnalysisHash = AnalysisHash;
+    Metadata->FootstepCount = Analysis.Markers.Num();
+    Metadata->KeyBone = Analysis.KeyBone;
+    // Markers alternate feet, a cycle is two of them
+    Metadata->CyclePeriod = Analysis.Markers.Num() ? 2.0f * Seq->SequenceLength / Analysis.Markers.Num() : 0.0f;
+    Seq->MarkPackageDirty();
+}
+
+bool FAnimFootstepAutoMarker::IsUpToDate(UAnimSequence* Seq, FString const& AnalysisHash)
+{
+    auto Metadata = FAnimAnalysisTags::FindMetadata(Seq);
+    return Metadata && Metadata->AnalysisHash == AnalysisHash;
+}
+
+bool FAnimFootstepAutoMarker::IsStale(UAnimSequence* Seq, FString& OutAnalysisHash)
+{
+    if (!MatchesRuleFilters(Seq))
+    {
+        return false;
+    }
+    const auto FootstepSetting = UFootstepSettings::Get();
+    OutAnalysisHash = ComputeAnalysisHash(Seq, FootstepSetting->TrackBoneNames, FootstepSetting->FootstepOutput,
+                                          FootstepSetting->IsEnableDebug);
+    return !IsUpToDate(Seq, OutAnalysisHash);
+}
+
+bool FAnimFootstepAutoMarker::MarkIfStale(UAnimSequence* Seq)
+{
+    FString AnalysisHash;
+    if (bIsMarking || !IsStale(Seq, AnalysisHash))
+    {
+        return false;
+    }
+
+    const auto FootstepSetting = UFootstepSettings::Get();
+    TGuardValue<bool> MarkingGuard(bIsMarking, true);
+    FAnimCurveUtils::FFootstepAnalysis Analysis;
+    if (FAnimCurveUtils::AnalyzeFootstepsFor1PAnimation(Seq, FootstepSetting->TrackBoneNames, Analysis,
+                                                        FootstepSetting->IsEnableDebug)
+        || Analysis.DebugCurves.Num())
+    {
+        FAnimCurveUtils::ApplyFootsteps(Seq, Analysis, FootstepSetting->FootstepOutput);
+    }
+    else
+    {
+        UE_LOG(LogAnimFootstepAutoMarker, Log, TEXT("[%s] may not be suitable for footstep recognition."),
+               *Seq->GetName());
+    }
+    // Stamp failures too, so unsuitable sequences are not analysed again on every save
+    Stamp(Seq, AnalysisHash, Analysis);
+    UE_LOG(LogAnimFootstepAutoMarker, Log, TEXT("[%s] marked %d footsteps automatically."), *Seq->GetName(),
+           Analysis.Markers.Num());
+    return true;
+}
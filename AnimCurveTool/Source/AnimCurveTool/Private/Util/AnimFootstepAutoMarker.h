@@ -0,0 +1,54 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimCurveUtils.h"
+
+class UAnimSequence;
+class UFactory;
+class UPackage;
+
+/*
+ * Opt-in footstep marking on import, reimport and save (UFootstepSettings::bAutoMarkOnImport/OnSave).
+ * A sequence is analysed only when it passes the AnimRuleFilters and its analysis hash differs from the
+ * UAnimAnalysisMetadata stamp, so each changed asset pays the cost once. Saving never mutates the package
+ * being written, stale sequences are marked on the next tick and saved again.
+ */
+class FAnimFootstepAutoMarker
+{
+public:
+    static void Register();
+    static void Unregister();
+
+    // Bone tracks plus the analysis settings, stable across curve and notify edits
+    static FString ComputeAnalysisHash(UAnimSequence* Seq, TArray<FString> const& KeyBones,
+                                       EAnimFootstepOutput Output, bool bDebug);
+
+    // Records what was analysed, call after ApplyFootsteps
+    static void Stamp(UAnimSequence* Seq, FString const& AnalysisHash,
+                      FAnimCurveUtils::FFootstepAnalysis const& Analysis);
+
+    static bool IsUpToDate(UAnimSequence* Seq, FString const& AnalysisHash);
+
+    // Analyse and apply when the filters match and the stamp is stale, true if the sequence changed
+    static bool MarkIfStale(UAnimSequence* Seq);
+
+private:
+    static void OnPostEngineInit();
+    static void OnAssetPostImport(UFactory* Factory, UObject* Object);
+    static void OnAssetReimport(UObject* Object);
+    static void OnPreSavePackage(UPackage* Package);
+    static bool OnDeferredMark(float DeltaTime);
+
+    static bool MatchesRuleFilters(UAnimSequence* Seq);
+
+    // Filters match and the stamp differs from the current settings
+    static bool IsStale(UAnimSequence* Seq, FString& OutAnalysisHash);
+
+    static FDelegateHandle PostEngineInitHandle;
+    static FDelegateHandle PostImportHandle;
+    static FDelegateHandle ReimportHandle;
+    static FDelegateHandle PreSaveHandle;
+    static FDelegateHandle DeferredMarkHandle;
+    static TArray<TWeakObjectPtr<UAnimSequence>> PendingSequences;
+    static bool bIsMarking;
+};
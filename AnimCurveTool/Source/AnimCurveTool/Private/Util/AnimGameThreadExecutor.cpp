@@ -0,0 +1,65 @@
+﻿#include "AnimGameThreadExecutor.h"
+
+#include "Containers/Ticker.h"
+
+FAnimGameThreadExecutor::FAnimGameThreadExecutor(float InBudgetMs)
+    : BudgetSeconds(FMath::Max(InBudgetMs, 0.1f) / 1000.0)
+{
+}
+
+FAnimGameThreadExecutor::~FAnimGameThreadExecutor()
+{
+    Shutdown();
+}
+
+void FAnimGameThreadExecutor::Start()
+{
+    check(IsInGameThread());
+    TickerHandle = FTicker::GetCoreTicker().AddTicker(
+        FTickerDelegate::CreateSP(this, &FAnimGameThreadExecutor::Tick));
+}
+
+void FAnimGameThreadExecutor::Shutdown()
+{
+    bShutdown = true;
+    // Inside Tick the ticker is dropped by returning false
+    if (TickerHandle.IsValid() && !bInTick)
+    {
+        FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+        TickerHandle.Reset();
+    }
+    Queue.Empty();
+    NumPending.Reset();
+}
+
+void FAnimGameThreadExecutor::Enqueue(TUniqueFunction<void()> Work)
+{
+    if (bShutdown)
+    {
+        return;
+    }
+    NumPending.Increment();
+    Queue.Enqueue(MoveTemp(Work));
+}
+
+bool FAnimGameThreadExecutor::Tick(float DeltaTime)
+{
+    // Run at least one item per tick so a budget below a single item's cost still makes progress
+    const double Deadline = FPlatformTime::Seconds() + BudgetSeconds;
+    TGuardValue<bool> TickGuard(bInTick, true);
+    TUniqueFunction<void()> Work;
+    while (!bShutdown && Queue.Dequeue(Work))
+    {
+        NumPending.Decrement();
+        Work();
+        if (FPlatformTime::Seconds() >= Deadline)
+        {
+            break;
+        }
+    }
+    if (bShutdown)
+    {
+        TickerHandle.Reset();
+    }
+    return !bShutdown;
+}
@@ -0,0 +1,41 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+
+/*
+ * Queue of work that must run on the game thread (skeleton smart names, Modify/PostEditChange, package
+ * creation and saves), drained for at most BudgetMs per core tick so long commits keep the editor
+ * interactive. Never blocks, producers bound the work they have in flight themselves so that no pool
+ * thread waits on the game thread.
+ */
+class FAnimGameThreadExecutor : public TSharedFromThis<FAnimGameThreadExecutor>
+{
+public:
+    explicit FAnimGameThreadExecutor(float InBudgetMs);
+
+    ~FAnimGameThreadExecutor();
+
+    void Start();
+
+    // Drop queued work, the executor does not run anything afterwards.
+    void Shutdown();
+
+    // Any thread
+    void Enqueue(TUniqueFunction<void()> Work);
+
+    int32 GetNumPending() const { return NumPending.GetValue(); }
+
+private:
+    bool Tick(float DeltaTime);
+
+    double BudgetSeconds;
+
+    TQueue<TUniqueFunction<void()>, EQueueMode::Mpsc> Queue;
+    FThreadSafeCounter NumPending;
+    FThreadSafeBool bShutdown;
+    bool bInTick = false;
+    FDelegateHandle TickerHandle;
+};
@@ -0,0 +1,284 @@
+﻿#include "AnimMemoryAudit.h"
+
+#include "AnimAnalysisTags.h"
+#include "AnimCurveToolStats.h"
+#include "AssetRegistryModule.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/Skeleton.h"
+#include "Dom/JsonObject.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "UI/AnimToolSettings.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimMemoryAudit, Log, All);
+
+namespace
+{
+    // Loaded sequences are collected every so often, a library does not fit in memory at once
+    constexpr int32 LoadsPerGarbageCollection = 256;
+
+    float GetFrameRate(int32 NumFrames, float SequenceLength)
+    {
+        return NumFrames > 1 && SequenceLength > 0.0f ? (NumFrames - 1) / SequenceLength : 0.0f;
+    }
+
+    TSharedRef<FJsonObject> GroupToJson(const FString& Name, FAnimMemoryGroup const& Group)
+    {
+        auto JsonObj = MakeShared<FJsonObject>();
+        JsonObj->SetStringField(TEXT("Name"), Name);
+        JsonObj->SetNumberField(TEXT("Sequences"), Group.NumSequences);
+        JsonObj->SetNumberField(TEXT("CompressedTrackBytes"), Group.CompressedTrackBytes);
+        JsonObj->SetNumberField(TEXT("CurveBytes"), Group.CurveBytes);
+        JsonObj->SetNumberField(TEXT("RawBytes"), Group.RawBytes);
+        JsonObj->SetNumberField(TEXT("Notifies"), Group.NotifyCount);
+        return JsonObj;
+    }
+
+    TArray<TSharedPtr<FJsonValue>> GroupsToJson(TMap<FString, FAnimMemoryGroup>& Groups)
+    {
+        Groups.ValueSort([](FAnimMemoryGroup const& A, FAnimMemoryGroup const& B)
+        {
+            return A.CompressedTrackBytes + A.CurveBytes > B.CompressedTrackBytes + B.CurveBytes;
+        });
+        TArray<TSharedPtr<FJsonValue>> Values;
+        for (auto const& Pair : Groups)
+        {
+            Values.Push(MakeShared<FJsonValueObject>(GroupToJson(Pair.Key, Pair.Value)));
+        }
+        return Values;
+    }
+}
+
+void FAnimMemoryGroup::Add(FAnimMemoryRecord const& Record)
+{
+    ++NumSequences;
+    CompressedTrackBytes += Record.CompressedTrackBytes;
+    CurveBytes += Record.CurveBytes;
+    RawBytes += Record.RawBytes;
+    NotifyCount += Record.NotifyCount;
+}
+
+bool FAnimMemoryAudit::Collect(const FString& SearchPath, TArray<FAnimRuleFilter> const& RuleFilters,
+                               bool bApplyNameFilter, TArray<FAnimMemoryRecord>& OutRecords)
+{
+    FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(
+        "AssetRegistry");
+
+    FString PackagePath = SearchPath;
+    if (!FPackageName::IsValidLongPackageName(PackagePath) &&
+        !FPackageName::TryConvertFilenameToLongPackageName(SearchPath, PackagePath))
+    {
+        UE_LOG(LogAnimMemoryAudit, Error, TEXT("Fail to audit, %s is not a content path"), *SearchPath);
+        return false;
+    }
+
+    FARFilter Filter;
+    Filter.PackagePaths.Add(*PackagePath);
+    Filter.ClassNames.Add(UAnimSequence::StaticClass()->GetFName());
+    Filter.bRecursivePaths = true;
+    TArray<FAssetData> AssetDatas;
+    AssetRegistryModule.Get().GetAssets(Filter, AssetDatas);
+    if (bApplyNameFilter)
+    {
+        AssetDatas.RemoveAll([&](FAssetData const& AssetData)
+        {
+            const FString Name = AssetData.AssetName.ToString();
+            return RuleFilters.ContainsByPredicate([&](FAnimRuleFilter const& RuleFilter)
+            {
+                return !RuleFilter.Matches(Name);
+            });
+        });
+    }
+
+    OutRecords.Reserve(OutRecords.Num() + AssetDatas.Num());
+    for (auto const& AssetData : AssetDatas)
+    {
+        auto& Record = OutRecords.AddDefaulted_GetRef();
+        Record.SequencePath = AssetData.ObjectPath.ToString();
+        Record.Folder = AssetData.PackagePath.ToString();
+        Record.RuleGroup = GetRuleGroup(RuleFilters, AssetData.AssetName.ToString());
+        FillFromRegistry(AssetData, Record);
+    }
+    UE_LOG(LogAnimMemoryAudit, Log, TEXT("Collected %d sequences under %s"), AssetDatas.Num(), *PackagePath);
+    return true;
+}
+
+void FAnimMemoryAudit::Run(const FString& SearchPath, TArray<FAnimRuleFilter> const& RuleFilters,
+                           bool bApplyNameFilter, bool bLoadAssets, TArray<FAnimMemoryRecord>& OutRecords)
+{
+    const int32 FirstRecord = OutRecords.Num();
+    if (!Collect(SearchPath, RuleFilters, bApplyNameFilter, OutRecords))
+    {
+        return;
+    }
+
+    int32 NumLoaded = 0;
+    for (int32 i = FirstRecord; i < OutRecords.Num(); ++i)
+    {
+        auto& Record = OutRecords[i];
+        if (bLoadAssets)
+        {
+            UAnimSequence* Seq = nullptr;
+            {
+                ANIMCURVETOOL_STAGE_SCOPE(Load);
+                Seq = LoadObject<UAnimSequence>(nullptr, *Record.SequencePath);
+            }
+            if (Seq)
+            {
+                FillFromSequence(Seq, Record);
+            }
+            if (++NumLoaded % LoadsPerGarbageCollection == 0)
+            {
+                CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+            }
+        }
+        ANIMCURVETOOL_COUNT(Sequences, 1);
+    }
+    UE_LOG(LogAnimMemoryAudit, Log, TEXT("Audited %d sequences under %s"), OutRecords.Num() - FirstRecord,
+           *SearchPath);
+}
+
+void FAnimMemoryAudit::FillFromRegistry(const FAssetData& AssetData, FAnimMemoryRecord& OutRecord)
+{
+    // Tags written by UAnimSequence::GetAssetRegistryTags
+    FString Value;
+    if (AssetData.GetTagValue(TEXT("Skeleton"), Value))
+    {
+        OutRecord.Skeleton = FPackageName::ExportTextPathToObjectPath(Value);
+    }
+    float CompressedKB = 0.0f;
+    if (AssetData.GetTagValue(TEXT("Compressed Size (KB)"), CompressedKB))
+    {
+        OutRecord.CompressedTrackBytes = static_cast<int64>(CompressedKB * 1024.0f);
+    }
+    float SequenceLength = 0.0f;
+    AssetData.GetTagValue(TEXT("Number of Frames"), OutRecord.NumFrames);
+    AssetData.GetTagValue(TEXT("Sequence Length"), SequenceLength);
+    OutRecord.FrameRate = GetFrameRate(OutRecord.NumFrames, SequenceLength);
+
+    if (AssetData.GetTagValue(USkeleton::AnimNotifyTag, Value))
+    {
+        TArray<FString> NotifyNames;
+        OutRecord.NotifyCount = Value.ParseIntoArray(NotifyNames, *USkeleton::AnimNotifyTagDelimiter);
+    }
+
+    FAnimAnalysisTagValues Analysis;
+    if (FAnimAnalysisTags::Read(AssetData, Analysis) && !Analysis.AnalysisHash.IsEmpty())
+    {
+        OutRecord.FootstepCount = Analysis.FootstepCount;
+        OutRecord.KeyBone = Analysis.KeyBone;
+    }
+}
+
+void FAnimMemoryAudit::FillFromSequence(UAnimSequence* Seq, FAnimMemoryRecord& OutRecord)
+{
+    auto const& CompressedData = Seq->CompressedData;
+    OutRecord.CompressedTrackBytes = CompressedData.CompressedDataStructure.IsValid()
+                                         ? CompressedData.CompressedDataStructure->GetApproxCompressedSize()
+                                         : 0;
+    OutRecord.CurveBytes = CompressedData.CompressedCurveByteStream.Num();
+    OutRecord.RawBytes = Seq->GetApproxRawSize();
+    OutRecord.NotifyCount = Seq->Notifies.Num();
+    OutRecord.NumFrames = Seq->GetRawNumberOfFrames();
+    OutRecord.FrameRate = GetFrameRate(OutRecord.NumFrames, Seq->SequenceLength);
+    if (auto Skeleton = Seq->GetSkeleton())
+    {
+        OutRecord.Skeleton = Skeleton->GetPathName();
+    }
+    OutRecord.bLoaded = true;
+}
+
+FString FAnimMemoryAudit::GetRuleGroup(TArray<FAnimRuleFilter> const& RuleFilters, const FString& SequenceName)
+{
+    TArray<FString> Matched;
+    for (auto const& Filter : RuleFilters)
+    {
+        for (auto const& Keyword : Filter.Keywords)
+        {
+            bool bMatch = false;
+            switch (Filter.FilterType)
+            {
+            case EAnimFilterType::Least_One:
+            case EAnimFilterType::Have_All:
+                bMatch = SequenceName.Contains(Keyword);
+                break;
+            case EAnimFilterType::Start_With:
+                bMatch = SequenceName.StartsWith(Keyword);
+                break;
+            case EAnimFilterType::End_With:
+                bMatch = SequenceName.EndsWith(Keyword);
+                break;
+            default:
+                // Exclusion rules do not name a group
+                break;
+            }
+            if (bMatch)
+            {
+                Matched.Add(Keyword);
+                break;
+            }
+        }
+    }
+    return Matched.Num() ? FString::Join(Matched, TEXT("/")) : TEXT("(none)");
+}
+
+bool FAnimMemoryAudit::WriteReport(const FString& Directory, TArray<FAnimMemoryRecord> const& Records)
+{
+    const auto BasePath = FPaths::ConvertRelativePathToFull(
+        Directory / FString::Printf(TEXT("MemoryAudit_%s"), *FDateTime::Now().ToString()));
+
+    TArray<const FAnimMemoryRecord*> Sorted;
+    TMap<FString, FAnimMemoryGroup> ByFolder, BySkeleton, ByRuleGroup;
+    FAnimMemoryGroup Total;
+    for (auto const& Record : Records)
+    {
+        Sorted.Add(&Record);
+        ByFolder.FindOrAdd(Record.Folder).Add(Record);
+        BySkeleton.FindOrAdd(Record.Skeleton).Add(Record);
+        ByRuleGroup.FindOrAdd(Record.RuleGroup).Add(Record);
+        Total.Add(Record);
+    }
+    Sorted.Sort([](FAnimMemoryRecord const& A, FAnimMemoryRecord const& B)
+    {
+        return A.CompressedBytes() > B.CompressedBytes();
+    });
+
+    FString CsvString = TEXT("Sequence,Folder,Skeleton,RuleGroup,CompressedTrackBytes,CurveBytes,RawBytes,")
+        TEXT("Notifies,Frames,FrameRate,Footsteps,KeyBone,Source") LINE_TERMINATOR;
+    for (auto Record : Sorted)
+    {
+        CsvString += FString::Printf(TEXT("\"%s\",\"%s\",\"%s\",\"%s\",%lld,%lld,%lld,%d,%d,%.2f,%d,%s,%s") LINE_TERMINATOR,
+                                     *Record->SequencePath, *Record->Folder, *Record->Skeleton, *Record->RuleGroup,
+                                     Record->CompressedTrackBytes, Record->CurveBytes, Record->RawBytes,
+                                     Record->NotifyCount, Record->NumFrames, Record->FrameRate,
+                                     Record->FootstepCount, *Record->KeyBone,
+                                     Record->bLoaded ? TEXT("Loaded") : TEXT("Registry"));
+    }
+    if (!FFileHelper::SaveStringToFile(CsvString, *(BasePath + TEXT(".csv"))))
+    {
+        UE_LOG(LogAnimMemoryAudit, Error, TEXT("Fail to write memory audit %s.csv"), *BasePath);
+        return false;
+    }
+    ANIMCURVETOOL_COUNT(BytesWritten, CsvString.Len());
+
+    auto JsonObj = MakeShared<FJsonObject>();
+    JsonObj->SetObjectField(TEXT("Total"), GroupToJson(TEXT("Total"), Total));
+    JsonObj->SetArrayField(TEXT("Folders"), GroupsToJson(ByFolder));
+    JsonObj->SetArrayField(TEXT("Skeletons"), GroupsToJson(BySkeleton));
+    JsonObj->SetArrayField(TEXT("RuleGroups"), GroupsToJson(ByRuleGroup));
+
+    FString JsonString;
+    auto Writer = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&JsonString);
+    if (!FJsonSerializer::Serialize(JsonObj, Writer) ||
+        !FFileHelper::SaveStringToFile(JsonString, *(BasePath + TEXT(".json"))))
+    {
+        UE_LOG(LogAnimMemoryAudit, Error, TEXT("Fail to write memory audit %s.json"), *BasePath);
+        return false;
+    }
+    ANIMCURVETOOL_COUNT(BytesWritten, JsonString.Len());
+
+    UE_LOG(LogAnimMemoryAudit, Display, TEXT("Memory audit of %d sequences, %lld compressed bytes, written to %s.csv"),
+           Records.Num(), Total.CompressedTrackBytes + Total.CurveBytes, *BasePath);
+    return true;
+}
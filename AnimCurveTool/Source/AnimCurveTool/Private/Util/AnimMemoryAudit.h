@@ -0,0 +1,70 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetData.h"
+
+struct FAnimRuleFilter;
+class UAnimSequence;
+
+struct FAnimMemoryRecord
+{
+    FString SequencePath;
+    FString Folder;
+    FString Skeleton;
+    FString RuleGroup;
+
+    // From the registry this is the whole compressed size, curves included, and CurveBytes stays 0
+    int64 CompressedTrackBytes = 0;
+    int64 CurveBytes = 0;
+    int64 RawBytes = 0;
+    int32 NotifyCount = 0;
+    int32 NumFrames = 0;
+    float FrameRate = 0.0f;
+    bool bLoaded = false;
+
+    // From the AnimCurveTool analysis tags, -1 when the sequence was never marked
+    int32 FootstepCount = -1;
+    FString KeyBone;
+
+    int64 CompressedBytes() const { return CompressedTrackBytes + CurveBytes; }
+};
+
+struct FAnimMemoryGroup
+{
+    int32 NumSequences = 0;
+    int64 CompressedTrackBytes = 0;
+    int64 CurveBytes = 0;
+    int64 RawBytes = 0;
+    int32 NotifyCount = 0;
+
+    void Add(FAnimMemoryRecord const& Record);
+};
+
+/*
+ * Memory footprint of every sequence under a content path. Registry tags answer it without loading
+ * anything, which takes seconds for tens of thousands of assets. Loading gives the exact split into
+ * compressed track, compressed curve and raw bytes.
+ */
+class FAnimMemoryAudit
+{
+public:
+    // Registry records of the sequences under SearchPath. With bApplyNameFilter only names matching every
+    // rule filter are kept, the same selection as Generate Json.
+    static bool Collect(const FString& SearchPath, TArray<FAnimRuleFilter> const& RuleFilters,
+                        bool bApplyNameFilter, TArray<FAnimMemoryRecord>& OutRecords);
+
+    // Collect, then with bLoadAssets loads every sequence on the calling thread for the exact sizes
+    static void Run(const FString& SearchPath, TArray<FAnimRuleFilter> const& RuleFilters, bool bApplyNameFilter,
+                    bool bLoadAssets, TArray<FAnimMemoryRecord>& OutRecords);
+
+    static void FillFromRegistry(const FAssetData& AssetData, FAnimMemoryRecord& OutRecord);
+
+    static void FillFromSequence(UAnimSequence* Seq, FAnimMemoryRecord& OutRecord);
+
+    // Keywords of the positive naming rules the name matches, e.g. "_1P_/Walk", or "(none)".
+    static FString GetRuleGroup(TArray<FAnimRuleFilter> const& RuleFilters, const FString& SequenceName);
+
+    // Writes <Dir>/MemoryAudit_<Timestamp>.csv, one row per sequence heaviest first, and a .json with
+    // the totals by folder, skeleton and rule group, each heaviest first.
+    static bool WriteReport(const FString& Directory, TArray<FAnimMemoryRecord> const& Records);
+};
@@ -0,0 +1,144 @@
+﻿#include "AnimPoseStream.h"
+
+#include "AnimationBlueprintLibrary.h"
+#include "AnimCurveToolStats.h"
+#include "AnimCurveUtils.h"
+#include "Animation/AnimSequence.h"
+#include "Async/ParallelFor.h"
+
+FAnimPoseStream::FAnimPoseStream(UAnimSequence* InSeq, int32 InChunkFrames /* = DefaultChunkFrames */)
+    : Seq(InSeq)
+    , ChunkFrames(FMath::Max(InChunkFrames, 1))
+    , NumFrames(InSeq->GetNumberOfFrames())
+{
+}
+
+int32 FAnimPoseStream::AddBone(FName BoneName)
+{
+    const int32 ExistingSlot = SlotBones.IndexOfByKey(BoneName);
+    if (ExistingSlot != INDEX_NONE)
+    {
+        return ExistingSlot;
+    }
+
+    auto Skeleton = Seq->GetSkeleton();
+    if (!Skeleton)
+    {
+        return INDEX_NONE;
+    }
+    auto const& RefSkeleton = Skeleton->GetReferenceSkeleton();
+    int32 BoneIndex = RefSkeleton.FindRawBoneIndex(BoneName);
+    if (BoneIndex == INDEX_NONE)
+    {
+        return INDEX_NONE;
+    }
+
+    TArray<int32> Chain;
+    do
+    {
+        Chain.Add(ChainBones.AddUnique(RefSkeleton.GetBoneName(BoneIndex)));
+        BoneIndex = RefSkeleton.GetRawParentIndex(BoneIndex);
+    }
+    while (BoneIndex > 0);
+    SlotChains.Add(MoveTemp(Chain));
+    return SlotBones.Add(BoneName);
+}
+
+void FAnimPoseStream::AddConsumer(IAnimPoseConsumer& Consumer, bool bInAllFrames /* = true */)
+{
+    Consumers.Add(&Consumer);
+    bAllFrames |= bInAllFrames;
+}
+
+void FAnimPoseStream::Run()
+{
+    FAnimPoseChunk Chunk;
+    if (NumFrames > 0 && SlotBones.Num() > 0)
+    {
+        if (bAllFrames)
+        {
+            // Frame-parallel chunks give every worker a whole range, still bounded by the worker count
+            const int32 StepFrames = FAnimCurveUtils::IsFrameParallel(NumFrames)
+                ? FMath::Max(ChunkFrames, FAnimCurveUtils::FramesPerParallelRange *
+                             FMath::Max(FPlatformMisc::NumberOfWorkerThreadsToSpawn(), 1))
+                : ChunkFrames;
+            for (int32 FirstFrame = 0; FirstFrame < NumFrames; FirstFrame += StepFrames)
+            {
+                Decode(FirstFrame, FMath::Min(StepFrames, NumFrames - FirstFrame), Chunk);
+                Deliver(Chunk);
+            }
+        }
+        else
+        {
+            Decode(0, 1, Chunk);
+            Deliver(Chunk);
+            if (NumFrames > 1)
+            {
+                Decode(NumFrames - 1, 1, Chunk);
+                Deliver(Chunk);
+            }
+        }
+        ANIMCURVETOOL_COUNT(Bones, ChainBones.Num());
+    }
+
+    for (auto Consumer : Consumers)
+    {
+        Consumer->Finish(*this);
+    }
+}
+
+void FAnimPoseStream::Decode(int32 FirstFrame, int32 NumChunkFrames, FAnimPoseChunk& OutChunk) const
+{
+    ANIMCURVETOOL_STAGE_SCOPE(PoseExtraction);
+    OutChunk.FirstFrame = FirstFrame;
+    OutChunk.NumFrames = NumChunkFrames;
+    OutChunk.BonePoses.SetNum(SlotBones.Num());
+    for (auto& Poses : OutChunk.BonePoses)
+    {
+        // Same size every full chunk, the allocation is reused
+        Poses.SetNum(NumChunkFrames, false);
+    }
+
+    // Each range writes its own frames and only reads the raw tracks
+    auto DecodeRange = [&](int32 First, int32 Last)
+    {
+        TArray<FTransform> Poses;
+        for (int32 i = First; i < Last; ++i)
+        {
+            UAnimationBlueprintLibrary::GetBonePosesForFrame(Seq, ChainBones, FirstFrame + i, false, Poses);
+            for (int32 Slot = 0; Slot < SlotChains.Num(); ++Slot)
+            {
+                FTransform ComponentTransform = FTransform::Identity;
+                for (int32 ChainBone : SlotChains[Slot])
+                {
+                    ComponentTransform = ComponentTransform * Poses[ChainBone];
+                }
+                OutChunk.BonePoses[Slot][i] = ComponentTransform;
+            }
+        }
+    };
+
+    if (FAnimCurveUtils::IsFrameParallel(NumFrames) && NumChunkFrames > FAnimCurveUtils::FramesPerParallelRange)
+    {
+        const int32 NumRanges = FMath::DivideAndRoundUp(NumChunkFrames, FAnimCurveUtils::FramesPerParallelRange);
+        ParallelFor(NumRanges, [&](int32 Range)
+        {
+            const int32 First = Range * FAnimCurveUtils::FramesPerParallelRange;
+            DecodeRange(First, FMath::Min(First + FAnimCurveUtils::FramesPerParallelRange, NumChunkFrames));
+        });
+        ANIMCURVETOOL_COUNT(FrameRanges, NumRanges);
+    }
+    else
+    {
+        DecodeRange(0, NumChunkFrames);
+    }
+    ANIMCURVETOOL_COUNT(Frames, NumChunkFrames);
+}
+
+void FAnimPoseStream::Deliver(FAnimPoseChunk const& Chunk) const
+{
+    for (auto Consumer : Consumers)
+    {
+        Consumer->Consume(*this, Chunk);
+    }
+}
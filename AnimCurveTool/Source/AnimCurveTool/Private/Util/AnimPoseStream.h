@@ -0,0 +1,72 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+class UAnimSequence;
+class FAnimPoseStream;
+
+// Component space poses of the stream bones for frames [FirstFrame, FirstFrame + NumFrames)
+struct FAnimPoseChunk
+{
+    int32 FirstFrame = 0;
+    int32 NumFrames = 0;
+    // Per bone slot, NumFrames poses
+    TArray<TArray<FTransform>> BonePoses;
+};
+
+// Receives the chunks of one stream pass in frame order, on the thread running the stream.
+class IAnimPoseConsumer
+{
+public:
+    virtual ~IAnimPoseConsumer() = default;
+
+    virtual void Consume(FAnimPoseStream const& Stream, FAnimPoseChunk const& Chunk) = 0;
+
+    virtual void Finish(FAnimPoseStream const& Stream)
+    {
+    }
+};
+
+/*
+ * Decodes a sequence once for any number of consumers, a fixed number of frames at a time, so memory
+ * stays the same however long the sequence is. Consumers add the bones they read before Run and keep
+ * only what they need from each chunk. Only reads the sequence, safe on worker threads.
+ */
+class FAnimPoseStream
+{
+public:
+    static constexpr int32 DefaultChunkFrames = 256;
+
+    explicit FAnimPoseStream(UAnimSequence* InSeq, int32 InChunkFrames = DefaultChunkFrames);
+
+    // Slot of the bone in every chunk, component space up to but excluding the root like
+    // FAnimCurveUtils::GetBoneKeysByNameHelper. INDEX_NONE when the skeleton has no such bone.
+    int32 AddBone(FName BoneName);
+
+    // Consumers without bAllFrames only look at the first and last frame, when no consumer needs
+    // every frame only those two are decoded.
+    void AddConsumer(IAnimPoseConsumer& Consumer, bool bAllFrames = true);
+
+    void Run();
+
+    UAnimSequence* GetSequence() const { return Seq; }
+
+    int32 GetNumFrames() const { return NumFrames; }
+
+private:
+    void Decode(int32 FirstFrame, int32 NumChunkFrames, FAnimPoseChunk& OutChunk) const;
+
+    void Deliver(FAnimPoseChunk const& Chunk) const;
+
+    UAnimSequence* Seq;
+    int32 ChunkFrames;
+    int32 NumFrames;
+
+    // Union of every chain, one pose request per frame decodes each bone once
+    TArray<FName> ChainBones;
+    TArray<FName> SlotBones;
+    TArray<TArray<int32>> SlotChains;
+
+    TArray<IAnimPoseConsumer*> Consumers;
+    bool bAllFrames = false;
+};
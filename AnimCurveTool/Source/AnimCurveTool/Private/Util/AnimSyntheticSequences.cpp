@@ -0,0 +1,96 @@
+﻿#include "AnimSyntheticSequences.h"
+
+#include "Animation/AnimSequence.h"
+#include "Animation/Skeleton.h"
+#include "Math/RandomStream.h"
+
+FAnimSyntheticSequences::FSequence FAnimSyntheticSequences::Make(FCase const& Case, float Noise,
+                                                                 FRandomStream& Random)
+{
+    const auto Name = FString::Printf(TEXT("Bench_F%d_D%d"), Case.NumFrames, Case.Depth);
+    auto Skeleton = NewObject<USkeleton>(GetTransientPackage(),
+                                         MakeUniqueObjectName(GetTransientPackage(), USkeleton::StaticClass(),
+                                                              *(Name + TEXT("_Skeleton"))), RF_Transient);
+    {
+        FReferenceSkeletonModifier Modifier(Skeleton);
+        Modifier.Add(FMeshBoneInfo(TEXT("Root"), TEXT("Root"), INDEX_NONE), FTransform::Identity);
+        for (int32 i = 0; i < Case.Depth; ++i)
+        {
+            const FName BoneName(*FString::Printf(TEXT("Spine_%d"), i));
+            Modifier.Add(FMeshBoneInfo(BoneName, BoneName.ToString(), i), FTransform(FVector(0, 0, 5)));
+        }
+        Modifier.Add(FMeshBoneInfo(TEXT("LeftHand"), TEXT("LeftHand"), Case.Depth), FTransform::Identity);
+        Modifier.Add(FMeshBoneInfo(TEXT("RightHand"), TEXT("RightHand"), Case.Depth), FTransform::Identity);
+    }
+
+    FSequence Out;
+    Out.Seq = NewObject<UAnimSequence>(GetTransientPackage(),
+                                       MakeUniqueObjectName(GetTransientPackage(), UAnimSequence::StaticClass(),
+                                                            *Name), RF_Transient);
+    auto Seq = Out.Seq;
+    Seq->SetSkeleton(Skeleton);
+    Seq->SetRawNumberOfFrame(Case.NumFrames);
+    Seq->SequenceLength = (Case.NumFrames - 1) / FrameRate;
+
+    auto const& RefSkeleton = Skeleton->GetReferenceSkeleton();
+    for (int32 i = 0; i <= Case.Depth; ++i)
+    {
+        FRawAnimSequenceTrack Track;
+        Track.PosKeys.Add(RefSkeleton.GetRefBonePose()[i].GetLocation());
+        Track.RotKeys.Add(FQuat::Identity);
+        Track.ScaleKeys.Add(FVector::OneVector);
+        Seq->AddNewRawTrack(RefSkeleton.GetBoneName(i), &Track);
+    }
+
+    // The last frame repeats the first, as in authored loops
+    const int32 LoopFrames = FMath::Max(Case.NumFrames - 1, 1);
+    const int32 NumSteps = FMath::Max(FMath::RoundToInt(LoopFrames / FramesPerStep), 1);
+    const float StepPeriod = static_cast<float>(LoopFrames) / NumSteps;
+    for (const TCHAR* HandName : {TEXT("LeftHand"), TEXT("RightHand")})
+    {
+        const float Phase = FCString::Strcmp(HandName, TEXT("LeftHand")) == 0 ? 0.0f : PI;
+        FRawAnimSequenceTrack Track;
+        for (int32 Frame = 0; Frame < Case.NumFrames; ++Frame)
+        {
+            const float Angle = 2.0f * PI * (Frame % LoopFrames) / StepPeriod + Phase;
+            // The detector swaps Y/Z and negates, so its step minima are the maxima of Y
+            Track.PosKeys.Add(FVector(
+                20.0f * FMath::Sin(Angle) + Noise * (Random.FRand() - 0.5f),
+                10.0f * FMath::Cos(Angle) + Noise * (Random.FRand() - 0.5f),
+                0.0f));
+        }
+        Track.RotKeys.Add(FQuat::Identity);
+        Track.ScaleKeys.Add(FVector::OneVector);
+        Seq->AddNewRawTrack(HandName, &Track);
+    }
+    Seq->MarkRawDataAsModified();
+
+    for (int32 Step = 0; Step < NumSteps; ++Step)
+    {
+        Out.StepFrames.Add(FMath::RoundToInt(Step * StepPeriod) % LoopFrames);
+    }
+    return Out;
+}
+
+int32 FAnimSyntheticSequences::CountMatchedSteps(TArray<int32> const& StepFrames,
+                                                 TArray<FAnimCurveUtils::FFootstepMarker> const& Markers,
+                                                 int32 LoopFrames, int32 Tolerance)
+{
+    TArray<bool> Used;
+    Used.Init(false, Markers.Num());
+    int32 Matched = 0;
+    for (auto StepFrame : StepFrames)
+    {
+        for (int32 i = 0; i < Markers.Num(); ++i)
+        {
+            const int32 Distance = FMath::Abs(Markers[i].Frame - StepFrame);
+            if (!Used[i] && FMath::Min(Distance, LoopFrames - Distance) <= Tolerance)
+            {
+                Used[i] = true;
+                ++Matched;
+                break;
+            }
+        }
+    }
+    return Matched;
+}
@@ -0,0 +1,44 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimCurveUtils.h"
+
+class UAnimSequence;
+struct FRandomStream;
+
+/*
+ * Procedural walk-cycle sequences with known footstep frames, shared by the benchmark commandlet and the
+ * automation tests. Nothing is loaded from the project, so both run headless.
+ */
+class FAnimSyntheticSequences
+{
+public:
+    static constexpr float FrameRate = 30.0f;
+    // Roughly one step per second of walk cycle
+    static constexpr float FramesPerStep = 30.0f;
+
+    struct FCase
+    {
+        int32 NumFrames;
+        int32 Depth;
+    };
+
+    struct FSequence
+    {
+        UAnimSequence* Seq = nullptr;
+        // Frames where the LeftHand reaches the bottom of its step, in the detector's coordinates
+        TArray<int32> StepFrames;
+    };
+
+    /*
+     * Root -> Spine_0 .. Spine_{Depth-1} -> LeftHand/RightHand. The hands swing a cosine in the vertical
+     * axis the detector looks at, half a cycle apart, plus uniform noise. Every bone gets a raw track so
+     * pose extraction walks the full chain. Skeleton and sequence are transient.
+     */
+    static FSequence Make(FCase const& Case, float Noise, FRandomStream& Random);
+
+    // Greedy match within Tolerance frames on the looped timeline
+    static int32 CountMatchedSteps(TArray<int32> const& StepFrames,
+                                   TArray<FAnimCurveUtils::FFootstepMarker> const& Markers, int32 LoopFrames,
+                                   int32 Tolerance);
+};
@@ -0,0 +1,193 @@
+﻿#include "AnimValidation.h"
+
+#include "Animation/AnimSequence.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimValidation, Log, All);
+
+const FName FAnimValidationEngine::CameraRootAtOriginRule(TEXT("CameraRootAtOrigin"));
+const FName FAnimValidationEngine::SingleFrameRule(TEXT("SingleFrame"));
+
+namespace
+{
+    const FName CameraRootBone(TEXT("Camera_Root"));
+
+    // Camera_Root has to start and end at the origin, sequences without it pass
+    class FCameraRootAtOriginRule : public IAnimValidationRule
+    {
+    public:
+        virtual FName GetName() const override { return FAnimValidationEngine::CameraRootAtOriginRule; }
+
+        virtual void GetNeeds(FAnimValidationNeeds& OutNeeds) const override
+        {
+            OutNeeds.bEndpoints = true;
+            OutNeeds.Bones.AddUnique(CameraRootBone);
+        }
+
+        virtual bool Validate(FAnimValidationContext const& Context, FString& OutReason) const override
+        {
+            auto Poses = Context.FindBonePoses(CameraRootBone);
+            if (!Poses || Poses->Num() == 0)
+            {
+                return true;
+            }
+
+            constexpr float Eps = 1e-10;
+            auto IsAtOrigin = [=](FVector const& Location)
+            {
+                return FMath::Abs(Location.X) <= Eps && FMath::Abs(Location.Y) <= Eps && FMath::Abs(Location.Z) <= Eps;
+            };
+            if (!IsAtOrigin((*Poses)[0].GetLocation()))
+            {
+                OutReason = TEXT("Camera_Root not start at Origin(0, 0, 0)!");
+                return false;
+            }
+            if (!IsAtOrigin(Poses->Last().GetLocation()))
+            {
+                OutReason = TEXT("Camera_Root not end at Origin(0, 0, 0)!");
+                return false;
+            }
+            return true;
+        }
+    };
+
+    class FSingleFrameRule : public IAnimValidationRule
+    {
+    public:
+        virtual FName GetName() const override { return FAnimValidationEngine::SingleFrameRule; }
+
+        virtual void GetNeeds(FAnimValidationNeeds& OutNeeds) const override
+        {
+        }
+
+        virtual bool Validate(FAnimValidationContext const& Context, FString& OutReason) const override
+        {
+            if (Context.NumFrames == 1)
+            {
+                OutReason = TEXT("only contains one frame!");
+                return false;
+            }
+            return true;
+        }
+    };
+}
+
+void FAnimValidationNeeds::Append(FAnimValidationNeeds const& Other)
+{
+    bAllFrames |= Other.bAllFrames;
+    bEndpoints |= Other.bEndpoints;
+    for (auto const& Bone : Other.Bones)
+    {
+        Bones.AddUnique(Bone);
+    }
+}
+
+bool FAnimValidationResult::HasPassed(FName Rule) const
+{
+    auto RuleResult = RuleResults.FindByPredicate([Rule](FAnimValidationRuleResult const& Result)
+    {
+        return Result.Rule == Rule;
+    });
+    return !RuleResult || RuleResult->bPassed;
+}
+
+void FAnimValidationEngine::AddRule(TSharedRef<IAnimValidationRule> const& Rule)
+{
+    FAnimValidationNeeds RuleNeeds;
+    Rule->GetNeeds(RuleNeeds);
+    Needs.Append(RuleNeeds);
+    Rules.Add(Rule);
+}
+
+FAnimValidationEngine const& FAnimValidationEngine::GetDefault()
+{
+    static const FAnimValidationEngine DefaultEngine = []()
+    {
+        FAnimValidationEngine Engine;
+        Engine.AddRule(MakeShared<FCameraRootAtOriginRule>());
+        Engine.AddRule(MakeShared<FSingleFrameRule>());
+        return Engine;
+    }();
+    return DefaultEngine;
+}
+
+void FAnimValidationEngine::Validate(UAnimSequence* Seq, FAnimValidationResult& OutResult) const
+{
+    FAnimPoseStream Stream(Seq);
+    FAnimValidationConsumer Consumer(*this, Stream, OutResult);
+    Stream.Run();
+}
+
+void FAnimValidationEngine::RunRules(FAnimValidationContext const& Context, FAnimValidationResult& OutResult) const
+{
+    auto Seq = Context.Seq;
+    OutResult.RuleResults.Reset(Rules.Num());
+    for (auto const& Rule : Rules)
+    {
+        auto& RuleResult = OutResult.RuleResults.AddDefaulted_GetRef();
+        RuleResult.Rule = Rule->GetName();
+        RuleResult.bPassed = Rule->Validate(Context, RuleResult.Reason);
+        if (!RuleResult.bPassed)
+        {
+            UE_LOG(LogAnimValidation, Warning, TEXT("[%s] %s: %s"), *Seq->GetName(), *RuleResult.Rule.ToString(),
+                   *RuleResult.Reason);
+        }
+    }
+}
+
+FAnimValidationConsumer::FAnimValidationConsumer(FAnimValidationEngine const& InEngine, FAnimPoseStream& Stream,
+                                                 FAnimValidationResult& InResult)
+    : Engine(InEngine)
+    , Result(InResult)
+{
+    Context.Seq = Stream.GetSequence();
+    Context.NumFrames = Stream.GetNumFrames();
+    for (auto const& BoneName : Engine.Needs.Bones)
+    {
+        const int32 Slot = Stream.AddBone(BoneName);
+        if (Slot != INDEX_NONE)
+        {
+            BoneSlots.Emplace(BoneName, Slot);
+            Context.BonePoses.Add(BoneName);
+        }
+    }
+    Stream.AddConsumer(*this, Engine.Needs.bAllFrames);
+}
+
+bool FAnimValidationConsumer::IsNeeded(int32 Frame) const
+{
+    return Engine.Needs.bAllFrames
+        || (Engine.Needs.bEndpoints && (Frame == 0 || Frame == Context.NumFrames - 1));
+}
+
+void FAnimValidationConsumer::Consume(FAnimPoseStream const& Stream, FAnimPoseChunk const& Chunk)
+{
+    for (int32 i = 0; i < Chunk.NumFrames; ++i)
+    {
+        const int32 Frame = Chunk.FirstFrame + i;
+        if (!IsNeeded(Frame))
+        {
+            continue;
+        }
+        Context.Frames.Add(Frame);
+        for (auto const& BoneSlot : BoneSlots)
+        {
+            Context.BonePoses[BoneSlot.Key].Add(Chunk.BonePoses[BoneSlot.Value][i]);
+        }
+    }
+}
+
+void FAnimValidationConsumer::Finish(FAnimPoseStream const& Stream)
+{
+    // A stream without any bone to decode delivers no chunk, the frames are still listed for the rules
+    if (Context.Frames.Num() == 0)
+    {
+        for (int32 Frame = 0; Frame < Context.NumFrames; ++Frame)
+        {
+            if (IsNeeded(Frame))
+            {
+                Context.Frames.Add(Frame);
+            }
+        }
+    }
+    Engine.RunRules(Context, Result);
+}
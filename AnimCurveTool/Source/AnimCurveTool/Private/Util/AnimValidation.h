@@ -0,0 +1,107 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimPoseStream.h"
+
+class UAnimSequence;
+
+// What a rule reads from a sequence, the engine fetches the union of all rules once
+struct FAnimValidationNeeds
+{
+    bool bAllFrames = false;
+    bool bEndpoints = false;
+    // Component space, up to but excluding the root, like FAnimPoseStream
+    TArray<FName> Bones;
+
+    void Append(FAnimValidationNeeds const& Other);
+};
+
+struct FAnimValidationContext
+{
+    UAnimSequence* Seq = nullptr;
+    int32 NumFrames = 0;
+    // Fetched frame indices, ascending, and per bone one pose for each of them
+    TArray<int32> Frames;
+    TMap<FName, TArray<FTransform>> BonePoses;
+
+    // Null when the bone is not in the skeleton
+    TArray<FTransform> const* FindBonePoses(FName BoneName) const { return BonePoses.Find(BoneName); }
+};
+
+class IAnimValidationRule
+{
+public:
+    virtual ~IAnimValidationRule() = default;
+
+    virtual FName GetName() const = 0;
+
+    virtual void GetNeeds(FAnimValidationNeeds& OutNeeds) const = 0;
+
+    // Runs on worker threads, returns false with a reason when the sequence fails
+    virtual bool Validate(FAnimValidationContext const& Context, FString& OutReason) const = 0;
+};
+
+struct FAnimValidationRuleResult
+{
+    FName Rule;
+    bool bPassed = true;
+    FString Reason;
+};
+
+struct FAnimValidationResult
+{
+    TArray<FAnimValidationRuleResult> RuleResults;
+
+    // True when the rule ran and passed, rules that did not run pass
+    bool HasPassed(FName Rule) const;
+};
+
+/*
+ * Runs every registered rule over a sequence in one pass. The poses the rules declare are decoded once,
+ * and only at the first and last frame unless a rule needs them all, so an extra rule costs its own
+ * logic and nothing more. Through FAnimValidationConsumer the rules can also share another pass.
+ */
+class FAnimValidationEngine
+{
+public:
+    static const FName CameraRootAtOriginRule;
+    static const FName SingleFrameRule;
+
+    void AddRule(TSharedRef<IAnimValidationRule> const& Rule);
+
+    // All built-in rules
+    static FAnimValidationEngine const& GetDefault();
+
+    // Thread safe, only reads the sequence
+    void Validate(UAnimSequence* Seq, FAnimValidationResult& OutResult) const;
+
+private:
+    friend class FAnimValidationConsumer;
+
+    void RunRules(FAnimValidationContext const& Context, FAnimValidationResult& OutResult) const;
+
+    TArray<TSharedRef<IAnimValidationRule>> Rules;
+    FAnimValidationNeeds Needs;
+};
+
+// Gathers what the engine's rules need from a pose stream and runs them when the stream finishes.
+// Rules that need every frame still get them all in their context.
+class FAnimValidationConsumer : public IAnimPoseConsumer
+{
+public:
+    FAnimValidationConsumer(FAnimValidationEngine const& InEngine, FAnimPoseStream& Stream,
+                            FAnimValidationResult& InResult);
+
+    virtual void Consume(FAnimPoseStream const& Stream, FAnimPoseChunk const& Chunk) override;
+
+    virtual void Finish(FAnimPoseStream const& Stream) override;
+
+private:
+    bool IsNeeded(int32 Frame) const;
+
+    FAnimValidationEngine const& Engine;
+    FAnimValidationResult& Result;
+    FAnimValidationContext Context;
+    // Stream slot of each found bone
+    TArray<TPair<FName, int32>> BoneSlots;
+};
@@ -0,0 +1,137 @@
+﻿#include "AnimFootstepComponent.h"
+
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimMontage.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/AnimSingleNodeInstance.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/Actor.h"
+
+
+UAnimFootstepComponent::UAnimFootstepComponent()
+{
+    PrimaryComponentTick.bCanEverTick = true;
+    PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+}
+
+void UAnimFootstepComponent::BeginPlay()
+{
+    Super::BeginPlay();
+    if (auto Owner = GetOwner())
+    {
+        MeshComponent = Owner->FindComponentByClass<USkeletalMeshComponent>();
+        if (MeshComponent)
+        {
+            // Read poses after the mesh advanced this frame
+            AddTickPrerequisiteComponent(MeshComponent);
+        }
+    }
+}
+
+void UAnimFootstepComponent::TickComponent(float DeltaTime, ELevelTick TickType,
+                                           FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    UAnimSequence* NewSequence = nullptr;
+    float NewTime = 0.0f;
+    bool bLoopingForward = false;
+    if (bExplicitPlayback)
+    {
+        NewSequence = ExplicitSequence;
+        NewTime = ExplicitTime;
+        bLoopingForward = bExplicitLooping;
+    }
+    else
+    {
+        ReadPlayback(NewSequence, NewTime, bLoopingForward);
+    }
+    Advance(NewSequence, NewTime, bLoopingForward);
+}
+
+void UAnimFootstepComponent::SetPlayback(UAnimSequence* InSequence, float Time, bool bLooping)
+{
+    ExplicitSequence = InSequence;
+    ExplicitTime = Time;
+    bExplicitLooping = bLooping;
+    bExplicitPlayback = true;
+}
+
+void UAnimFootstepComponent::ClearPlayback()
+{
+    ExplicitSequence = nullptr;
+    bExplicitPlayback = false;
+}
+
+bool UAnimFootstepComponent::ReadPlayback(UAnimSequence*& OutSequence, float& OutTime,
+                                          bool& bOutLoopingForward) const
+{
+    if (!MeshComponent)
+    {
+        return false;
+    }
+
+    if (auto SingleNode = MeshComponent->GetSingleNodeInstance())
+    {
+        OutSequence = Cast<UAnimSequence>(SingleNode->GetAnimationAsset());
+        OutTime = SingleNode->GetCurrentTime();
+        bOutLoopingForward = SingleNode->IsLooping() && SingleNode->GetPlayRate() >= 0.0f;
+        return OutSequence != nullptr;
+    }
+
+    auto AnimInstance = MeshComponent->GetAnimInstance();
+    auto MontageInstance = AnimInstance ? AnimInstance->GetActiveMontageInstance() : nullptr;
+    if (!MontageInstance || !MontageInstance->Montage || MontageInstance->Montage->SlotAnimTracks.Num() == 0)
+    {
+        return false;
+    }
+
+    const float Position = MontageInstance->GetPosition();
+    auto const& Track = MontageInstance->Montage->SlotAnimTracks[0].AnimTrack;
+    auto Segment = Track.GetSegmentAtTime(Position);
+    if (!Segment)
+    {
+        return false;
+    }
+    OutSequence = Cast<UAnimSequence>(Segment->AnimReference);
+    OutTime = Segment->ConvertTrackPosToAnimPos(Position);
+    // A looping segment wraps inside the sequence, reverse playback never crosses a step forward
+    bOutLoopingForward = Segment->LoopingCount > 1 && MontageInstance->GetPlayRate() * Segment->AnimPlayRate >= 0.0f;
+    return OutSequence != nullptr;
+}
+
+void UAnimFootstepComponent::Advance(UAnimSequence* NewSequence, float NewTime, bool bLoopingForward)
+{
+    NumStepsSinceLastTick = 0;
+    if (NewSequence != Sequence)
+    {
+        // Lookup by class only when the sequence changes, ticks on the same sequence touch the cached table
+        Sequence = NewSequence;
+        Table = Sequence ? Cast<UAnimFootstepTable>(Sequence->GetAssetUserDataOfClass(UAnimFootstepTable::StaticClass()))
+                         : nullptr;
+        CurrentTime = NewTime;
+        CurrentFoot = Table ? Table->GetFootAt(NewTime) : EAnimFoot::None;
+        return;
+    }
+    if (!Table)
+    {
+        return;
+    }
+
+    int32 FirstStep = INDEX_NONE;
+    NumStepsSinceLastTick = Table->CountStepsBetween(CurrentTime, NewTime, bLoopingForward, FirstStep);
+    CurrentTime = NewTime;
+    if (NumStepsSinceLastTick == 0)
+    {
+        return;
+    }
+
+    CurrentFoot = Table->GetFootAt(NewTime);
+    if (OnFootstep.IsBound())
+    {
+        for (int32 i = 0; i < NumStepsSinceLastTick; ++i)
+        {
+            OnFootstep.Broadcast(Table->GetStepFoot((FirstStep + i) % Table->GetNumSteps()));
+        }
+    }
+}
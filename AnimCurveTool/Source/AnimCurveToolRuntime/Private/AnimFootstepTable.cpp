@@ -0,0 +1,83 @@
+﻿#include "AnimFootstepTable.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimFootstepTable, Log, All);
+
+void UAnimFootstepTable::Bake(float InSequenceLength, TArray<float> const& InStepTimes,
+                              TArray<EAnimFoot> const& InFeet)
+{
+    check(InStepTimes.Num() == InFeet.Num());
+    SequenceLength = InSequenceLength;
+
+    TArray<int32> Order;
+    for (int32 i = 0; i < InStepTimes.Num(); ++i)
+    {
+        Order.Add(i);
+    }
+    Order.Sort([&InStepTimes](int32 A, int32 B) { return InStepTimes[A] < InStepTimes[B]; });
+
+    const int32 NumSteps = FMath::Min(Order.Num(), MaxSteps);
+    if (NumSteps < Order.Num())
+    {
+        UE_LOG(LogAnimFootstepTable, Warning, TEXT("[%s] has %d footsteps, only the first %d are baked"),
+               *GetOuter()->GetName(), Order.Num(), MaxSteps);
+    }
+    StepTimes.Reset(NumSteps);
+    Feet.Reset(NumSteps);
+    for (int32 i = 0; i < NumSteps; ++i)
+    {
+        StepTimes.Add(InStepTimes[Order[i]]);
+        Feet.Add(InFeet[Order[i]]);
+    }
+
+    InvBucketLength = SequenceLength > 0.0f ? NumPhaseBuckets / SequenceLength : 0.0f;
+    PhaseBuckets.SetNumUninitialized(NumPhaseBuckets);
+    int32 StepIndex = 0;
+    for (int32 Bucket = 0; Bucket < NumPhaseBuckets; ++Bucket)
+    {
+        const float BucketStart = SequenceLength * Bucket / NumPhaseBuckets;
+        while (StepIndex < StepTimes.Num() && StepTimes[StepIndex] < BucketStart)
+        {
+            ++StepIndex;
+        }
+        PhaseBuckets[Bucket] = static_cast<uint8>(StepIndex);
+    }
+}
+
+int32 UAnimFootstepTable::CountStepsBetween(float PrevTime, float Time, bool bLoopingForward,
+                                            int32& OutFirstStep) const
+{
+    OutFirstStep = INDEX_NONE;
+    if (StepTimes.Num() == 0 || PrevTime == Time || (Time < PrevTime && !bLoopingForward))
+    {
+        return 0;
+    }
+
+    // Number of steps at or before a time
+    auto NumStepsUpTo = [this](float T)
+    {
+        const int32 Next = FindNextStep(T);
+        return Next + (Next < StepTimes.Num() && StepTimes[Next] <= T ? 1 : 0);
+    };
+
+    const int32 Before = NumStepsUpTo(PrevTime);
+    // Going backwards while looping forward means the loop wrapped, count to its end and then from its start
+    const int32 NumSteps = Time > PrevTime ? NumStepsUpTo(Time) - Before
+                                           : StepTimes.Num() - Before + NumStepsUpTo(Time);
+    if (NumSteps > 0)
+    {
+        OutFirstStep = Before % StepTimes.Num();
+    }
+    return NumSteps;
+}
+
+float UAnimFootstepTable::GetTimeToNextStep(float Time) const
+{
+    if (StepTimes.Num() == 0)
+    {
+        return 0.0f;
+    }
+    const int32 NextStep = FindNextStep(Time);
+    return NextStep < StepTimes.Num()
+               ? StepTimes[NextStep] - Time
+               : SequenceLength - Time + StepTimes[0];
+}
@@ -0,0 +1,49 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetUserData.h"
+
+#include "AnimAnalysisMetadata.generated.h"
+
+/*
+ * Editor-only stamp AnimCurveTool leaves on an analysed sequence, so that import and save hooks can
+ * skip sequences whose source data did not change since the last analysis. The editor module publishes
+ * it as asset registry tags, queries read those instead of loading the sequence. Stripped on cook.
+ */
+UCLASS()
+class ANIMCURVETOOLRUNTIME_API UAnimAnalysisMetadata : public UAssetUserData
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool IsEditorOnly() const override { return true; }
+
+#if WITH_EDITORONLY_DATA
+    // Hash of the bone tracks and analysis settings the results below were computed from
+    UPROPERTY(VisibleAnywhere, Category = "Analysis")
+    FString AnalysisHash;
+
+    UPROPERTY(VisibleAnywhere, Category = "Analysis")
+    int32 FootstepCount = 0;
+
+    UPROPERTY(VisibleAnywhere, Category = "Analysis")
+    FString KeyBone;
+
+    // Seconds of one left-right cycle, 0 without footsteps
+    UPROPERTY(VisibleAnywhere, Category = "Analysis")
+    float CyclePeriod = 0.0f;
+
+    // Check Animation results, valid once bChecked and while the raw data still hashes to CheckHash
+    UPROPERTY(VisibleAnywhere, Category = "Analysis")
+    bool bChecked = false;
+
+    UPROPERTY(VisibleAnywhere, Category = "Analysis")
+    FString CheckHash;
+
+    UPROPERTY(VisibleAnywhere, Category = "Analysis")
+    bool bSingleFrame = false;
+
+    UPROPERTY(VisibleAnywhere, Category = "Analysis")
+    bool bCameraRootAtOrigin = true;
+#endif
+};
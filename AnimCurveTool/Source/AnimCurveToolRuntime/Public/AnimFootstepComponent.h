@@ -0,0 +1,80 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "AnimFootstepTable.h"
+
+#include "AnimFootstepComponent.generated.h"
+
+class UAnimSequence;
+class USkeletalMeshComponent;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FAnimFootstepSignature, EAnimFoot, Foot);
+
+/*
+ * Answers footstep queries from the UAnimFootstepTable baked onto the playing sequence, replacing per-tick
+ * evaluation of Footsteps_Curve by name. Playback is read from the active montage or the single node
+ * instance of the owner's skeletal mesh, graphs driven by other nodes feed it through SetPlayback.
+ */
+UCLASS(ClassGroup = Animation, meta = (BlueprintSpawnableComponent))
+class ANIMCURVETOOLRUNTIME_API UAnimFootstepComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UAnimFootstepComponent();
+
+    virtual void BeginPlay() override;
+
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType,
+                               FActorComponentTickFunction* ThisTickFunction) override;
+
+    // Overrides the automatic playback source until ClearPlayback. bLooping is for forward playback, a time
+    // before the last one then counts the steps through the end of the loop.
+    UFUNCTION(BlueprintCallable, Category = "Footsteps")
+    void SetPlayback(UAnimSequence* Sequence, float Time, bool bLooping = true);
+
+    UFUNCTION(BlueprintCallable, Category = "Footsteps")
+    void ClearPlayback();
+
+    UFUNCTION(BlueprintPure, Category = "Footsteps")
+    EAnimFoot GetCurrentFoot() const { return CurrentFoot; }
+
+    UFUNCTION(BlueprintPure, Category = "Footsteps")
+    float GetTimeToNextStep() const { return Table ? Table->GetTimeToNextStep(CurrentTime) : 0.0f; }
+
+    UFUNCTION(BlueprintPure, Category = "Footsteps")
+    int32 GetNumStepsSinceLastTick() const { return NumStepsSinceLastTick; }
+
+    UFUNCTION(BlueprintPure, Category = "Footsteps")
+    bool HasFootstepTable() const { return Table != nullptr; }
+
+    // Broadcast once per step crossed since the last tick
+    UPROPERTY(BlueprintAssignable, Category = "Footsteps")
+    FAnimFootstepSignature OnFootstep;
+
+private:
+    bool ReadPlayback(UAnimSequence*& OutSequence, float& OutTime, bool& bOutLoopingForward) const;
+
+    void Advance(UAnimSequence* Sequence, float Time, bool bLoopingForward);
+
+    UPROPERTY(Transient)
+    USkeletalMeshComponent* MeshComponent = nullptr;
+
+    UPROPERTY(Transient)
+    UAnimSequence* Sequence = nullptr;
+
+    UPROPERTY(Transient)
+    UAnimFootstepTable* Table = nullptr;
+
+    UPROPERTY(Transient)
+    UAnimSequence* ExplicitSequence = nullptr;
+
+    float ExplicitTime = 0.0f;
+    bool bExplicitLooping = true;
+    bool bExplicitPlayback = false;
+
+    float CurrentTime = 0.0f;
+    EAnimFoot CurrentFoot = EAnimFoot::None;
+    int32 NumStepsSinceLastTick = 0;
+};
@@ -0,0 +1,95 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetUserData.h"
+
+#include "AnimFootstepTable.generated.h"
+
+UENUM(BlueprintType)
+enum class EAnimFoot : uint8
+{
+    None,
+    Left,
+    Right,
+};
+
+/*
+ * Footsteps of one sequence, baked by AnimCurveTool next to Footsteps_Curve. Step times are sorted, and a
+ * fixed-resolution phase table points every bucket of the sequence at its first step, so finding the
+ * next step is a bucket index plus at most a few compares, without curve evaluation or name lookups.
+ */
+UCLASS()
+class ANIMCURVETOOLRUNTIME_API UAnimFootstepTable : public UAssetUserData
+{
+    GENERATED_BODY()
+
+public:
+    static constexpr int32 NumPhaseBuckets = 64;
+
+    // Bucket entries are bytes, steps past this many are dropped with a warning
+    static constexpr int32 MaxSteps = 255;
+
+    // Editor side, StepTimes in seconds and Feet in the same order
+    void Bake(float InSequenceLength, TArray<float> const& InStepTimes, TArray<EAnimFoot> const& InFeet);
+
+    int32 GetNumSteps() const { return StepTimes.Num(); }
+
+    float GetSequenceLength() const { return SequenceLength; }
+
+    float GetStepTime(int32 StepIndex) const { return StepTimes[StepIndex]; }
+
+    EAnimFoot GetStepFoot(int32 StepIndex) const { return Feet[StepIndex]; }
+
+    // Index of the first step at or after Time, GetNumSteps() when there is none before the end.
+    int32 FindNextStep(float Time) const
+    {
+        const int32 Bucket = FMath::Clamp(static_cast<int32>(Time * InvBucketLength), 0, NumPhaseBuckets - 1);
+        int32 StepIndex = PhaseBuckets.Num() ? PhaseBuckets[Bucket] : 0;
+        // Rounding can land Time just below its bucket start
+        while (StepIndex > 0 && StepTimes[StepIndex - 1] >= Time)
+        {
+            --StepIndex;
+        }
+        while (StepIndex < StepTimes.Num() && StepTimes[StepIndex] < Time)
+        {
+            ++StepIndex;
+        }
+        return StepIndex;
+    }
+
+    // Foot of the last step at or before Time, wrapping to the last step of the loop.
+    EAnimFoot GetFootAt(float Time) const
+    {
+        if (StepTimes.Num() == 0)
+        {
+            return EAnimFoot::None;
+        }
+        const int32 NextStep = FindNextStep(Time);
+        const bool bOnStep = NextStep < StepTimes.Num() && StepTimes[NextStep] <= Time;
+        return Feet[bOnStep ? NextStep : (NextStep + StepTimes.Num() - 1) % StepTimes.Num()];
+    }
+
+    // Steps in (PrevTime, Time]. With bLoopingForward a Time before PrevTime is a wrap and counts through the
+    // end of the loop, otherwise it is a jump or reverse playback and crosses no steps.
+    int32 CountStepsBetween(float PrevTime, float Time, bool bLoopingForward, int32& OutFirstStep) const;
+
+    // Seconds from Time to the next step of the loop, 0 without steps.
+    float GetTimeToNextStep(float Time) const;
+
+private:
+    UPROPERTY()
+    float SequenceLength = 0.0f;
+
+    UPROPERTY()
+    TArray<float> StepTimes;
+
+    UPROPERTY()
+    TArray<EAnimFoot> Feet;
+
+    // First step index at or after the start of each bucket
+    UPROPERTY()
+    TArray<uint8> PhaseBuckets;
+
+    UPROPERTY()
+    float InvBucketLength = 0.0f;
+};